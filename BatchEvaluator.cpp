@@ -0,0 +1,336 @@
+#include "BatchEvaluator.h"
+#include "BoundedQueue.h"
+#include "Evaluation.h"
+#include "MemoryAccounting.h"
+#include "PackedMove.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * @file BatchEvaluator.cpp
+ * @brief Implementation of the pipelined batch evaluation of position files.
+ */
+
+namespace {
+    const char InputMagic[4] = { 'C', 'K', 'P', 'I' };
+    const char OutputMagic[4] = { 'C', 'K', 'P', 'O' };
+    const long long ReportedErrors = 10;    // Invalid binary records named in the report
+
+    int16_t clampShort(int value) {
+        return static_cast<int16_t>(std::max(-32767, std::min(32767, value)));
+    }
+
+    uint16_t packBest(const BatchEvaluator::Entry& entry) {
+        if (!entry.hasMove) {
+            return BatchEvaluator::NoMove;
+        }
+        MoveList list;
+        entry.position.generateMoves(list);
+        for (int i = 0; i < list.count; i++) {
+            if (list[i].from == entry.best.from && list[i].to == entry.best.to && list[i].captured == entry.best.captured) {
+                return PackedMove::pack(list, i).bits;
+            }
+        }
+        return BatchEvaluator::NoMove;
+    }
+
+    /**
+     * @brief Fill a chunk from the input.
+     *
+     * @return False at the end of the input.
+     */
+    bool readChunk(std::istream& input, bool binary, BatchEvaluator::Chunk& chunk) {
+        MemoryScope scope(MemoryTag::Io);
+        chunk.entries.clear();
+        while (chunk.entries.size() < BatchEvaluator::ChunkPositions) {
+            BatchEvaluator::Entry entry;
+            entry.valid = true;
+            if (binary) {
+                BatchEvaluator::PositionRecord record;
+                if (!input.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+                    if (input.gcount() != 0) {
+                        throw std::runtime_error("The position file ends inside a record.");
+                    }
+                    break;
+                }
+                entry.position.white = record.white;
+                entry.position.black = record.black;
+                entry.position.kings = record.kings;
+                entry.position.whiteToMove = record.whiteToMove != 0;
+                if ((record.white & record.black) != 0 || (record.kings & ~(record.white | record.black)) != 0) {
+                    entry.valid = false;
+                    entry.error = "overlapping pieces";
+                }
+                else if (record.whiteToMove > 1) {
+                    entry.valid = false;
+                    entry.error = "invalid side to move";
+                }
+            }
+            else {
+                if (!std::getline(input, entry.text)) {
+                    break;
+                }
+                if (!entry.text.empty() && entry.text.back() == '\r') {
+                    entry.text.pop_back();
+                }
+                if (entry.text.empty() || entry.text[0] == '#') {
+                    continue;
+                }
+                try {
+                    entry.position = entry.text == "startpos" ? Position::initial() : Position::fromString(entry.text);
+                }
+                catch (const std::runtime_error& e) {
+                    entry.valid = false;
+                    entry.error = e.what();
+                }
+            }
+            chunk.entries.push_back(std::move(entry));
+        }
+        return !chunk.entries.empty();
+    }
+
+    void writeChunk(std::ostream& output, bool binary, const BatchEvaluator::Chunk& chunk) {
+        MemoryScope scope(MemoryTag::Io);
+        if (binary) {
+            std::vector<BatchEvaluator::ResultRecord> records;
+            records.reserve(chunk.entries.size());
+            for (const BatchEvaluator::Entry& entry : chunk.entries) {
+                BatchEvaluator::ResultRecord record = {};
+                record.best = BatchEvaluator::NoMove;
+                if (entry.valid) {
+                    record.evaluation = clampShort(entry.evaluation);
+                    record.score = clampShort(entry.score);
+                    record.best = packBest(entry);
+                    record.depth = static_cast<uint8_t>(entry.depth);
+                    record.valid = 1;
+                }
+                records.push_back(record);
+            }
+            output.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(BatchEvaluator::ResultRecord));
+            return;
+        }
+
+        std::ostringstream text;
+        for (const BatchEvaluator::Entry& entry : chunk.entries) {
+            text << entry.text;
+            if (!entry.valid) {
+                text << " error " << entry.error << "\n";
+                continue;
+            }
+            text << " eval " << entry.evaluation << " score " << entry.score << " depth " << entry.depth << " best "
+                << (entry.hasMove ? Position::moveToString(entry.best) : "none") << "\n";
+        }
+        output << text.str();
+    }
+}
+
+static_assert(sizeof(BatchEvaluator::PositionRecord) == 16, "binary input has 16-byte records");
+static_assert(sizeof(BatchEvaluator::ResultRecord) == 8, "binary output has 8-byte records");
+
+void BatchEvaluator::evaluate(Chunk& chunk, Search& search, int depth) {
+    SearchLimits limits;
+    limits.depth = depth;
+    for (Entry& entry : chunk.entries) {
+        if (!entry.valid) {
+            continue;
+        }
+        entry.evaluation = Evaluation::evaluate(entry.position);
+        // A fresh table per position keeps every result independent of the others
+        search.clear();
+        SearchResult result = search.think(entry.position, limits, nullptr);
+        entry.score = result.score;
+        entry.depth = result.depth;
+        entry.hasMove = result.hasMove;
+        entry.best = result.bestMove;
+    }
+}
+
+int BatchEvaluator::runFile(const std::string& inputPath, const std::string& outputPath, int threads, int depth) {
+    try {
+        if (threads <= 0) {
+            threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+        if (depth < 1) {
+            throw std::runtime_error("The search depth must be at least 1.");
+        }
+
+        std::ifstream input(inputPath, std::ios::binary);
+        if (!input) {
+            throw std::runtime_error("Cannot read the positions " + inputPath);
+        }
+        FileHeader header = {};
+        input.read(reinterpret_cast<char*>(&header), sizeof(header));
+        bool binary = input.gcount() == sizeof(header) && std::memcmp(header.magic, InputMagic, sizeof(InputMagic)) == 0;
+        if (binary && header.version != FileVersion) {
+            throw std::runtime_error(inputPath + " has format version " + std::to_string(header.version) + ", expected " +
+                std::to_string(FileVersion) + ".");
+        }
+        if (!binary) {
+            input.clear();
+            input.seekg(0);
+        }
+
+        std::ofstream file;
+        if (outputPath != "-") {
+            file.open(outputPath, binary ? std::ios::binary : std::ios::out);
+            if (!file) {
+                throw std::runtime_error("Cannot write the results to " + outputPath);
+            }
+        }
+        else if (binary) {
+            throw std::runtime_error("Binary results need an output file.");
+        }
+        std::ostream& output = outputPath != "-" ? file : std::cout;
+        if (binary) {
+            FileHeader outputHeader;
+            std::memcpy(outputHeader.magic, OutputMagic, sizeof(OutputMagic));
+            outputHeader.version = FileVersion;
+            output.write(reinterpret_cast<const char*>(&outputHeader), sizeof(outputHeader));
+        }
+
+        // The window holds one token per chunk between reader and writer
+        BoundedQueue<int> window(WindowChunks * threads);
+        BoundedQueue<Chunk> toWorkers(2 * threads);
+        BoundedQueue<Chunk> toWriter(2 * threads);
+
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        auto fail = [&](std::exception_ptr exception) {
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = exception;
+                }
+            }
+            window.close();
+            toWorkers.close();
+            toWriter.close();
+        };
+
+        std::atomic<long long> positions(0);
+        std::atomic<long long> invalid(0);
+        auto start = std::chrono::steady_clock::now();
+
+        std::thread reader([&] {
+            try {
+                uint64_t index = 0;
+                Chunk chunk;
+                while (readChunk(input, binary, chunk)) {
+                    chunk.index = index++;
+                    if (!window.push(0) || !toWorkers.push(std::move(chunk))) {
+                        break;
+                    }
+                    chunk = Chunk();
+                }
+                toWorkers.close();
+            }
+            catch (...) {
+                fail(std::current_exception());
+            }
+        });
+
+        std::atomic<int> running(threads);
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; i++) {
+            workers.emplace_back([&] {
+                try {
+                    Search search(0);
+                    search.setHashKilobytes(HashKilobytes);
+                    search.setStatistics(false);
+                    Chunk chunk;
+                    while (toWorkers.pop(chunk)) {
+                        evaluate(chunk, search, depth);
+                        if (!toWriter.push(std::move(chunk))) {
+                            break;
+                        }
+                    }
+                }
+                catch (...) {
+                    fail(std::current_exception());
+                }
+                if (--running == 0) {
+                    toWriter.close();
+                }
+            });
+        }
+
+        // This thread writes; chunks finished out of order wait until their turn
+        try {
+            std::map<uint64_t, Chunk> pending;
+            uint64_t next = 0;
+            Chunk chunk;
+            while (toWriter.pop(chunk)) {
+                pending.emplace(chunk.index, std::move(chunk));
+                for (auto ready = pending.find(next); ready != pending.end(); ready = pending.find(next)) {
+                    writeChunk(output, binary, ready->second);
+                    for (size_t i = 0; i < ready->second.entries.size(); i++) {
+                        const Entry& entry = ready->second.entries[i];
+                        if (entry.valid) {
+                            continue;
+                        }
+                        // Binary results keep only a flag, so name the first bad records here
+                        if (binary && invalid < ReportedErrors) {
+                            std::cout << "Record " << ready->second.index * ChunkPositions + i + 1 << ": " << entry.error << std::endl;
+                        }
+                        invalid++;
+                    }
+                    positions += ready->second.entries.size();
+                    pending.erase(ready);
+                    next++;
+                    int token;
+                    window.pop(token);
+                }
+            }
+            output.flush();
+            if (!output) {
+                throw std::runtime_error("Cannot write the results to " + outputPath);
+            }
+        }
+        catch (...) {
+            fail(std::current_exception());
+        }
+
+        reader.join();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Stalls as a share of the time each stage had: one thread for reader and writer, threads for the workers
+        auto share = [seconds](double stalled, int stageThreads) {
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(2) << stalled << " s (" << std::setprecision(1)
+                << (seconds > 0.0 ? 100.0 * stalled / (seconds * stageThreads) : 0.0) << "%)";
+            return text.str();
+        };
+        std::ostream& report = outputPath != "-" ? std::cout : std::cerr;
+        report << "Evaluated " << positions.load() << " positions (" << invalid.load() << " invalid) at depth " << depth
+            << " with " << threads << " workers in " << std::fixed << std::setprecision(2) << seconds << " s: "
+            << std::setprecision(0) << (seconds > 0.0 ? positions.load() / seconds : 0.0) << " positions/s"
+            << std::defaultfloat << std::setprecision(6) << std::endl;
+        report << "Stalls: reader blocked " << share(window.pushWaitSeconds() + toWorkers.pushWaitSeconds(), 1)
+            << ", workers starved " << share(toWorkers.popWaitSeconds(), threads)
+            << ", workers blocked " << share(toWriter.pushWaitSeconds(), threads)
+            << ", writer starved " << share(toWriter.popWaitSeconds(), 1) << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+#ifndef BATCHEVALUATOR_H
+#define BATCHEVALUATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Position.h"
+#include "Search.h"
+
+/**
+ * @brief The BatchEvaluator class scores large files of positions for offline analysis.
+ *
+ * Every position gets its static evaluation and the score and best move of a
+ * shallow search, both for the side to move. The input is either text, one
+ * position per line in the format of Position::fromString ("startpos" for
+ * the initial position, empty lines and lines starting with '#' skipped), or
+ * binary: a FileHeader with magic "CKPI" followed by PositionRecords. Text
+ * input gives one text line per position, binary input a FileHeader with
+ * magic "CKPO" followed by one ResultRecord per position, always in input
+ * order. Binary files use the byte order of the machine.
+ *
+ * The work is a pipeline: a reader thread cuts the input into chunks of
+ * ChunkPositions positions, small enough that a chunk, its results and a
+ * worker's search tables stay in the core's cache; worker threads score the
+ * chunks; a writer thread puts them back in order and writes them. The
+ * stages are linked by BoundedQueues, and the reader may not get more than a
+ * window of chunks ahead of the writer, so memory stays bounded however large
+ * the input is and however uneven the chunks. The searches clear their table
+ * before every position, so the results do not depend on the number of
+ * threads.
+ */
+class BatchEvaluator {
+public:
+    static const size_t ChunkPositions = 256;       ///< Positions per chunk.
+    static const size_t WindowChunks = 8;           ///< Chunks in flight per worker.
+    static const size_t HashKilobytes = 64;         ///< Transposition table of each worker.
+    static const uint32_t FileVersion = 1;          ///< Version of the binary formats.
+    static const uint16_t NoMove = 0xFFFF;          ///< ResultRecord::best when there is no legal move.
+
+    /**
+     * @brief The FileHeader struct starts a binary input or output file.
+     */
+    struct FileHeader {
+        char magic[4];              ///< "CKPI" for input, "CKPO" for output.
+        uint32_t version;           ///< FileVersion.
+    };
+
+    /**
+     * @brief The PositionRecord struct is one position of a binary input file.
+     */
+    struct PositionRecord {
+        uint32_t white;             ///< Squares of the white pieces, as in Position.
+        uint32_t black;             ///< Squares of the black pieces.
+        uint32_t kings;             ///< Squares of the kings of both colours.
+        uint32_t whiteToMove;       ///< 1 if white is to move, else 0.
+    };
+
+    /**
+     * @brief The ResultRecord struct is the result of one position in a binary output file.
+     */
+    struct ResultRecord {
+        int16_t evaluation;         ///< Static evaluation.
+        int16_t score;              ///< Search score, clamped to the int16_t range.
+        uint16_t best;              ///< PackedMove of the best move in the position, or NoMove.
+        uint8_t depth;              ///< Depth searched.
+        uint8_t valid;              ///< 0 if the input record was not a valid position.
+    };
+
+    /**
+     * @brief The Entry struct is one position on its way through the pipeline.
+     */
+    struct Entry {
+        std::string text;           ///< The input line in text mode.
+        Position position;          ///< The position, if valid.
+        bool valid;                 ///< False if the input could not be read as a position.
+        std::string error;          ///< Why the input is not valid.
+        int evaluation;             ///< Static evaluation.
+        int score;                  ///< Search score.
+        int depth;                  ///< Depth searched.
+        bool hasMove;               ///< False if the side to move has no legal move.
+        BoardMove best;             ///< Best move found, if hasMove.
+    };
+
+    /**
+     * @brief The Chunk struct is the unit of work of the pipeline.
+     */
+    struct Chunk {
+        uint64_t index = 0;             ///< Position of the chunk in the input, from 0.
+        std::vector<Entry> entries;     ///< The positions.
+    };
+
+    /**
+     * @brief Score every position of a chunk.
+     *
+     * @param chunk The chunk.
+     * @param search The worker's search.
+     * @param depth Depth of every search.
+     */
+    static void evaluate(Chunk& chunk, Search& search, int depth);
+
+    /**
+     * @brief Score a file from the command line.
+     *
+     * @param inputPath The positions, text or binary.
+     * @param outputPath The results, "-" for the console with text input.
+     * @param threads Worker threads, 0 for one per core.
+     * @param depth Depth of the searches.
+     * @return 0 on success, 1 on error.
+     */
+    static int runFile(const std::string& inputPath, const std::string& outputPath, int threads, int depth);
+};
+
+#endif
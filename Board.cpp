@@ -3,12 +3,18 @@
 #include "Pawn.h"
 #include <iostream>
 #include "Queen.h"
+#include "Position.h"
+#include "MemoryAccounting.h"
 
-Board::Board() {
+Board::Board() : currentState(nullptr), whitePiecesLeft(false), blackPiecesLeft(false) {
+    pawns[0] = pawns[1] = 0;
+    queens[0] = queens[1] = 0;
+
+    MemoryScope scope(MemoryTag::Board);
     // Initialize the chess board with squares and nullptr (no pieces) initially
     for (int i = 0; i < 8; i++) {
         for (int j = 0; j < 8; j++) {
-            tab[i][j] = new Square(i, j, nullptr);
+            tab[i][j] = new Square(i, j, nullptr, this);
         }
     }
 }
@@ -26,8 +32,8 @@ void Board::displayState() {
 void Board::clearConsole(std::string name, std::string name1) {
     // Clear the console and display game setup information
     std::system("cls");
-    std::cout << "Choose player 1 type (1 - Human, 2 - Computer): 1" << std::endl;
-    std::cout << "Choose player 2 type (1 - Human, 2 - Computer): 1" << std::endl;
+    std::cout << "Choose player 1 type (1 - Human, 2 - Computer, 3 - MCTS): 1" << std::endl;
+    std::cout << "Choose player 2 type (1 - Human, 2 - Computer, 3 - MCTS): 1" << std::endl;
     std::cout << "Enter name for player 1: " << name << std::endl;
     std::cout << "Enter name for player 2: " << name1 << std::endl;
     std::cout << "Player 1 name: " << name << std::endl;
@@ -35,38 +41,100 @@ void Board::clearConsole(std::string name, std::string name1) {
     std::cout << std::endl;
 }
 
-bool Board::CheckGameOver() {
-    whitePiecesLeft = false;
-    blackPiecesLeft = false;
+void Board::squareChanged(int x, int y, Piece* piece) {
+    int square = Position::squareIndex(x, y);
+    if (square < 0) {
+        return; // Light squares never hold pieces
+    }
 
-    // Check if there are any pieces left on the board
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            Square* square = tab[i][j];
+    // Forget what was on the square; the old piece may already be deleted, so use the copy
+    uint32_t bit = 1u << square;
+    if ((pieces.white | pieces.black) & bit) {
+        int side = (pieces.white & bit) ? 0 : 1;
+        if (pieces.kings & bit) {
+            queens[side]--;
+        }
+        else {
+            pawns[side]--;
+        }
+    }
+    pieces.white &= ~bit;
+    pieces.black &= ~bit;
+    pieces.kings &= ~bit;
 
-            if (square != nullptr) {
-                Piece* piece = square->getPiece();
+    if (piece == nullptr) {
+        return;
+    }
 
-                if (piece != nullptr) {
-                    if (piece->isWhite()) {
-                        whitePiecesLeft = true;
-                    }
-                    else {
-                        blackPiecesLeft = true;
-                    }
-                }
-            }
-        }
+    int side = piece->isWhite() ? 0 : 1;
+    (piece->isWhite() ? pieces.white : pieces.black) |= bit;
+    if (piece->getType() == "Queen") {
+        pieces.kings |= bit;
+        queens[side]++;
+    }
+    else {
+        pawns[side]++;
+    }
+}
+
+uint32_t Board::mobility(bool white) const {
+    return toPosition(white).movers();
+}
+
+uint32_t Board::capturingPieces(bool white) const {
+    return toPosition(white).jumpers();
+}
+
+Position Board::toPosition(bool whiteToMove) const {
+    Position position = pieces;
+    position.whiteToMove = whiteToMove;
+    return position;
+}
+
+bool Board::isGameOver(bool isWhitePlayerTurn) const {
+    return !toPosition(isWhitePlayerTurn).hasLegalMove();
+}
+
+void Board::recordPosition(bool whiteToMove) {
+    Position current = toPosition(whiteToMove);
+    uint64_t key = current.hashKey();
+    if (history.length() > 0 && key == history.lastKey()) {
+        return; // The same turn checked again, e.g. after an invalid move
     }
 
-    // If there are no white or black pieces left, set the game to GameOverState
-    if (!whitePiecesLeft || !blackPiecesLeft) {
-        setState(new GameOverState());
-        std::cout << "Game Over!" << std::endl;
-        return true;
+    // A capture or a pawn move can never be undone, so older positions cannot repeat
+    bool irreversible = history.length() == 0 ||
+        popCount(current.white | current.black) != popCount(recorded.white | recorded.black) ||
+        (current.white & ~current.kings) != (recorded.white & ~recorded.kings) ||
+        (current.black & ~current.kings) != (recorded.black & ~recorded.kings);
+
+    history.push(key, irreversible);
+    recorded = current;
+}
+
+bool Board::CheckGameOver(bool isWhitePlayerTurn) {
+    whitePiecesLeft = pawnCount(true) + queenCount(true) > 0;
+    blackPiecesLeft = pawnCount(false) + queenCount(false) > 0;
+    recordPosition(isWhitePlayerTurn);
+
+    if (!isGameOver(isWhitePlayerTurn)) {
+        if (history.isThreefoldRepetition() || history.isMoveLimitReached()) {
+            DrawState::Reason reason = history.isThreefoldRepetition() ? DrawState::Repetition : DrawState::MoveLimit;
+            setState(new DrawState(reason, history.getMoveLimit()));
+            displayState();
+            return true;
+        }
+        return false; // The game is not over yet
     }
 
-    return false; // The game is not over yet
+    // The side to move has no pieces or all of them are blocked
+    bool piecesLeft = isWhitePlayerTurn ? whitePiecesLeft : blackPiecesLeft;
+    std::cout << (isWhitePlayerTurn ? "White" : "Black") << (piecesLeft ? " cannot move" : " has no pieces left")
+        << ", " << (isWhitePlayerTurn ? "black" : "white") << " wins." << std::endl;
+
+    setState(new GameOverState());
+    std::cout << "Game Over!" << std::endl;
+    return true;
 }
 
 Square* Board::getSquare(int x, int y) const {
@@ -78,10 +146,10 @@ void Board::GameCreation() {
     for (int i = 0; i < 3; i++) {
         for (int j = 0; j < 8; j++) {
             if ((j % 2) == (i % 2)) {
-                tab[i][j] = new Square(i, j, nullptr);
+                tab[i][j]->SetPiece(nullptr);
             }
             else {
-                tab[i][j] = new Square(i, j, new Pawn(false));
+                tab[i][j]->SetPiece(new Pawn(false));
             }
         }
     }
@@ -89,10 +157,10 @@ void Board::GameCreation() {
     for (int i = 3; i < 5; i++) {
         for (int j = 0; j < 8; j++) {
             if ((j % 2) == (i % 2)) {
-                tab[i][j] = new Square(i, j, nullptr);
+                tab[i][j]->SetPiece(nullptr);
             }
             else {
-                tab[i][j] = new Square(i, j, nullptr);
+                tab[i][j]->SetPiece(nullptr);
             }
         }
     }
@@ -100,10 +168,10 @@ void Board::GameCreation() {
     for (int i = 5; i < 8; i++) {
         for (int j = 0; j < 8; j++) {
             if ((j % 2) == (i % 2)) {
-                tab[i][j] = new Square(i, j, nullptr);
+                tab[i][j]->SetPiece(nullptr);
             }
             else {
-                tab[i][j] = new Square(i, j, new Pawn(true));
+                tab[i][j]->SetPiece(new Pawn(true));
             }
         }
     }
@@ -189,3 +257,37 @@ void Board::promoteQueen(int x, int y, Piece* piece) {
     }
 }
 
+void Board::applyMove(const BoardMove& move) {
+    // The game record grows here
+    MemoryScope scope(MemoryTag::Board);
+
+    // The colour of the moving piece tells whose move it is
+    Position before = toPosition((pieces.white >> move.from & 1) != 0);
+    if (record.current() != before) {
+        record.reset(before);
+    }
+    record.push(move);
+
+    int fromX = Position::squareRow(move.from);
+    int fromY = Position::squareColumn(move.from);
+    int toX = Position::squareRow(move.to);
+    int toY = Position::squareColumn(move.to);
+
+    // Lift the piece first, a capture sequence may end on its own starting square
+    Piece* piece = tab[fromX][fromY]->getPiece();
+    tab[fromX][fromY]->SetPiece(nullptr);
+
+    // Remove the captured pieces
+    for (uint32_t captured = move.captured; captured != 0; captured &= captured - 1) {
+        int square = lowestBit(captured);
+        Square* capturedSquare = tab[Position::squareRow(square)][Position::squareColumn(square)];
+        delete capturedSquare->getPiece();
+        capturedSquare->SetPiece(nullptr);
+    }
+
+    tab[toX][toY]->SetPiece(piece);
+
+    if (move.promotes) {
+        promoteQueen(toX, toY, piece);
+    }
+}
@@ -6,6 +6,11 @@
 #include "GameState.h"
 #include "StartState.h"
 #include "GameOverState.h"
+#include "BoardMove.h"
+#include "Position.h"
+#include "GameHistory.h"
+#include "GameRecord.h"
+#include "DrawState.h"
 
 class Piece;
 
@@ -15,12 +20,30 @@ class Piece;
  * The board is an 8x8 grid of squares, each of which may contain a chess piece.
  * The class also manages the game state, including whether there are white or
  * black pieces left and the current state of the game.
+ *
+ * Every square reports piece changes back to the board, which keeps a compact
+ * Position copy and per-side pawn and queen counts up to date. Piece counts,
+ * mobility, capture availability and game over are therefore answered in
+ * constant time without scanning the squares.
  */
 class Board {
 private:
     Square* tab[8][8]; ///< 2D array representing the chess board.
     friend std::ostream& operator<<(std::ostream& os, const Board& board);
     GameState* currentState; ///< Pointer to the current game state.
+    Position pieces; ///< Compact copy of the pieces on the squares.
+    int pawns[2]; ///< Number of pawns, white first.
+    int queens[2]; ///< Number of queens, white first.
+    GameHistory history; ///< Positions of the game, for draw detection.
+    Position recorded; ///< Last position added to the history.
+    GameRecord record; ///< Moves applied with applyMove.
+
+    /**
+     * @brief Add the current position to the history unless it is already the last entry.
+     *
+     * @param whiteToMove True if white is to move.
+     */
+    void recordPosition(bool whiteToMove);
 
 public:
     bool whitePiecesLeft; ///< Indicates if there are white pieces left on the board.
@@ -63,6 +86,18 @@ public:
      */
     void promoteQueen(int x, int y, Piece* piece);
 
+    /**
+     * @brief Apply a move found by the engine to the board.
+     *
+     * The moving piece is transferred to its destination, captured pieces are
+     * removed and deleted, and a pawn reaching the last row is promoted. The
+     * move is added to the game record, which restarts from the current
+     * position if the board was changed in another way since the last move.
+     *
+     * @param move The move to apply, generated by Position::generateMoves.
+     */
+    void applyMove(const BoardMove& move);
+
     /**
      * @brief Set the current game state to a new state.
      *
@@ -70,12 +105,98 @@ public:
      */
     void setState(GameState* newState);
 
+    /**
+     * @brief Record a piece change of a square; called by Square::SetPiece.
+     *
+     * @param x The x-coordinate of the square.
+     * @param y The y-coordinate of the square.
+     * @param piece The piece now on the square, or nullptr.
+     */
+    void squareChanged(int x, int y, Piece* piece);
+
+    /**
+     * @brief Get the number of pawns of a side.
+     *
+     * @param white True for white.
+     * @return The number of pawns.
+     */
+    int pawnCount(bool white) const { return pawns[white ? 0 : 1]; }
+
+    /**
+     * @brief Get the number of queens of a side.
+     *
+     * @param white True for white.
+     * @return The number of queens.
+     */
+    int queenCount(bool white) const { return queens[white ? 0 : 1]; }
+
+    /**
+     * @brief Get the pieces of a side that can step to an adjacent empty square.
+     *
+     * @param white True for white.
+     * @return Mask of the pieces, indexed as in Position.
+     */
+    uint32_t mobility(bool white) const;
+
+    /**
+     * @brief Get the pieces of a side that can capture.
+     *
+     * @param white True for white.
+     * @return Mask of the pieces, indexed as in Position.
+     */
+    uint32_t capturingPieces(bool white) const;
+
+    /**
+     * @brief Get the compact engine position of the board.
+     *
+     * @param whiteToMove True if white is to move.
+     * @return The position.
+     */
+    Position toPosition(bool whiteToMove) const;
+
+    /**
+     * @brief Check in constant time whether the side to move has lost.
+     *
+     * A side loses when it has no legal move, either because it has no pieces
+     * left or because all of them are blocked.
+     *
+     * @param isWhitePlayerTurn True if white is to move.
+     * @return True if the game is over.
+     */
+    bool isGameOver(bool isWhitePlayerTurn) const;
+
+    /**
+     * @brief Get the positions of the game so far, for draw detection in the search.
+     *
+     * @return The history, whose last entry is the position of the last CheckGameOver call.
+     */
+    const GameHistory& getHistory() const { return history; }
+
+    /**
+     * @brief Get the moves played on the board.
+     *
+     * @return The record of every move applied with applyMove since the position was last set up another way.
+     */
+    const GameRecord& getRecord() const { return record; }
+
+    /**
+     * @brief Change the number of moves per side without a capture or a pawn move after which the game is drawn.
+     *
+     * @param moves The move limit.
+     */
+    void setMoveLimit(int moves) { history.setMoveLimit(moves); }
+
     /**
      * @brief Check if the game is over and return true if it is.
      *
+     * The position is recorded in the game history first. The game is over when
+     * the side to move cannot move (GameOverState), after a threefold repetition
+     * or when the move limit is reached (DrawState). The result is announced.
+     *
+     * @param isWhitePlayerTurn True if white is to move.
      * @return True if the game is over, otherwise false.
      */
-    bool CheckGameOver();
+    bool CheckGameOver(bool isWhitePlayerTurn);
 
     /**
      * @brief Display the current state of the board.
@@ -0,0 +1,59 @@
+#ifndef BOARDMOVE_H
+#define BOARDMOVE_H
+
+#include <cstdint>
+
+/**
+ * @brief The BoardMove struct describes one complete move on the compact board.
+ *
+ * Squares are numbered 0-31 over the playable (dark) squares, row by row, as
+ * described in Position.h. A capture stores every landing square of the jump
+ * sequence so it can be replayed hop by hop, together with the set of captured
+ * pieces so that the move can be unmade without extra bookkeeping.
+ */
+struct BoardMove {
+    static const int MaxHops = 12; ///< Longest possible jump sequence on an 8x8 board.
+
+    uint8_t from;             ///< Square the moving piece starts on.
+    uint8_t to;               ///< Square the moving piece ends on.
+    uint8_t hops;             ///< Number of jumps (0 for a quiet move).
+    bool promotes;            ///< True if a pawn is promoted to a queen by this move.
+    uint32_t captured;        ///< Bitmask of the squares of the captured pieces.
+    uint32_t capturedKings;   ///< Subset of captured that held queens.
+    uint8_t path[MaxHops];    ///< Landing square of every jump, path[hops - 1] == to.
+
+    /**
+     * @brief Check if the move captures at least one piece.
+     *
+     * @return True if the move is a capture, otherwise false.
+     */
+    bool isCapture() const { return hops > 0; }
+};
+
+/**
+ * @brief The MoveList struct is a fixed-capacity list of generated moves.
+ *
+ * It lives on the stack so that move generation never allocates.
+ */
+struct MoveList {
+    static const int Capacity = 128; ///< Upper bound on the number of legal moves.
+
+    BoardMove moves[Capacity]; ///< Generated moves.
+    int count = 0;             ///< Number of valid entries in moves.
+
+    /**
+     * @brief Append a move to the list.
+     *
+     * @param move The move to append.
+     */
+    void add(const BoardMove& move) {
+        if (count < Capacity) {
+            moves[count++] = move;
+        }
+    }
+
+    const BoardMove& operator[](int index) const { return moves[index]; }
+    BoardMove& operator[](int index) { return moves[index]; }
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * @brief The BoundedQueue class passes items between the stages of a pipeline.
+ *
+ * push() blocks while the queue holds capacity items and pop() while it is
+ * empty, so a fast stage cannot run ahead of a slow one by more than the
+ * capacity. The time each side spends blocked is added up, which shows which
+ * stage limits the pipeline: a producer that waits a lot feeds a slow
+ * consumer, a consumer that waits a lot is starved.
+ *
+ * @tparam T The item type, moved through the queue.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    /**
+     * @brief Constructor for the BoundedQueue class.
+     *
+     * @param capacity Most items held at once, at least one.
+     */
+    explicit BoundedQueue(size_t capacity)
+        : capacity(capacity > 0 ? capacity : 1), closed(false), pushSeconds(0.0), popSeconds(0.0) {}
+
+    /**
+     * @brief Add an item, waiting while the queue is full.
+     *
+     * @return False if the queue was closed; the item is dropped.
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (items.size() >= capacity && !closed) {
+            auto start = std::chrono::steady_clock::now();
+            notFull.wait(lock, [this] { return items.size() < capacity || closed; });
+            pushSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        lock.unlock();
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest item, waiting while the queue is empty.
+     *
+     * @param item Receives the item.
+     * @return False once the queue is closed and empty.
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (items.empty() && !closed) {
+            auto start = std::chrono::steady_clock::now();
+            notEmpty.wait(lock, [this] { return !items.empty() || closed; });
+            popSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        lock.unlock();
+        notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Refuse further items and wake every waiting thread. Queued items can still be popped.
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    /**
+     * @brief Get the total time push() spent waiting for room, summed over all threads.
+     */
+    double pushWaitSeconds() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pushSeconds;
+    }
+
+    /**
+     * @brief Get the total time pop() spent waiting for an item, summed over all threads.
+     */
+    double popWaitSeconds() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return popSeconds;
+    }
+
+private:
+    const size_t capacity;                  ///< Most items held at once.
+    mutable std::mutex mutex;               ///< Guards the members below.
+    std::condition_variable notEmpty;       ///< Signalled when an item is added or the queue closes.
+    std::condition_variable notFull;        ///< Signalled when an item is taken or the queue closes.
+    std::deque<T> items;                    ///< Queued items, oldest first.
+    bool closed;                            ///< Set by close().
+    double pushSeconds;                     ///< Time push() waited.
+    double popSeconds;                      ///< Time pop() waited.
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include "CaptureTree.h"
+
+/**
+ * @file CaptureTree.cpp
+ * @brief Implementation of the capture sequence tree used to validate typed captures.
+ */
+
+void CaptureTree::build(const Position& position, const MoveList& moves) {
+    nodes.clear();
+    hops = 0;
+    for (int16_t& node : roots) {
+        node = None;
+    }
+
+    if (moves.count == 0 || !moves[0].isCapture()) {
+        return;
+    }
+
+    // All legal sequences have the maximal length (see Position::generateMoves)
+    hops = moves[0].hops;
+    uint32_t pieces = position.jumpers();
+    uint32_t targets = position.opponentPieces();
+
+    for (; pieces != 0; pieces &= pieces - 1) {
+        int square = lowestBit(pieces);
+        int node = addNode(square);
+        if (extend(node, square, moves, position.emptySquares() | (1u << square), targets, 0, 0)) {
+            roots[square] = static_cast<int16_t>(node);
+        }
+        else {
+            nodes.resize(node); // Only shorter captures start here
+        }
+    }
+}
+
+int CaptureTree::addNode(int square) {
+    Node node;
+    node.square = static_cast<uint8_t>(square);
+    node.child[0] = node.child[1] = node.child[2] = node.child[3] = None;
+    node.move = None;
+    nodes.push_back(node);
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+bool CaptureTree::extend(int node, int from, const MoveList& moves, uint32_t empty, uint32_t targets, uint32_t captured, int depth) {
+    int square = nodes[node].square;
+
+    if (depth == hops) {
+        // A complete route: find the generated move with the same result
+        for (int i = 0; i < moves.count; i++) {
+            if (moves[i].from == from && moves[i].to == square && moves[i].captured == captured) {
+                nodes[node].move = static_cast<int16_t>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool found = false;
+    for (int direction = 0; direction < 4; direction++) {
+        int over = Position::neighbor(square, direction);
+        if (over < 0 || ((targets >> over) & 1u) == 0) {
+            continue;
+        }
+        int landing = Position::jump(square, direction);
+        if (landing < 0 || ((empty >> landing) & 1u) == 0) {
+            continue;
+        }
+
+        // The captured piece is removed at once, as in Position::generateMoves
+        uint32_t overBit = 1u << over;
+        int child = addNode(landing);
+        if (extend(child, from, moves, (empty | overBit | (1u << square)) & ~(1u << landing), targets & ~overBit, captured | overBit, depth + 1)) {
+            nodes[node].child[direction] = static_cast<int16_t>(child);
+            found = true;
+        }
+        else {
+            nodes.resize(child); // Drop the dead branch
+        }
+    }
+    return found;
+}
+
+int CaptureTree::hop(int node, int landing) const {
+    if (node == None) {
+        return None;
+    }
+    for (int child : nodes[node].child) {
+        if (child != None && nodes[child].square == landing) {
+            return child;
+        }
+    }
+    return None;
+}
@@ -0,0 +1,108 @@
+#ifndef CAPTURETREE_H
+#define CAPTURETREE_H
+
+#include <cstdint>
+#include <vector>
+#include "Position.h"
+
+/**
+ * @brief The CaptureTree class holds every legal capture sequence of a position as a tree.
+ *
+ * The tree is built once per turn from the position, without touching the
+ * interactive board. Each node is a square the capturing piece lands on and
+ * has at most one child per direction, so checking the next hop typed by a
+ * player is a constant-time lookup. Leaves refer to the generated move they
+ * complete, which is then applied to the board in one go.
+ *
+ * Unlike Position::generateMoves, which keeps one route per set of captured
+ * pieces, the tree contains every route, so any legal way of typing a capture
+ * is accepted. The node storage is kept between builds and does not allocate
+ * once it has grown.
+ */
+class CaptureTree {
+public:
+    static const int None = -1; ///< Returned when no node matches.
+
+    /**
+     * @brief Build the tree for a position.
+     *
+     * @param position The position; its side to move captures.
+     * @param moves The legal moves of the position, from Position::generateMoves.
+     */
+    void build(const Position& position, const MoveList& moves);
+
+    /**
+     * @brief Check if the position had no capture.
+     */
+    bool empty() const { return nodes.empty(); }
+
+    /**
+     * @brief Get the number of captures in every legal sequence.
+     */
+    int length() const { return hops; }
+
+    /**
+     * @brief Get the node of a piece starting a legal capture.
+     *
+     * @param square The square index of the piece (0-31).
+     * @return The node, or None if that piece cannot capture.
+     */
+    int root(int square) const { return square >= 0 && square < 32 ? roots[square] : None; }
+
+    /**
+     * @brief Follow one hop of a capture sequence.
+     *
+     * @param node The node of the square the piece stands on.
+     * @param landing The square index the piece jumps to.
+     * @return The node of the landing square, or None if the hop is not legal.
+     */
+    int hop(int node, int landing) const;
+
+    /**
+     * @brief Check if a node ends a complete capture sequence.
+     */
+    bool isComplete(int node) const { return nodes[node].move != None; }
+
+    /**
+     * @brief Get the move a complete sequence ends in.
+     *
+     * @param node A node for which isComplete() is true.
+     * @return Index of the move in the list given to build().
+     */
+    int moveIndex(int node) const { return nodes[node].move; }
+
+private:
+    /**
+     * @brief One landing square of a capture route.
+     */
+    struct Node {
+        uint8_t square;     ///< Square the piece lands on (the start square for roots).
+        int16_t child[4];   ///< Next node per direction, None if none.
+        int16_t move;       ///< Completed move for leaves, otherwise None.
+    };
+
+    std::vector<Node> nodes;    ///< All nodes, roots included.
+    int16_t roots[32];          ///< Root node per start square.
+    int hops = 0;               ///< Captures per sequence.
+
+    /**
+     * @brief Add the routes continuing from a node.
+     *
+     * @param node The node the piece stands on.
+     * @param from The start square of the route.
+     * @param moves The legal moves the complete routes are matched against.
+     * @param empty Squares free to land on.
+     * @param targets Opponent pieces not captured yet.
+     * @param captured Pieces captured so far.
+     * @param depth Captures so far.
+     * @return True if at least one complete route of the required length was added below the node.
+     */
+    bool extend(int node, int from, const MoveList& moves, uint32_t empty, uint32_t targets, uint32_t captured, int depth);
+
+    /**
+     * @brief Create a node without children.
+     */
+    int addNode(int square);
+};
+
+#endif
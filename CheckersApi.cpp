@@ -0,0 +1,233 @@
+#include "CheckersApi.h"
+#include "GameHistory.h"
+#include "Position.h"
+#include "Search.h"
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @file CheckersApi.cpp
+ * @brief Implementation of the C interface of the engine library.
+ */
+
+static_assert(CHECKERS_MAX_MOVES >= MoveList::Capacity, "checkers_move arrays must hold every legal move");
+static_assert(CHECKERS_MOVE_TEXT > 2 + 3 * BoardMove::MaxHops, "checkers_move must hold the longest capture");
+
+/**
+ * @brief The checkers_engine struct is one game with its own search.
+ *
+ * Everything an engine owns is here; the move generation tables are
+ * constexpr data shared by all engines.
+ */
+struct checkers_engine {
+    Position position;          ///< The current position.
+    GameHistory history;        ///< Positions of the game ending with position.
+    Search search;              ///< Search with its own transposition table.
+    std::string error;          ///< Message of the last failed call.
+    std::string text;           ///< Storage of strings handed to the caller.
+
+    explicit checkers_engine(size_t hashKilobytes) : position(Position::initial()), search(0) {
+        search.setHashKilobytes(hashKilobytes);
+        search.setStatistics(false);
+        history.reset(position.hashKey());
+    }
+};
+
+namespace {
+    /**
+     * @brief Run the body of an API function, turning exceptions into status codes.
+     */
+    template <typename Body>
+    int guarded(checkers_engine* engine, Body body) {
+        if (engine == nullptr) {
+            return CHECKERS_INVALID_ARGUMENT;
+        }
+        try {
+            engine->error.clear();
+            return body();
+        }
+        catch (const std::bad_alloc&) {
+            engine->error = "Out of memory.";
+            return CHECKERS_OUT_OF_MEMORY;
+        }
+        catch (const std::exception& e) {
+            engine->error = e.what();
+            return CHECKERS_INTERNAL_ERROR;
+        }
+    }
+
+    int fail(checkers_engine* engine, int status, const std::string& message) {
+        engine->error = message;
+        return status;
+    }
+
+    void copyMove(const BoardMove& move, checkers_move& target) {
+        std::string text = Position::moveToString(move);
+        std::memcpy(target.text, text.c_str(), text.size() + 1);
+        target.captures = move.hops;
+    }
+}
+
+extern "C" {
+
+const char* checkers_version(void) {
+    return "1.0";
+}
+
+checkers_engine* checkers_engine_create(size_t hash_kilobytes) {
+    try {
+        return new checkers_engine(hash_kilobytes > 0 ? hash_kilobytes : CHECKERS_DEFAULT_HASH_KILOBYTES);
+    }
+    catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void checkers_engine_destroy(checkers_engine* engine) {
+    delete engine;
+}
+
+size_t checkers_engine_memory(const checkers_engine* engine) {
+    if (engine == nullptr) {
+        return 0;
+    }
+    return sizeof(*engine) - sizeof(engine->search) + engine->search.memoryBytes() + engine->error.capacity() +
+        engine->text.capacity();
+}
+
+const char* checkers_engine_error(const checkers_engine* engine) {
+    return engine != nullptr ? engine->error.c_str() : "No engine.";
+}
+
+int checkers_engine_set_position(checkers_engine* engine, const char* position) {
+    return guarded(engine, [&] {
+        Position next = Position::initial();
+        if (position != nullptr && std::strcmp(position, "startpos") != 0) {
+            try {
+                next = Position::fromString(position);
+            }
+            catch (const std::runtime_error& e) {
+                return fail(engine, CHECKERS_INVALID_ARGUMENT, e.what());
+            }
+        }
+        engine->position = next;
+        engine->history.reset(next.hashKey());
+        return static_cast<int>(CHECKERS_OK);
+    });
+}
+
+int checkers_engine_get_position(checkers_engine* engine, char* buffer, size_t size) {
+    return guarded(engine, [&] {
+        if (buffer == nullptr) {
+            return fail(engine, CHECKERS_INVALID_ARGUMENT, "No buffer.");
+        }
+        std::string text = engine->position.toString();
+        if (text.size() >= size) {
+            return fail(engine, CHECKERS_BUFFER_TOO_SMALL, "The position needs " + std::to_string(text.size() + 1) + " bytes.");
+        }
+        std::memcpy(buffer, text.c_str(), text.size() + 1);
+        return static_cast<int>(CHECKERS_OK);
+    });
+}
+
+int checkers_engine_white_to_move(const checkers_engine* engine) {
+    return engine != nullptr ? (engine->position.whiteToMove ? 1 : 0) : CHECKERS_INVALID_ARGUMENT;
+}
+
+int checkers_engine_game_state(const checkers_engine* engine) {
+    if (engine == nullptr) {
+        return CHECKERS_INVALID_ARGUMENT;
+    }
+    if (!engine->position.hasLegalMove()) {
+        return engine->position.whiteToMove ? CHECKERS_BLACK_WINS : CHECKERS_WHITE_WINS;
+    }
+    if (engine->history.isThreefoldRepetition() || engine->history.isMoveLimitReached()) {
+        return CHECKERS_DRAW;
+    }
+    return CHECKERS_PLAYING;
+}
+
+int checkers_engine_legal_moves(checkers_engine* engine, checkers_move* moves, int capacity) {
+    return guarded(engine, [&] {
+        MoveList list;
+        engine->position.generateMoves(list);
+        if (moves == nullptr) {
+            return list.count;
+        }
+        if (capacity < list.count) {
+            return fail(engine, CHECKERS_BUFFER_TOO_SMALL, "There are " + std::to_string(list.count) + " legal moves.");
+        }
+        for (int i = 0; i < list.count; i++) {
+            copyMove(list[i], moves[i]);
+        }
+        return list.count;
+    });
+}
+
+int checkers_engine_apply_move(checkers_engine* engine, const char* move) {
+    return guarded(engine, [&] {
+        if (move == nullptr) {
+            return fail(engine, CHECKERS_INVALID_ARGUMENT, "No move.");
+        }
+        BoardMove found;
+        if (!engine->position.findMove(move, found)) {
+            return fail(engine, CHECKERS_ILLEGAL_MOVE, std::string(move) + " is not a legal move.");
+        }
+        bool irreversible = GameHistory::isIrreversible(engine->position, found);
+        engine->position.makeMove(found);
+        engine->history.push(engine->position.hashKey(), irreversible);
+        return static_cast<int>(CHECKERS_OK);
+    });
+}
+
+int checkers_engine_search(checkers_engine* engine, const checkers_limits* limits, checkers_info_callback callback,
+    void* user_data, checkers_result* result) {
+    return guarded(engine, [&] {
+        if (result == nullptr) {
+            return fail(engine, CHECKERS_INVALID_ARGUMENT, "No result.");
+        }
+        SearchLimits searchLimits;
+        if (limits == nullptr) {
+            searchLimits.depth = 10;
+        }
+        else {
+            searchLimits.depth = limits->depth > 0 ? limits->depth : Search::MaxPly;
+            searchLimits.nodes = limits->nodes;
+            searchLimits.milliseconds = limits->milliseconds;
+        }
+
+        std::function<void(const SearchInfo&)> onInfo;
+        if (callback != nullptr) {
+            onInfo = [engine, callback, user_data](const SearchInfo& info) {
+                engine->text.clear();
+                for (const BoardMove& move : info.pv) {
+                    engine->text += (engine->text.empty() ? "" : " ") + Position::moveToString(move);
+                }
+                checkers_info report = { info.depth, info.score, info.nodes, info.seconds, engine->text.c_str() };
+                callback(&report, user_data);
+            };
+        }
+
+        SearchResult found = engine->search.think(engine->position, searchLimits, onInfo, &engine->history);
+        std::memset(result, 0, sizeof(*result));
+        result->has_move = found.hasMove ? 1 : 0;
+        if (found.hasMove) {
+            copyMove(found.bestMove, result->best_move);
+        }
+        result->score = found.score;
+        result->depth = found.depth;
+        result->nodes = found.nodes;
+        result->seconds = found.seconds;
+        return static_cast<int>(CHECKERS_OK);
+    });
+}
+
+void checkers_engine_stop(checkers_engine* engine) {
+    if (engine != nullptr) {
+        engine->search.stop();
+    }
+}
+
+}
@@ -0,0 +1,233 @@
+#ifndef CHECKERSAPI_H
+#define CHECKERSAPI_H
+
+#include <stddef.h>
+
+/**
+ * @file CheckersApi.h
+ * @brief C interface of the embeddable engine library.
+ *
+ * The library holds the rules and the search without the console game, so a
+ * server can run its games in process. A checkers_engine is one game: a
+ * position, the positions played before it (for repetitions and the move
+ * limit) and a search with its own transposition table. Engines share only
+ * the immutable move generation tables, so any number of them can live in one
+ * process and different engines can be used from different threads at the
+ * same time. One engine must not be used from two threads at once, except for
+ * checkers_engine_stop(). Nothing in the library prints, exits the process or
+ * lets an exception escape; errors are returned as checkers_status codes and
+ * described by checkers_engine_error().
+ *
+ * Positions use the text format "W:W21,22,K30:B1,2" (side to move, then the
+ * white and black pieces as squares 1-32, kings prefixed with K) and moves the
+ * notation "c3-d4" or "a3xc5xe7".
+ */
+
+#ifdef _WIN32
+#ifdef CHECKERS_API_EXPORTS
+#define CHECKERS_API __declspec(dllexport)
+#else
+#define CHECKERS_API __declspec(dllimport)
+#endif
+#else
+#define CHECKERS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHECKERS_MAX_MOVES 128              /**< Upper bound on the number of legal moves. */
+#define CHECKERS_MOVE_TEXT 48               /**< Size of a move text buffer, terminator included. */
+#define CHECKERS_POSITION_TEXT 128          /**< Size of a position text buffer, terminator included. */
+#define CHECKERS_DEFAULT_HASH_KILOBYTES 1024 /**< Table size used when 0 is passed to checkers_engine_create(). */
+
+/**
+ * @brief An engine instance, created by checkers_engine_create().
+ */
+typedef struct checkers_engine checkers_engine;
+
+/**
+ * @brief Result codes of the functions that can fail.
+ */
+typedef enum checkers_status {
+    CHECKERS_OK = 0,                        /**< Success. */
+    CHECKERS_INVALID_ARGUMENT = -1,         /**< A null pointer or malformed text. */
+    CHECKERS_ILLEGAL_MOVE = -2,             /**< The move is not legal in the current position. */
+    CHECKERS_BUFFER_TOO_SMALL = -3,         /**< The output buffer cannot hold the answer. */
+    CHECKERS_OUT_OF_MEMORY = -4,            /**< An allocation failed. */
+    CHECKERS_INTERNAL_ERROR = -5            /**< Anything else; see checkers_engine_error(). */
+} checkers_status;
+
+/**
+ * @brief State of the game in the current position.
+ */
+typedef enum checkers_game_state {
+    CHECKERS_PLAYING = 0,                   /**< The side to move has a legal move. */
+    CHECKERS_WHITE_WINS = 1,                /**< Black is to move and cannot. */
+    CHECKERS_BLACK_WINS = 2,                /**< White is to move and cannot. */
+    CHECKERS_DRAW = 3                       /**< Threefold repetition or move limit. */
+} checkers_game_state;
+
+/**
+ * @brief A legal move.
+ */
+typedef struct checkers_move {
+    char text[CHECKERS_MOVE_TEXT];          /**< The move, e.g. "c3-d4" or "a3xc5xe7". */
+    int captures;                           /**< Number of pieces captured. */
+} checkers_move;
+
+/**
+ * @brief When a search stops. Zero means "no limit" for every field.
+ */
+typedef struct checkers_limits {
+    int depth;                              /**< Maximum depth. */
+    long long nodes;                        /**< Node budget. */
+    int milliseconds;                       /**< Time budget. */
+} checkers_limits;
+
+/**
+ * @brief One finished iteration of a search, passed to the callback.
+ */
+typedef struct checkers_info {
+    int depth;                              /**< Depth of the iteration. */
+    int score;                              /**< Score for the side to move in hundredths of a pawn. */
+    long long nodes;                        /**< Nodes searched so far. */
+    double seconds;                         /**< Time spent so far. */
+    const char* pv;                         /**< Principal variation, moves separated by spaces; valid during the call only. */
+} checkers_info;
+
+/**
+ * @brief The outcome of a search.
+ */
+typedef struct checkers_result {
+    int has_move;                           /**< Zero if the side to move has no legal move. */
+    checkers_move best_move;                /**< The move to play. */
+    int score;                              /**< Score of the best move for the side to move. */
+    int depth;                              /**< Depth of the last finished iteration. */
+    long long nodes;                        /**< Nodes searched. */
+    double seconds;                         /**< Time spent. */
+} checkers_result;
+
+/**
+ * @brief Receives the progress of a search, on the thread running it.
+ *
+ * @param info The finished iteration.
+ * @param user_data The pointer given to checkers_engine_search().
+ */
+typedef void (*checkers_info_callback)(const checkers_info* info, void* user_data);
+
+/**
+ * @brief Get the version of the library, e.g. "1.0".
+ */
+CHECKERS_API const char* checkers_version(void);
+
+/**
+ * @brief Create an engine at the initial position.
+ *
+ * @param hash_kilobytes Size of its transposition table, 0 for CHECKERS_DEFAULT_HASH_KILOBYTES.
+ * @return The engine, or NULL if memory ran out.
+ */
+CHECKERS_API checkers_engine* checkers_engine_create(size_t hash_kilobytes);
+
+/**
+ * @brief Destroy an engine. Accepts NULL.
+ */
+CHECKERS_API void checkers_engine_destroy(checkers_engine* engine);
+
+/**
+ * @brief Get the memory used by an engine, its transposition table included.
+ */
+CHECKERS_API size_t checkers_engine_memory(const checkers_engine* engine);
+
+/**
+ * @brief Describe the last error of an engine.
+ *
+ * @return The message, empty if the last call succeeded; valid until the next call on the engine.
+ */
+CHECKERS_API const char* checkers_engine_error(const checkers_engine* engine);
+
+/**
+ * @brief Start a new game from a position.
+ *
+ * The positions played so far are forgotten; the transposition table is kept.
+ *
+ * @param engine The engine.
+ * @param position The position text, or NULL or "startpos" for the initial position.
+ * @return CHECKERS_OK or CHECKERS_INVALID_ARGUMENT.
+ */
+CHECKERS_API int checkers_engine_set_position(checkers_engine* engine, const char* position);
+
+/**
+ * @brief Write the current position as text.
+ *
+ * @param engine The engine.
+ * @param buffer Receives the text; CHECKERS_POSITION_TEXT bytes are always enough.
+ * @param size Size of the buffer.
+ * @return CHECKERS_OK, CHECKERS_INVALID_ARGUMENT or CHECKERS_BUFFER_TOO_SMALL.
+ */
+CHECKERS_API int checkers_engine_get_position(checkers_engine* engine, char* buffer, size_t size);
+
+/**
+ * @brief Tell whether white is to move.
+ *
+ * @return 1 for white, 0 for black, CHECKERS_INVALID_ARGUMENT for a NULL engine.
+ */
+CHECKERS_API int checkers_engine_white_to_move(const checkers_engine* engine);
+
+/**
+ * @brief Get the state of the game in the current position.
+ *
+ * @return A checkers_game_state, or CHECKERS_INVALID_ARGUMENT for a NULL engine.
+ */
+CHECKERS_API int checkers_engine_game_state(const checkers_engine* engine);
+
+/**
+ * @brief List the legal moves of the current position.
+ *
+ * @param engine The engine.
+ * @param moves Receives the moves; may be NULL to only count them.
+ * @param capacity Number of elements of moves; CHECKERS_MAX_MOVES is always enough.
+ * @return The number of legal moves, or a negative checkers_status.
+ */
+CHECKERS_API int checkers_engine_legal_moves(checkers_engine* engine, checkers_move* moves, int capacity);
+
+/**
+ * @brief Play a move.
+ *
+ * @param engine The engine.
+ * @param move The move in any notation listed by checkers_engine_legal_moves(), or a
+ * capture given by its start and end squares when that is unambiguous.
+ * @return CHECKERS_OK, CHECKERS_INVALID_ARGUMENT or CHECKERS_ILLEGAL_MOVE.
+ */
+CHECKERS_API int checkers_engine_apply_move(checkers_engine* engine, const char* move);
+
+/**
+ * @brief Search the current position without changing it.
+ *
+ * The search runs on the calling thread until a limit is reached or
+ * checkers_engine_stop() is called. Play the result with
+ * checkers_engine_apply_move().
+ *
+ * @param engine The engine.
+ * @param limits When to stop; NULL for a depth 10 search.
+ * @param callback Called after every finished iteration; may be NULL.
+ * @param user_data Passed to the callback.
+ * @param result Receives the outcome.
+ * @return CHECKERS_OK or a negative checkers_status.
+ */
+CHECKERS_API int checkers_engine_search(checkers_engine* engine, const checkers_limits* limits,
+    checkers_info_callback callback, void* user_data, checkers_result* result);
+
+/**
+ * @brief Ask a running search of an engine to stop as soon as possible.
+ *
+ * The only function that may be called while another thread uses the engine.
+ */
+CHECKERS_API void checkers_engine_stop(checkers_engine* engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,4 +1,5 @@
 #include "ComputerPlayer.h"
+#include "Trace.h"
 
 /**
  * @brief Constructor for ComputerPlayer class.
@@ -8,24 +9,65 @@
 ComputerPlayer::ComputerPlayer(bool whiteside) : Player() {
     this->whiteside = whiteside;
     this->humanPlayer = false;
+    search = new Search(DefaultHashMegabytes);
+}
+
+/**
+ * @brief Destructor for ComputerPlayer class.
+ */
+ComputerPlayer::~ComputerPlayer() {
+    if (!hashFile.empty()) {
+        try {
+            search->saveTable(hashFile);
+        }
+        catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+        }
+    }
+    delete search;
+}
+
+/**
+ * @brief Load the hash table from a file and remember the file for saving.
+ *
+ * @param path The file, which need not exist yet.
+ * @return True, the computer player always takes the file.
+ */
+bool ComputerPlayer::setHashFile(const std::string& path) {
+    hashFile = path;
+    try {
+        size_t entries = search->loadTable(path);
+        std::cout << getName() << " loaded " << entries << " hash entries from " << path << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << " Starting with an empty hash table." << std::endl;
+    }
+    return true;
 }
 
 /**
  * @brief Make a move on the board for the computer player.
  *
- * This function is not yet implemented and currently displays a message
- * indicating that the computer player's move is pending.
+ * The position is searched for the time given by the game clock, or a fixed
+ * time in untimed games, and the best move is applied to the board.
  *
  * @param board The game board on which the move will be made.
  * @param isWhitePlayerTurn True if it's the white player's turn, false otherwise.
  */
 void ComputerPlayer::makeMove(Board& board, bool isWhitePlayerTurn) {
-    // Display a message indicating that ComputerPlayer is not implemented yet
-    std::cout << "ComputerPlayer not implemented yet\n";
+    TRACE_SCOPE("computer move");
+    Position position = board.toPosition(isWhitePlayerTurn);
 
-    // Check if the player is not a human player, and exit the game if so
-    if (!humanPlayer) {
-        std::cout << "Exiting the game because the computer is the player." << std::endl;
-        std::exit(0);
+    SearchLimits limits;
+    limits.milliseconds = moveBudget > 0 ? moveBudget : DefaultMilliseconds;
+    SearchResult result = search->think(position, limits, nullptr, &board.getHistory());
+
+    if (!result.hasMove) {
+        std::cout << getName() << " has no legal move." << std::endl;
+        return;
     }
-}
\ No newline at end of file
+
+    board.applyMove(result.bestMove);
+    std::cout << getName() << " plays " << Position::moveToString(result.bestMove) << " (depth " << result.depth
+        << ", score " << result.score << ", " << result.nodes << " nodes)" << std::endl;
+}
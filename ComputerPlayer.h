@@ -2,16 +2,21 @@
 #define COMPUTERPLAYER_H
 
 #include "Player.h"
+#include "Search.h"
 #include <cstdlib>
 
 /**
  * @brief The ComputerPlayer class represents a computer player in a chess game.
  *
  * This class is a subclass of the Player class and is responsible for making
- * moves on the chess board automatically as the computer's turn.
+ * moves on the chess board automatically as the computer's turn, using the
+ * alpha-beta Search.
  */
 class ComputerPlayer : public Player {
 public:
+    static const int DefaultMilliseconds = 1000;      ///< Thinking time per move in untimed games.
+    static const size_t DefaultHashMegabytes = 32;    ///< Size of the transposition table.
+
     /**
      * @brief Constructor for the ComputerPlayer class.
      *
@@ -19,6 +24,11 @@ public:
      */
     ComputerPlayer(bool whiteside);
 
+    /**
+     * @brief Destructor for the ComputerPlayer class.
+     */
+    ~ComputerPlayer();
+
     /**
      * @brief Make a move on the chess board during the computer player's turn.
      *
@@ -29,6 +39,29 @@ public:
      * @param isWhitePlayerTurn Indicates whether it is the white player's turn.
      */
     virtual void makeMove(Board& board, bool isWhitePlayerTurn) override;
+
+    /**
+     * @brief Get the statistics of the searches of this game.
+     */
+    virtual const SearchStatistics* getStatistics() const override { return &search->getStatistics(); }
+
+    /**
+     * @brief Load the hash table from a file now and save it there in the destructor.
+     *
+     * A missing or incompatible file is reported and the player starts with an empty table.
+     *
+     * @return True.
+     */
+    virtual bool setHashFile(const std::string& path) override;
+
+    /**
+     * @brief Evaluate with an NNUE network from now on.
+     */
+    virtual void setNetwork(const NnueNetwork* network) override { search->setNetwork(network); }
+
+private:
+    Search* search; ///< The engine, kept between moves so its hash table stays warm.
+    std::string hashFile; ///< File the hash table is saved to, empty for none.
 };
 
-#endif
\ No newline at end of file
+#endif
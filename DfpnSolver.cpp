@@ -0,0 +1,331 @@
+#include "DfpnSolver.h"
+#include "MemoryAccounting.h"
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @file DfpnSolver.cpp
+ * @brief Implementation of the depth-first proof-number search solver.
+ */
+
+namespace {
+    const uint64_t AttackerSalt = 0x5BD1E9955BD1E995ull; // Separates the win and loss searches in the table
+
+    uint32_t clampNumber(uint64_t value) {
+        return value >= DfpnSolver::Infinity ? DfpnSolver::Infinity : static_cast<uint32_t>(value);
+    }
+
+    bool isSolved(const DfpnTable::Entry& entry) {
+        return entry.phi == 0 || entry.delta == 0;
+    }
+
+    /**
+     * @brief The PathNumbers struct holds the numbers of a child that depend on the current line.
+     */
+    struct PathNumbers {
+        int move;           ///< Index of the child's move.
+        uint32_t phi;       ///< Its proof number.
+        uint32_t delta;     ///< Its disproof number.
+    };
+}
+
+DfpnTable::DfpnTable(size_t bytes) : usedCount(0), collectionCount(0) {
+    size_t count = bytes / sizeof(Entry);
+    count -= count % BucketSize;
+    if (count < static_cast<size_t>(BucketSize)) {
+        count = BucketSize;
+    }
+
+    MemoryScope scope(MemoryTag::Search);
+    entries.assign(count, Entry());
+    bucketCount = count / BucketSize;
+}
+
+const DfpnTable::Entry* DfpnTable::find(uint64_t key) const {
+    const Entry* bucket = &entries[(key % bucketCount) * BucketSize];
+    for (int i = 0; i < BucketSize; i++) {
+        if (bucket[i].key == key) {
+            return &bucket[i];
+        }
+    }
+    return nullptr;
+}
+
+void DfpnTable::store(uint64_t key, uint32_t phi, uint32_t delta, uint32_t work) {
+    Entry* bucket = &entries[(key % bucketCount) * BucketSize];
+
+    for (int i = 0; i < BucketSize; i++) {
+        if (bucket[i].key == key) {
+            bucket[i].phi = phi;
+            bucket[i].delta = delta;
+            bucket[i].work = std::max(bucket[i].work, work);
+            return;
+        }
+    }
+
+    // The bucket is full: collect garbage once the whole table is nearly full
+    bool full = true;
+    for (int i = 0; i < BucketSize; i++) {
+        full = full && bucket[i].key != 0;
+    }
+    if (full && usedCount >= entries.size() * 3 / 4) {
+        collectGarbage();
+    }
+
+    // Take a free slot, otherwise replace the cheapest entry, preferring unsolved ones
+    Entry* victim = nullptr;
+    for (int i = 0; i < BucketSize; i++) {
+        Entry& entry = bucket[i];
+        if (entry.key == 0) {
+            victim = &entry;
+            usedCount++;
+            break;
+        }
+        if (victim == nullptr || (isSolved(*victim) && !isSolved(entry)) ||
+            (isSolved(*victim) == isSolved(entry) && entry.work < victim->work)) {
+            victim = &entry;
+        }
+    }
+
+    victim->key = key;
+    victim->phi = phi;
+    victim->delta = delta;
+    victim->work = work;
+}
+
+void DfpnTable::collectGarbage() {
+    collectionCount++;
+
+    size_t target = entries.size() / 4;
+    size_t freed = 0;
+
+    // Drop unsolved entries with less and less work until a quarter of the table is free
+    for (uint32_t threshold = 1; freed < target; threshold = threshold < 0x80000000u ? threshold * 2 : UINT32_MAX) {
+        bool remaining = false;
+        for (Entry& entry : entries) {
+            if (entry.key == 0 || isSolved(entry)) {
+                continue;
+            }
+            if (entry.work <= threshold) {
+                entry = Entry();
+                freed++;
+            }
+            else {
+                remaining = true;
+            }
+        }
+        if (!remaining || threshold == UINT32_MAX) {
+            break;
+        }
+    }
+
+    usedCount -= freed;
+}
+
+DfpnSolver::DfpnSolver(size_t memoryBytes)
+    : table(memoryBytes), attackerWhite(true), nodes(0), nodeLimit(0), aborted(false) {}
+
+const char* DfpnSolver::outcomeName(Outcome outcome) {
+    switch (outcome) {
+    case Win:
+        return "win";
+    case Loss:
+        return "loss";
+    default:
+        return "unknown";
+    }
+}
+
+DfpnSolver::Result DfpnSolver::solve(const Position& root, long long maxNodes) {
+    auto start = std::chrono::steady_clock::now();
+    Result result;
+    result.outcome = Unknown;
+
+    nodes = 0;
+    nodeLimit = maxNodes;
+
+    if (prove(root, root.whiteToMove)) {
+        result.outcome = Win;
+        result.line = provingLine(root);
+    }
+    else if (prove(root, !root.whiteToMove)) {
+        result.outcome = Loss;
+        result.line = provingLine(root);
+    }
+
+    result.nodes = nodes;
+    result.collections = table.collections();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+uint64_t DfpnSolver::keyOf(const Position& position) const {
+    uint64_t key = position.hashKey() ^ (attackerWhite ? AttackerSalt : 0);
+    return key != 0 ? key : 1;
+}
+
+void DfpnSolver::lookup(const Position& position, uint32_t& phi, uint32_t& delta) const {
+    const DfpnTable::Entry* entry = table.find(keyOf(position));
+    phi = entry != nullptr ? entry->phi : 1;
+    delta = entry != nullptr ? entry->delta : 1;
+}
+
+bool DfpnSolver::prove(const Position& root, bool whiteWins) {
+    attackerWhite = whiteWins;
+    aborted = false;
+    path.clear();
+
+    Position position = root;
+    uint32_t phi, delta;
+    mid(position, Infinity, Infinity, 0, phi, delta);
+    // At the root the attacker is either to move (needs phi == 0) or defending against it (delta == 0)
+    return root.whiteToMove == whiteWins ? phi == 0 : delta == 0;
+}
+
+bool DfpnSolver::mid(Position& position, uint32_t thresholdPhi, uint32_t thresholdDelta, int ply, uint32_t& phi, uint32_t& delta) {
+    uint64_t key = keyOf(position);
+    long long startNodes = nodes++;
+    bool attackerToMove = position.whiteToMove == attackerWhite;
+
+    if (nodes >= nodeLimit) {
+        aborted = true;
+        lookup(position, phi, delta);
+        return false;
+    }
+
+    // A repetition or an overlong line is a failure for the attacker on this line only, so it is not stored:
+    // the same position reached by another line may well be won (the graph history interaction)
+    if (ply >= MaxPly || std::find(path.begin(), path.end(), key) != path.end()) {
+        phi = attackerToMove ? Infinity : 0;
+        delta = attackerToMove ? 0 : Infinity;
+        return true;
+    }
+
+    MoveList list;
+    position.generateMoves(list);
+
+    // The side to move has no pieces or is blocked, and loses
+    if (list.count == 0) {
+        phi = Infinity;
+        delta = 0;
+        table.store(key, phi, delta, 1);
+        return false;
+    }
+
+    path.push_back(key);
+    std::vector<PathNumbers> pathChildren; // Children whose numbers depend on the line, absent from the table
+
+    while (true) {
+        // phi is the smallest child delta, delta the sum of the child phis
+        phi = Infinity;
+        uint64_t sum = 0;
+        uint32_t secondDelta = Infinity;
+        uint32_t bestPhi = 0;
+        int best = 0;
+
+        for (int i = 0; i < list.count; i++) {
+            uint32_t childPhi, childDelta;
+            auto known = std::find_if(pathChildren.begin(), pathChildren.end(), [i](const PathNumbers& child) { return child.move == i; });
+            if (known != pathChildren.end()) {
+                childPhi = known->phi;
+                childDelta = known->delta;
+            }
+            else {
+                position.makeMove(list[i]);
+                lookup(position, childPhi, childDelta);
+                position.unmakeMove(list[i]);
+            }
+
+            if (childDelta < phi) {
+                secondDelta = phi;
+                phi = childDelta;
+                bestPhi = childPhi;
+                best = i;
+            }
+            else if (childDelta < secondDelta) {
+                secondDelta = childDelta;
+            }
+            sum += childPhi;
+        }
+
+        delta = clampNumber(sum);
+        if (phi >= thresholdPhi || delta >= thresholdDelta || aborted) {
+            break;
+        }
+
+        // Thresholds of the most proving child, with the 1 + epsilon trick against thrashing
+        uint32_t childPhi = clampNumber(static_cast<uint64_t>(thresholdDelta) + bestPhi - delta);
+        uint64_t widened = std::max<uint64_t>(static_cast<uint64_t>(secondDelta) + 1, static_cast<uint64_t>(secondDelta) * 5 / 4);
+        uint32_t childDelta = std::min(thresholdPhi, clampNumber(widened));
+
+        uint32_t searchedPhi, searchedDelta;
+        position.makeMove(list[best]);
+        bool onPath = mid(position, childPhi, childDelta, ply + 1, searchedPhi, searchedDelta);
+        position.unmakeMove(list[best]);
+
+        auto known = std::find_if(pathChildren.begin(), pathChildren.end(), [best](const PathNumbers& child) { return child.move == best; });
+        if (known != pathChildren.end()) {
+            pathChildren.erase(known);
+        }
+        if (onPath) {
+            PathNumbers child = { best, searchedPhi, searchedDelta };
+            pathChildren.push_back(child);
+        }
+    }
+
+    path.pop_back();
+
+    // Proofs never rely on a repetition, but a failure of the attacker may; such a failure is only valid on this line
+    bool attackerFailed = attackerToMove ? delta == 0 : phi == 0;
+    if (attackerFailed && !pathChildren.empty()) {
+        return true;
+    }
+    uint64_t work = static_cast<uint64_t>(nodes - startNodes);
+    table.store(key, phi, delta, work > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(work));
+    return false;
+}
+
+std::vector<BoardMove> DfpnSolver::provingLine(Position position) {
+    std::vector<BoardMove> line;
+
+    for (int ply = 0; ply < MaxPly; ply++) {
+        MoveList list;
+        position.generateMoves(list);
+        if (list.count == 0) {
+            break;
+        }
+
+        bool attackerToMove = position.whiteToMove == attackerWhite;
+        int chosen = -1;
+        uint32_t longest = 0;
+
+        for (int i = 0; i < list.count; i++) {
+            position.makeMove(list[i]);
+            const DfpnTable::Entry* entry = table.find(keyOf(position));
+            position.unmakeMove(list[i]);
+
+            if (entry == nullptr) {
+                continue;
+            }
+            if (attackerToMove && entry->delta == 0) {
+                // A move that leaves the defender lost
+                chosen = i;
+                break;
+            }
+            if (!attackerToMove && entry->phi == 0 && (chosen < 0 || entry->work > longest)) {
+                // The defence that holds out longest
+                chosen = i;
+                longest = entry->work;
+            }
+        }
+
+        if (chosen < 0) {
+            break;
+        }
+
+        line.push_back(list[chosen]);
+        position.makeMove(list[chosen]);
+    }
+
+    return line;
+}
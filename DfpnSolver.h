@@ -0,0 +1,186 @@
+#ifndef DFPNSOLVER_H
+#define DFPNSOLVER_H
+
+#include <cstdint>
+#include <vector>
+#include "Position.h"
+
+/**
+ * @brief The DfpnTable class is the proof/disproof number table of the solver.
+ *
+ * Entries are grouped in buckets of four. When a bucket has no free slot the
+ * table is garbage collected: unsolved entries backed by little search work are
+ * dropped until a quarter of the table is free, so the solver stays inside its
+ * memory budget however long it runs. Solved entries are kept so that the
+ * proving line can be read back at the end.
+ */
+class DfpnTable {
+public:
+    /**
+     * @brief The Entry struct stores the numbers of one position.
+     */
+    struct Entry {
+        uint64_t key;    ///< Position hash, 0 for an empty slot.
+        uint32_t phi;    ///< Proof number for the side to move at this position.
+        uint32_t delta;  ///< Disproof number for the side to move at this position.
+        uint32_t work;   ///< Nodes searched below this position, used by the garbage collector.
+    };
+
+    static const int BucketSize = 4; ///< Entries per bucket.
+
+    /**
+     * @brief Constructor for the DfpnTable class.
+     *
+     * @param bytes Memory budget of the table.
+     */
+    explicit DfpnTable(size_t bytes);
+
+    /**
+     * @brief Look up a position.
+     *
+     * @param key The position hash.
+     * @return Pointer to the entry, or nullptr if the position is not stored.
+     */
+    const Entry* find(uint64_t key) const;
+
+    /**
+     * @brief Store the numbers of a position.
+     *
+     * @param key The position hash.
+     * @param phi The proof number.
+     * @param delta The disproof number.
+     * @param work Nodes searched below the position.
+     */
+    void store(uint64_t key, uint32_t phi, uint32_t delta, uint32_t work);
+
+    /**
+     * @brief Get the number of garbage collections run so far.
+     *
+     * @return The number of collections.
+     */
+    int collections() const { return collectionCount; }
+
+    /**
+     * @brief Get the number of entries in use.
+     *
+     * @return The number of stored positions.
+     */
+    size_t used() const { return usedCount; }
+
+    /**
+     * @brief Get the number of entries the table can hold.
+     *
+     * @return The capacity.
+     */
+    size_t capacity() const { return entries.size(); }
+
+private:
+    std::vector<Entry> entries;   ///< Table storage.
+    size_t bucketCount;           ///< Number of buckets.
+    size_t usedCount;             ///< Entries in use.
+    int collectionCount;          ///< Garbage collections run.
+
+    /**
+     * @brief Free a quarter of the table, starting with the cheapest unsolved entries.
+     */
+    void collectGarbage();
+};
+
+/**
+ * @brief The DfpnSolver class proves wins and losses with depth-first proof-number search.
+ *
+ * The solver answers whether the side to move in a position wins, loses or
+ * whether that is unknown within the node and memory budget. Moves come from
+ * Position::generateMoves, so the compulsory and maximum capture rules of
+ * countCapturingMoves apply. A repetition on the current line or a line longer
+ * than MaxPly counts as a failure for the side trying to win; proofs therefore
+ * never rely on them and a reported win or loss is exact. Such failures hold
+ * only on the line that led to them, so they and the failures that rest on
+ * them are passed up the line instead of being stored in the table, where a
+ * transposition reached by another line would take them for its own.
+ */
+class DfpnSolver {
+public:
+    static const uint32_t Infinity = 100000000;  ///< Proof number of a disproved node.
+    static const int MaxPly = 160;               ///< Lines longer than this are not followed.
+
+    /**
+     * @brief The Outcome enum lists the possible answers of the solver.
+     */
+    enum Outcome { Win, Loss, Unknown };
+
+    /**
+     * @brief The Result struct holds the answer of the solver.
+     */
+    struct Result {
+        Outcome outcome;              ///< Result for the side to move.
+        std::vector<BoardMove> line;  ///< Proving line when the outcome is known.
+        long long nodes;              ///< Nodes searched.
+        int collections;              ///< Garbage collections of the table.
+        double seconds;               ///< Wall time.
+    };
+
+    /**
+     * @brief Constructor for the DfpnSolver class.
+     *
+     * @param memoryBytes Memory budget of the proof number table.
+     */
+    explicit DfpnSolver(size_t memoryBytes);
+
+    /**
+     * @brief Solve a position.
+     *
+     * @param root The position to solve.
+     * @param maxNodes Node budget shared by the win and the loss search.
+     * @return The outcome and the proving line.
+     */
+    Result solve(const Position& root, long long maxNodes);
+
+    /**
+     * @brief Get the name of an outcome.
+     *
+     * @param outcome The outcome.
+     * @return "win", "loss" or "unknown".
+     */
+    static const char* outcomeName(Outcome outcome);
+
+private:
+    DfpnTable table;                 ///< Proof and disproof numbers.
+    bool attackerWhite;              ///< Colour trying to win in the current search.
+    long long nodes;                 ///< Nodes searched.
+    long long nodeLimit;             ///< Node budget.
+    bool aborted;                    ///< True once the budget is exhausted.
+    std::vector<uint64_t> path;      ///< Hashes of the positions on the current line.
+
+    /**
+     * @brief Get the table key of a position for the current attacker.
+     */
+    uint64_t keyOf(const Position& position) const;
+
+    /**
+     * @brief Look up the numbers of a position, defaulting to 1 and 1.
+     */
+    void lookup(const Position& position, uint32_t& phi, uint32_t& delta) const;
+
+    /**
+     * @brief Multiple iterative deepening step of df-pn.
+     *
+     * @param phi Receives the proof number of the position.
+     * @param delta Receives its disproof number.
+     * @return True if the numbers hold only on the current line, because the attacker failed through a
+     *         repetition or the ply limit; they are then not stored in the table.
+     */
+    bool mid(Position& position, uint32_t thresholdPhi, uint32_t thresholdDelta, int ply, uint32_t& phi, uint32_t& delta);
+
+    /**
+     * @brief Try to prove that the given colour wins from the root.
+     */
+    bool prove(const Position& root, bool whiteWins);
+
+    /**
+     * @brief Read the proving line out of the table after a successful proof.
+     */
+    std::vector<BoardMove> provingLine(Position position);
+};
+
+#endif
@@ -0,0 +1,25 @@
+#include "DrawState.h"
+#include <iostream>
+
+/**
+ * @brief Constructor for the DrawState class.
+ *
+ * @param reason The rule that ended the game.
+ * @param moveLimit Moves per side allowed without a capture or a pawn move.
+ */
+DrawState::DrawState(Reason reason, int moveLimit) : reason(reason), moveLimit(moveLimit) {}
+
+/**
+ * @brief Display the state of the game.
+ *
+ * This function prints a message indicating that the game is drawn and why.
+ */
+void DrawState::displayState() {
+    if (reason == Repetition) {
+        std::cout << "Draw by threefold repetition." << std::endl;
+    }
+    else {
+        std::cout << "Draw: " << moveLimit << " moves by each side without a capture or a pawn move." << std::endl;
+    }
+    std::cout << "Game Over!" << std::endl;
+}
@@ -0,0 +1,40 @@
+#ifndef DRAWSTATE_HPP
+#define DRAWSTATE_HPP
+
+#include "GameState.h"
+
+/**
+ * @brief The DrawState class represents the game state when the game ended in a draw.
+ *
+ * This class is a subclass of the GameState class and is responsible for displaying
+ * why the game was drawn.
+ */
+class DrawState : public GameState {
+public:
+    /**
+     * @brief The rule that ended the game.
+     */
+    enum Reason {
+        Repetition,  ///< The same position occurred three times.
+        MoveLimit    ///< Too many moves without a capture or a pawn move.
+    };
+
+    /**
+     * @brief Constructor for the DrawState class.
+     *
+     * @param reason The rule that ended the game.
+     * @param moveLimit Moves per side allowed without a capture or a pawn move.
+     */
+    DrawState(Reason reason, int moveLimit);
+
+    /**
+     * @brief Display the state of the game when it is drawn.
+     */
+    void displayState() override;
+
+private:
+    Reason reason;  ///< The rule that ended the game.
+    int moveLimit;  ///< Moves per side allowed without a capture or a pawn move.
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "DxpEventLoop.h"
+#include <iomanip>
+
+/**
+ * @file DxpEventLoop.cpp
+ * @brief Implementation of the DXP event loop.
+ */
+
+namespace {
+    const int IdleMilliseconds = 100;       ///< Poll timeout when no game is thinking.
+    const int ThinkingMilliseconds = 2;     ///< Poll timeout while a search may finish.
+}
+
+DxpEventLoop::DxpEventLoop(const DxpSettings& settings)
+    : settings(settings), listener(Socket::Invalid), gamesStarted(0), gamesFinished(0) {}
+
+DxpEventLoop::~DxpEventLoop() {
+    for (DxpSession* session : sessions) {
+        delete session;
+    }
+    if (listener != Socket::Invalid) {
+        Socket::close(listener);
+    }
+}
+
+int DxpEventLoop::listen(int port) {
+    listener = Socket::listen(port);
+    return Socket::localPort(listener);
+}
+
+void DxpEventLoop::connect(const std::string& host, int port, int games) {
+    for (int i = 0; i < games; i++) {
+        sessions.push_back(new DxpSession(Socket::connect(host, port), true, settings, gamesStarted++));
+    }
+}
+
+void DxpEventLoop::run(int games) {
+    std::vector<Socket::PollEntry> entries;
+
+    while (games == 0 ? (listener != Socket::Invalid || !sessions.empty()) : gamesFinished < games) {
+        entries.clear();
+        bool thinking = false;
+
+        if (listener != Socket::Invalid) {
+            Socket::PollEntry entry = {};
+            entry.fd = listener;
+            entry.events = POLLIN;
+            entries.push_back(entry);
+        }
+        for (DxpSession* session : sessions) {
+            Socket::PollEntry entry = {};
+            entry.fd = session->socket;
+            entry.events = POLLIN;
+            if (!session->connected || !session->output.empty()) {
+                entry.events |= POLLOUT;
+            }
+            entries.push_back(entry);
+            thinking = thinking || session->isThinking();
+        }
+
+        Socket::poll(entries, thinking ? ThinkingMilliseconds : IdleMilliseconds);
+        std::chrono::steady_clock::time_point woken = std::chrono::steady_clock::now();
+
+        size_t first = 0;
+        if (listener != Socket::Invalid) {
+            first = 1;
+            if (entries[0].revents & POLLIN) {
+                Socket::Handle connection;
+                while ((connection = Socket::accept(listener)) != Socket::Invalid) {
+                    sessions.push_back(new DxpSession(connection, false, settings, gamesStarted++));
+                }
+            }
+        }
+
+        // Sessions accepted above are not in the poll entries yet and wait for the next round
+        size_t polled = entries.size() - first;
+        for (size_t i = polled; i-- > 0;) {
+            DxpSession& session = *sessions[i];
+            if (!serve(session, entries[first + i].revents, woken)) {
+                close(i);
+            }
+        }
+    }
+}
+
+bool DxpEventLoop::serve(DxpSession& session, short events, std::chrono::steady_clock::time_point woken) {
+    if (events & (POLLERR | POLLNVAL)) {
+        return false;
+    }
+    if (!session.connected) {
+        if (!(events & POLLOUT)) {
+            return true;
+        }
+        session.start();
+    }
+
+    bool open = true;
+    if (events & (POLLIN | POLLHUP)) {
+        open = Socket::receive(session.socket, session.input);
+
+        size_t end;
+        while ((end = session.input.find('\0')) != std::string::npos) {
+            std::string text = session.input.substr(0, end);
+            session.input.erase(0, end + 1);
+
+            try {
+                DxpMessage message = DxpMessage::decode(text);
+                session.receive(message, statistics);
+                if (!Socket::send(session.socket, session.output)) {
+                    return false;
+                }
+
+                std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - woken;
+                statistics.handling[static_cast<unsigned char>(message.type)].add(elapsed.count());
+            }
+            catch (const std::exception& e) {
+                std::cout << e.what() << std::endl;
+            }
+        }
+    }
+
+    session.update();
+    if (!Socket::send(session.socket, session.output)) {
+        return false;
+    }
+
+    if (session.closing && session.output.empty()) {
+        return false;
+    }
+    return open;
+}
+
+void DxpEventLoop::close(size_t index) {
+    sessions[index]->finish(statistics);
+    delete sessions[index];
+    sessions.erase(sessions.begin() + index);
+    gamesFinished++;
+}
+
+void DxpEventLoop::printStatistics(std::ostream& out) const {
+    out << "Games: " << gamesFinished << " (" << statistics.wins << " won, " << statistics.losses << " lost, "
+        << statistics.draws << " drawn, " << statistics.unfinished << " unfinished)" << std::endl;
+
+    out << "Message   handled   mean us    max us   answered  mean ms    max ms" << std::endl;
+    const char types[] = { DxpMessage::GameRequest, DxpMessage::GameAccept, DxpMessage::Move, DxpMessage::GameEnd,
+        DxpMessage::Chat, DxpMessage::BackRequest, DxpMessage::BackAccept };
+    for (char type : types) {
+        const DxpLatency& handling = statistics.handling[static_cast<unsigned char>(type)];
+        const DxpLatency& roundTrip = statistics.roundTrip[static_cast<unsigned char>(type)];
+        if (handling.count == 0 && roundTrip.count == 0) {
+            continue;
+        }
+
+        out << std::fixed << std::setprecision(1) << "   " << type
+            << std::setw(14) << handling.count
+            << std::setw(10) << (handling.count > 0 ? handling.total / handling.count : 0.0)
+            << std::setw(10) << handling.maximum
+            << std::setw(11) << roundTrip.count
+            << std::setw(9) << (roundTrip.count > 0 ? roundTrip.total / roundTrip.count / 1000.0 : 0.0)
+            << std::setw(10) << roundTrip.maximum / 1000.0 << std::endl;
+    }
+    out << std::defaultfloat;
+}
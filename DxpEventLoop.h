@@ -0,0 +1,84 @@
+#ifndef DXPEVENTLOOP_H
+#define DXPEVENTLOOP_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DxpSession.h"
+#include "Socket.h"
+
+/**
+ * @brief The DxpEventLoop class serves any number of DXP games from one thread.
+ *
+ * All sockets are non-blocking and multiplexed with poll(), so a server can
+ * host many concurrent matches and a client can open many games at once.
+ * Searches run on their own threads (see DxpSession); while any game is
+ * thinking the loop wakes up every few milliseconds to pick up finished moves.
+ */
+class DxpEventLoop {
+public:
+    /**
+     * @brief Constructor for the DxpEventLoop class.
+     *
+     * @param settings Local engine settings used by every game.
+     */
+    explicit DxpEventLoop(const DxpSettings& settings);
+
+    /**
+     * @brief Destructor for the DxpEventLoop class, closes all connections.
+     */
+    ~DxpEventLoop();
+
+    /**
+     * @brief Accept games from other programs.
+     *
+     * @param port TCP port, 0 to let the system choose.
+     * @return The port actually used.
+     */
+    int listen(int port);
+
+    /**
+     * @brief Open connections that each request one game.
+     *
+     * @param host Host of the server.
+     * @param port Port of the server.
+     * @param games Number of concurrent games.
+     */
+    void connect(const std::string& host, int port, int games);
+
+    /**
+     * @brief Run until the requested number of games finished.
+     *
+     * @param games Games to finish; 0 runs until all outgoing games are over, or forever when listening.
+     */
+    void run(int games);
+
+    /**
+     * @brief Print the results and the per-message latency tables.
+     *
+     * @param out The stream to print to.
+     */
+    void printStatistics(std::ostream& out) const;
+
+private:
+    DxpSettings settings;                   ///< Local engine settings.
+    Socket::Handle listener;                ///< Listening socket, Invalid when not serving.
+    std::vector<DxpSession*> sessions;      ///< Open games.
+    DxpStatistics statistics;               ///< Results and latencies.
+    int gamesStarted;                       ///< Games created so far, used to number them.
+    int gamesFinished;                      ///< Games whose connection has closed.
+
+    /**
+     * @brief Read, dispatch and answer the messages of one session.
+     *
+     * @return False if the connection failed or was closed by the peer.
+     */
+    bool serve(DxpSession& session, short events, std::chrono::steady_clock::time_point woken);
+
+    /**
+     * @brief Close a session and record its result.
+     */
+    void close(size_t index);
+};
+
+#endif
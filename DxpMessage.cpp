@@ -0,0 +1,235 @@
+#include "DxpMessage.h"
+#include <stdexcept>
+
+/**
+ * @file DxpMessage.cpp
+ * @brief Implementation of DXP message encoding and decoding.
+ */
+
+namespace {
+    const int NameWidth = 32;
+
+    std::string number(int value, int width) {
+        std::string text = std::to_string(value);
+        if (static_cast<int>(text.size()) > width || value < 0) {
+            throw std::runtime_error("DXP field " + text + " does not fit in " + std::to_string(width) + " digits.");
+        }
+        return std::string(width - text.size(), '0') + text;
+    }
+
+    std::string padded(const std::string& text, int width) {
+        std::string field = text.substr(0, width);
+        return field + std::string(width - field.size(), ' ');
+    }
+
+    /**
+     * @brief Reads fixed-width fields from a message and reports truncation.
+     */
+    class FieldReader {
+    public:
+        explicit FieldReader(const std::string& text) : text(text), offset(1) {}
+
+        std::string take(int width) {
+            if (offset + width > text.size()) {
+                throw std::runtime_error("Truncated DXP message: " + text);
+            }
+            std::string field = text.substr(offset, width);
+            offset += width;
+            return field;
+        }
+
+        int number(int width) {
+            std::string field = take(width);
+            int value = 0;
+            for (char c : field) {
+                if (c < '0' || c > '9') {
+                    throw std::runtime_error("Bad number in DXP message: " + text);
+                }
+                value = value * 10 + (c - '0');
+            }
+            return value;
+        }
+
+        char character() {
+            return take(1)[0];
+        }
+
+        std::string rest() {
+            std::string field = offset < text.size() ? text.substr(offset) : std::string();
+            offset = text.size();
+            return field;
+        }
+
+    private:
+        const std::string& text;
+        size_t offset;
+    };
+
+    std::string trimmed(const std::string& text) {
+        size_t end = text.find_last_not_of(' ');
+        return end == std::string::npos ? std::string() : text.substr(0, end + 1);
+    }
+
+    int squareNumber(int square) {
+        if (square < 1 || square > 32) {
+            throw std::runtime_error("Bad square " + std::to_string(square) + " in DXP message.");
+        }
+        return square;
+    }
+}
+
+DxpMessage DxpMessage::fromMove(const BoardMove& move, int seconds) {
+    DxpMessage message;
+    message.type = Move;
+    message.seconds = seconds;
+    message.from = move.from + 1;
+    message.to = move.to + 1;
+
+    uint32_t captured = move.captured;
+    while (captured != 0) {
+        int square = lowestBit(captured);
+        captured &= captured - 1;
+        message.captured.push_back(square + 1);
+    }
+    return message;
+}
+
+bool DxpMessage::toMove(const Position& position, BoardMove& move) const {
+    uint32_t capturedMask = 0;
+    for (int square : captured) {
+        capturedMask |= 1u << (square - 1);
+    }
+
+    MoveList list;
+    position.generateMoves(list);
+    for (int i = 0; i < list.count; i++) {
+        if (list[i].from + 1 == from && list[i].to + 1 == to && list[i].captured == capturedMask) {
+            move = list[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string DxpMessage::encode() const {
+    std::string text(1, type);
+
+    switch (type) {
+    case GameRequest:
+        text += "01" + padded(name, NameWidth) + (followerWhite ? 'W' : 'Z') + number(minutes, 3) + number(moves, 3);
+        if (!customPosition) {
+            text += 'A';
+        }
+        else {
+            text += 'B';
+            text += position.whiteToMove ? 'W' : 'Z';
+            for (int square = 0; square < 32; square++) {
+                uint32_t bit = 1u << square;
+                char piece = (position.white & bit) ? 'w' : (position.black & bit) ? 'z' : 'e';
+                if (position.kings & bit) {
+                    piece = static_cast<char>(piece - 'a' + 'A');
+                }
+                text += piece;
+            }
+        }
+        break;
+    case GameAccept:
+        text += padded(name, NameWidth) + code;
+        break;
+    case Move:
+        text += number(seconds, 4) + number(from, 2) + number(to, 2) + number(static_cast<int>(captured.size()), 2);
+        for (int square : captured) {
+            text += number(square, 2);
+        }
+        break;
+    case GameEnd:
+        text += code;
+        text += stopCode;
+        break;
+    case Chat:
+        text += this->text;
+        break;
+    case BackRequest:
+        text += number(moveNumber, 3) + (followerWhite ? 'W' : 'Z');
+        break;
+    case BackAccept:
+        text += code;
+        break;
+    default:
+        throw std::runtime_error(std::string("Unknown DXP message type ") + type + ".");
+    }
+
+    return text;
+}
+
+DxpMessage DxpMessage::decode(const std::string& text) {
+    if (text.empty()) {
+        throw std::runtime_error("Empty DXP message.");
+    }
+
+    DxpMessage message;
+    message.type = text[0];
+    FieldReader reader(text);
+
+    switch (message.type) {
+    case GameRequest: {
+        reader.take(2); // Protocol version
+        message.name = trimmed(reader.take(NameWidth));
+        message.followerWhite = reader.character() == 'W';
+        message.minutes = reader.number(3);
+        message.moves = reader.number(3);
+        message.customPosition = reader.character() == 'B';
+        if (!message.customPosition) {
+            message.position = Position::initial();
+            break;
+        }
+
+        message.position.whiteToMove = reader.character() == 'W';
+        std::string board = reader.take(32);
+        for (int square = 0; square < 32; square++) {
+            uint32_t bit = 1u << square;
+            switch (board[square]) {
+            case 'w': message.position.white |= bit; break;
+            case 'z': message.position.black |= bit; break;
+            case 'W': message.position.white |= bit; message.position.kings |= bit; break;
+            case 'Z': message.position.black |= bit; message.position.kings |= bit; break;
+            case 'e': break;
+            default: throw std::runtime_error("Bad board in DXP game request: " + text);
+            }
+        }
+        break;
+    }
+    case GameAccept:
+        message.name = trimmed(reader.take(NameWidth));
+        message.code = reader.character();
+        break;
+    case Move: {
+        message.seconds = reader.number(4);
+        message.from = squareNumber(reader.number(2));
+        message.to = squareNumber(reader.number(2));
+        int count = reader.number(2);
+        for (int i = 0; i < count; i++) {
+            message.captured.push_back(squareNumber(reader.number(2)));
+        }
+        break;
+    }
+    case GameEnd:
+        message.code = reader.character();
+        message.stopCode = reader.character();
+        break;
+    case Chat:
+        message.text = reader.rest();
+        break;
+    case BackRequest:
+        message.moveNumber = reader.number(3);
+        message.followerWhite = reader.character() == 'W';
+        break;
+    case BackAccept:
+        message.code = reader.character();
+        break;
+    default:
+        throw std::runtime_error("Unknown DXP message: " + text);
+    }
+
+    return message;
+}
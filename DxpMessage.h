@@ -0,0 +1,94 @@
+#ifndef DXPMESSAGE_H
+#define DXPMESSAGE_H
+
+#include <string>
+#include <vector>
+#include "Position.h"
+
+/**
+ * @brief The DxpMessage struct is one message of the DXP (Draughts eXchange Protocol).
+ *
+ * DXP messages are ASCII strings of fixed-width fields terminated by a zero
+ * byte; the first character is the message type. The field layout follows the
+ * DXP specification, but squares are the 1-32 numbers of Position (the board
+ * in a GAMEREQ is 32 characters instead of 50) because this game is played on
+ * an 8x8 board. Colours are 'W' for white and 'Z' (zwart) for black.
+ *
+ * Messages:
+ * - GAMEREQ `R`: version, initiator name, follower colour, minutes, moves, start position.
+ * - GAMEACC `A`: follower name, acceptance code.
+ * - MOVE `M`: seconds used, from square, to square, captured squares.
+ * - GAMEEND `E`: reason, stop code.
+ * - CHAT `C`: free text.
+ * - BACKREQ `B` / BACKACC `K`: take-back request and answer.
+ */
+struct DxpMessage {
+    static const char GameRequest = 'R';
+    static const char GameAccept = 'A';
+    static const char Move = 'M';
+    static const char GameEnd = 'E';
+    static const char Chat = 'C';
+    static const char BackRequest = 'B';
+    static const char BackAccept = 'K';
+
+    static const char Accepted = '0';       ///< GAMEACC: the game is accepted.
+    static const char Refused = '9';        ///< GAMEACC: the game is refused.
+
+    static const char EndUnknown = '0';     ///< GAMEEND reason: no result.
+    static const char EndILose = '1';       ///< GAMEEND reason: the sender lost.
+    static const char EndDraw = '2';        ///< GAMEEND reason: draw.
+    static const char EndIWin = '3';        ///< GAMEEND reason: the sender won.
+
+    char type = Chat;                       ///< Message type.
+    std::string name;                       ///< GAMEREQ/GAMEACC: program name.
+    bool followerWhite = false;             ///< GAMEREQ: colour of the follower.
+    int minutes = 0;                        ///< GAMEREQ: thinking time.
+    int moves = 0;                          ///< GAMEREQ: moves in the thinking time.
+    bool customPosition = false;            ///< GAMEREQ: true if position is not the start position.
+    Position position;                      ///< GAMEREQ: start position.
+    char code = '0';                        ///< GAMEACC acceptance code, GAMEEND reason or BACKACC code.
+    char stopCode = '0';                    ///< GAMEEND: '0' another game is welcome, '1' not.
+    int seconds = 0;                        ///< MOVE: time used for the move.
+    int from = 0;                           ///< MOVE: from square, 1-32.
+    int to = 0;                             ///< MOVE: to square, 1-32.
+    std::vector<int> captured;              ///< MOVE: captured squares, 1-32.
+    int moveNumber = 0;                     ///< BACKREQ: move to go back to.
+    std::string text;                       ///< CHAT: text.
+
+    /**
+     * @brief Create a MOVE message for an engine move.
+     *
+     * @param move The move.
+     * @param seconds Time used for the move.
+     * @return The message.
+     */
+    static DxpMessage fromMove(const BoardMove& move, int seconds);
+
+    /**
+     * @brief Find the legal move a MOVE message describes.
+     *
+     * @param position The position the move is played in.
+     * @param move Receives the move.
+     * @return False if no legal move has these squares.
+     */
+    bool toMove(const Position& position, BoardMove& move) const;
+
+    /**
+     * @brief Encode the message without the terminating zero byte.
+     *
+     * @return The message text.
+     */
+    std::string encode() const;
+
+    /**
+     * @brief Parse a message without the terminating zero byte.
+     *
+     * Throws std::runtime_error for an unknown type or malformed fields.
+     *
+     * @param text The message text.
+     * @return The message.
+     */
+    static DxpMessage decode(const std::string& text);
+};
+
+#endif
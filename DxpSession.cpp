@@ -0,0 +1,263 @@
+#include "DxpSession.h"
+#include "Telemetry.h"
+#include <iostream>
+
+/**
+ * @file DxpSession.cpp
+ * @brief Implementation of one DXP game.
+ */
+
+namespace {
+    /**
+     * @brief Turn a GAMEEND reason of the other side into the local side's view.
+     */
+    char mirrorReason(char reason) {
+        if (reason == DxpMessage::EndILose) {
+            return DxpMessage::EndIWin;
+        }
+        if (reason == DxpMessage::EndIWin) {
+            return DxpMessage::EndILose;
+        }
+        return reason;
+    }
+
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}
+
+DxpSession::DxpSession(Socket::Handle socket, bool initiator, const DxpSettings& settings, int game)
+    : socket(socket), connected(!initiator), closing(false), settings(settings), initiator(initiator), game(game),
+    started(false), localWhite(true), position(Position::initial()), plies(0), result(DxpMessage::EndUnknown),
+    endSent(false), endReceived(false), search(nullptr), thinking(false), random(0x9E3779B9u + 7919u * static_cast<uint32_t>(game)),
+    awaiting(0) {
+    if (settings.milliseconds > 0) {
+        search = new Search(settings.hashMegabytes);
+    }
+    history.setMoveLimit(settings.moveLimit);
+    history.reset(position.hashKey());
+}
+
+DxpSession::~DxpSession() {
+    if (thinking) {
+        // Random moves are ready at once and have no search to stop
+        if (search != nullptr) {
+            search->stop();
+        }
+        pendingMove.wait();
+    }
+    delete search;
+    Socket::close(socket);
+}
+
+void DxpSession::start() {
+    connected = true;
+    if (!initiator) {
+        return;
+    }
+
+    // Alternate colours so that a batch of games is balanced
+    localWhite = game % 2 == 0;
+
+    DxpMessage request;
+    request.type = DxpMessage::GameRequest;
+    request.name = settings.name;
+    request.followerWhite = !localWhite;
+    request.moves = 75;
+    request.minutes = settings.milliseconds * request.moves / 60000 + 1;
+    request.position = position;
+    send(request);
+}
+
+void DxpSession::send(const DxpMessage& message) {
+    output += message.encode();
+    output += '\0';
+
+    if (message.type == DxpMessage::GameRequest || message.type == DxpMessage::Move || message.type == DxpMessage::GameEnd) {
+        awaiting = message.type;
+        sentAt = std::chrono::steady_clock::now();
+    }
+}
+
+void DxpSession::answered(char sentType, DxpStatistics& statistics) {
+    if (awaiting != sentType) {
+        return;
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - sentAt;
+    statistics.roundTrip[static_cast<unsigned char>(sentType)].add(elapsed.count());
+    awaiting = 0;
+}
+
+void DxpSession::receive(const DxpMessage& message, DxpStatistics& statistics) {
+    switch (message.type) {
+    case DxpMessage::GameRequest: {
+        DxpMessage reply;
+        reply.type = DxpMessage::GameAccept;
+        reply.name = settings.name;
+        if (initiator || started) {
+            reply.code = DxpMessage::Refused;
+            send(reply);
+            return;
+        }
+
+        peerName = message.name;
+        localWhite = message.followerWhite;
+        position = message.position;
+        history.reset(position.hashKey());
+        started = true;
+        reply.code = DxpMessage::Accepted;
+        send(reply);
+        takeTurn();
+        break;
+    }
+    case DxpMessage::GameAccept:
+        answered(DxpMessage::GameRequest, statistics);
+        peerName = message.name;
+        if (message.code != DxpMessage::Accepted) {
+            std::cout << "Game " << game << ": " << peerName << " refused the game (code " << message.code << ")" << std::endl;
+            closing = true;
+            return;
+        }
+        started = true;
+        takeTurn();
+        break;
+    case DxpMessage::Move: {
+        answered(DxpMessage::Move, statistics);
+        BoardMove move;
+        if (!started || endSent || position.whiteToMove == localWhite || !message.toMove(position, move)) {
+            std::cout << "Game " << game << ": illegal move " << message.encode() << " from " << peerName << std::endl;
+            sendEnd(DxpMessage::EndIWin);
+            return;
+        }
+        play(move);
+        takeTurn();
+        break;
+    }
+    case DxpMessage::GameEnd:
+        answered(DxpMessage::GameEnd, statistics);
+        endReceived = true;
+        if (!endSent) {
+            result = mirrorReason(message.code);
+            DxpMessage reply;
+            reply.type = DxpMessage::GameEnd;
+            reply.code = result;
+            reply.stopCode = '1';
+            send(reply);
+            endSent = true;
+        }
+        closing = true;
+        break;
+    case DxpMessage::BackRequest: {
+        DxpMessage reply;
+        reply.type = DxpMessage::BackAccept;
+        reply.code = '1'; // Take-backs are not supported
+        send(reply);
+        break;
+    }
+    case DxpMessage::Chat:
+        std::cout << "Game " << game << " " << peerName << ": " << message.text << std::endl;
+        break;
+    default:
+        break;
+    }
+}
+
+void DxpSession::takeTurn() {
+    if (position.whiteToMove != localWhite || endSent) {
+        return;
+    }
+
+    MoveList list;
+    position.generateMoves(list);
+    if (list.count == 0) {
+        sendEnd(DxpMessage::EndILose);
+        return;
+    }
+    if (history.isThreefoldRepetition() || history.isMoveLimitReached() || plies >= settings.maxPlies) {
+        sendEnd(DxpMessage::EndDraw);
+        return;
+    }
+
+    thinking = true;
+    thinkStart = std::chrono::steady_clock::now();
+
+    if (search == nullptr) {
+        std::promise<BoardMove> move;
+        move.set_value(list[static_cast<int>(nextRandom(random) % static_cast<uint32_t>(list.count))]);
+        pendingMove = move.get_future();
+        return;
+    }
+
+    Position root = position;
+    int milliseconds = settings.milliseconds;
+    Search* engine = search;
+    const GameHistory* positions = &history; // Not changed until the move is played
+    pendingMove = std::async(std::launch::async, [engine, root, milliseconds, positions]() {
+        SearchLimits limits;
+        limits.milliseconds = milliseconds;
+        return engine->think(root, limits, nullptr, positions).bestMove;
+    });
+}
+
+void DxpSession::update() {
+    if (!thinking || pendingMove.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+
+    thinking = false;
+    BoardMove move = pendingMove.get();
+    if (endSent) {
+        return;
+    }
+
+    int seconds = static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - thinkStart).count());
+    send(DxpMessage::fromMove(move, seconds));
+    play(move);
+}
+
+void DxpSession::play(const BoardMove& move) {
+    bool irreversible = GameHistory::isIrreversible(position, move);
+    position.makeMove(move);
+    history.push(position.hashKey(), irreversible);
+    plies++;
+}
+
+void DxpSession::sendEnd(char reason) {
+    result = reason;
+    DxpMessage message;
+    message.type = DxpMessage::GameEnd;
+    message.code = reason;
+    message.stopCode = '1';
+    send(message);
+    endSent = true;
+    if (endReceived) {
+        closing = true;
+    }
+}
+
+void DxpSession::finish(DxpStatistics& statistics) {
+    const char* outcome = "unfinished";
+    if (endSent || endReceived) {
+        switch (result) {
+        case DxpMessage::EndIWin: statistics.wins++; outcome = "win"; break;
+        case DxpMessage::EndILose: statistics.losses++; outcome = "loss"; break;
+        case DxpMessage::EndDraw: statistics.draws++; outcome = "draw"; break;
+        default: statistics.unfinished++; break;
+        }
+    }
+    else {
+        statistics.unfinished++;
+    }
+
+    std::cout << "Game " << game << " against " << (peerName.empty() ? "?" : peerName) << " as "
+        << (localWhite ? "white" : "black") << ": " << outcome << " after " << plies << " plies" << std::endl;
+
+    if (search != nullptr) {
+        std::string label = "dxp game " + std::to_string(game) + " against " + (peerName.empty() ? "?" : peerName) +
+            " as " + (localWhite ? "white" : "black");
+        Telemetry::process().addGame(label, outcome, search->getStatistics());
+    }
+}
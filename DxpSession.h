@@ -0,0 +1,168 @@
+#ifndef DXPSESSION_H
+#define DXPSESSION_H
+
+#include <chrono>
+#include <future>
+#include <string>
+#include "DxpMessage.h"
+#include "GameHistory.h"
+#include "Position.h"
+#include "Search.h"
+#include "Socket.h"
+
+/**
+ * @brief The DxpSettings struct configures the local side of DXP games.
+ */
+struct DxpSettings {
+    std::string name = "Checkers";      ///< Name sent in GAMEREQ and GAMEACC.
+    int milliseconds = 1000;            ///< Thinking time per move; 0 plays random legal moves (the stand-in peer).
+    size_t hashMegabytes = 8;           ///< Transposition table of each game's search.
+    int moveLimit = GameHistory::DefaultMoveLimit; ///< Moves per side without capture or pawn move before a draw.
+    int maxPlies = 1000;                ///< Games reaching this length are ended as draws, a safety net.
+};
+
+/**
+ * @brief The DxpLatency struct accumulates the count, mean and maximum of a latency.
+ */
+struct DxpLatency {
+    long long count = 0;        ///< Number of samples.
+    double total = 0.0;         ///< Sum of the samples in microseconds.
+    double maximum = 0.0;       ///< Largest sample in microseconds.
+
+    /**
+     * @brief Add a sample.
+     *
+     * @param microseconds The latency.
+     */
+    void add(double microseconds) {
+        count++;
+        total += microseconds;
+        if (microseconds > maximum) {
+            maximum = microseconds;
+        }
+    }
+};
+
+/**
+ * @brief The DxpStatistics struct collects per-message latencies of all games of a process.
+ *
+ * Both tables are indexed by the message type character.
+ */
+struct DxpStatistics {
+    DxpLatency handling[128];   ///< From the socket becoming readable to the reply being written, per received type.
+    DxpLatency roundTrip[128];  ///< From sending a message to receiving its answer, per sent type (includes the peer's thinking).
+    int wins = 0;               ///< Games won by the local side.
+    int losses = 0;             ///< Games lost by the local side.
+    int draws = 0;              ///< Drawn games.
+    int unfinished = 0;         ///< Games refused, aborted or disconnected.
+};
+
+/**
+ * @brief The DxpSession class is one DXP game over one connection.
+ *
+ * The session is a state machine driven by the event loop: it is fed received
+ * messages and polled for a finished search, and queues outgoing messages in
+ * its output buffer. The engine thinks on a separate thread so that the event
+ * loop keeps serving the other games meanwhile.
+ */
+class DxpSession {
+public:
+    Socket::Handle socket;      ///< The connection.
+    std::string input;          ///< Received bytes not yet split into messages.
+    std::string output;         ///< Encoded messages not yet written.
+    bool connected;             ///< False while an outgoing connection is being established.
+    bool closing;               ///< True once the game is over; the connection closes when the output is written.
+
+    /**
+     * @brief Constructor for the DxpSession class.
+     *
+     * @param socket The connection.
+     * @param initiator True if this side sends the game request.
+     * @param settings Local engine settings.
+     * @param game Number of the game in this process, used for colours and seeds.
+     */
+    DxpSession(Socket::Handle socket, bool initiator, const DxpSettings& settings, int game);
+
+    /**
+     * @brief Destructor for the DxpSession class, waits for a running search.
+     */
+    ~DxpSession();
+
+    /**
+     * @brief Called once the connection is established; the initiator requests the game.
+     */
+    void start();
+
+    /**
+     * @brief Handle one received message.
+     *
+     * @param message The message.
+     * @param statistics Receives the round-trip latency of answered messages.
+     */
+    void receive(const DxpMessage& message, DxpStatistics& statistics);
+
+    /**
+     * @brief Send the move if the search has finished.
+     */
+    void update();
+
+    /**
+     * @brief Check whether a search is running.
+     */
+    bool isThinking() const { return thinking; }
+
+    /**
+     * @brief Record the result and print a summary line; called when the connection closes.
+     *
+     * @param statistics Receives the result.
+     */
+    void finish(DxpStatistics& statistics);
+
+private:
+    DxpSettings settings;       ///< Local engine settings.
+    bool initiator;             ///< True if this side sent the game request.
+    int game;                   ///< Game number.
+    bool started;               ///< True once the game was accepted.
+    bool localWhite;            ///< Colour of the local side.
+    Position position;          ///< Current position.
+    GameHistory history;        ///< Positions of the game, for draw detection.
+    int plies;                  ///< Moves played.
+    std::string peerName;       ///< Name of the other program.
+    char result;                ///< Result from the local side's view (a GAMEEND reason).
+    bool endSent;               ///< True once GAMEEND was sent.
+    bool endReceived;           ///< True once GAMEEND was received.
+    Search* search;             ///< Engine of this game, null for random moves.
+    bool thinking;              ///< True while a move is being chosen.
+    std::future<BoardMove> pendingMove;                         ///< The move being chosen.
+    std::chrono::steady_clock::time_point thinkStart;           ///< When the current move was started.
+    uint32_t random;                                            ///< State of the random mover.
+    char awaiting;                                              ///< Type of the last sent message that expects an answer, 0 if none.
+    std::chrono::steady_clock::time_point sentAt;               ///< When that message was sent.
+
+    /**
+     * @brief Queue a message.
+     */
+    void send(const DxpMessage& message);
+
+    /**
+     * @brief Play a move on the session's position and record it.
+     */
+    void play(const BoardMove& move);
+
+    /**
+     * @brief Start choosing a move, or end the game if the local side cannot or need not move.
+     */
+    void takeTurn();
+
+    /**
+     * @brief Queue GAMEEND with a reason from the local side's view.
+     */
+    void sendEnd(char reason);
+
+    /**
+     * @brief Record the answer to the message being awaited.
+     */
+    void answered(char sentType, DxpStatistics& statistics);
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "EnginePool.h"
+#include <algorithm>
+
+/**
+ * @file EnginePool.cpp
+ * @brief Implementation of the engine threads serving game coroutines.
+ */
+
+void EnginePool::Awaiter::await_suspend(std::coroutine_handle<> handle) {
+    this->handle = handle;
+    pool.submit(this);
+}
+
+bool EnginePool::Later::operator()(const Awaiter* a, const Awaiter* b) const {
+    // std::push_heap keeps the greatest element first, so "less" means "searched later"
+    if (a->request.priority != b->request.priority) {
+        return a->request.priority < b->request.priority;
+    }
+    bool aDeadline = a->request.deadline.time_since_epoch().count() != 0;
+    bool bDeadline = b->request.deadline.time_since_epoch().count() != 0;
+    if (aDeadline != bDeadline) {
+        return !aDeadline;
+    }
+    if (aDeadline && a->request.deadline != b->request.deadline) {
+        return a->request.deadline > b->request.deadline;
+    }
+    return a->sequence > b->sequence;
+}
+
+EnginePool::EnginePool(GameScheduler& scheduler, int threads, size_t hashMegabytes)
+    : scheduler(scheduler), sequence(0), stopping(false) {
+    int count = threads > 0 ? threads : 1;
+    for (int i = 0; i < count; i++) {
+        searches.emplace_back(new Search(hashMegabytes));
+    }
+    for (int i = 0; i < count; i++) {
+        this->threads.emplace_back(&EnginePool::work, this, i);
+    }
+}
+
+EnginePool::~EnginePool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+EnginePool::Statistics EnginePool::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return statistics;
+}
+
+void EnginePool::submit(Awaiter* awaiter) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        awaiter->sequence = sequence++;
+        awaiter->queued = std::chrono::steady_clock::now();
+        queue.push_back(awaiter);
+        std::push_heap(queue.begin(), queue.end(), Later());
+    }
+    condition.notify_one();
+}
+
+void EnginePool::work(int engine) {
+    Search& search = *searches[engine];
+    while (true) {
+        Awaiter* awaiter;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            std::pop_heap(queue.begin(), queue.end(), Later());
+            awaiter = queue.back();
+            queue.pop_back();
+
+            double wait = std::chrono::duration<double>(std::chrono::steady_clock::now() - awaiter->queued).count();
+            statistics.requests++;
+            statistics.waitSeconds += wait;
+            statistics.maxWaitSeconds = std::max(statistics.maxWaitSeconds, wait);
+        }
+
+        // Fit the budget into the time left before the deadline
+        const EngineRequest& request = awaiter->request;
+        SearchLimits limits = request.limits;
+        if (request.deadline.time_since_epoch().count() != 0) {
+            double left = std::chrono::duration<double, std::milli>(request.deadline - std::chrono::steady_clock::now()).count();
+            if (left < MinimumMilliseconds) {
+                limits.depth = 1;
+                limits.nodes = 0;
+                limits.milliseconds = 0;
+                std::lock_guard<std::mutex> lock(mutex);
+                statistics.late++;
+            }
+            else if (limits.milliseconds == 0 || limits.milliseconds > left) {
+                limits.milliseconds = static_cast<int>(left);
+            }
+        }
+
+        awaiter->result = search.think(request.position, limits, nullptr, request.history);
+        scheduler.schedule(awaiter->handle);
+    }
+}
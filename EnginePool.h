@@ -0,0 +1,138 @@
+#ifndef ENGINEPOOL_H
+#define ENGINEPOOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GameHistory.h"
+#include "GameScheduler.h"
+#include "Position.h"
+#include "Search.h"
+
+/**
+ * @brief The EngineRequest struct asks an EnginePool for a move.
+ */
+struct EngineRequest {
+    Position position;                                  ///< The position to search.
+    const GameHistory* history = nullptr;               ///< Positions of the game ending with position, may be null.
+    SearchLimits limits;                                ///< Budget of the search.
+    int priority = 0;                                   ///< Requests with a higher priority are searched first.
+    std::chrono::steady_clock::time_point deadline;     ///< When the move is needed; the epoch for no deadline.
+};
+
+/**
+ * @brief The EnginePool class searches positions for game coroutines on its own threads.
+ *
+ * Games co_await think(); the request joins one queue ordered by priority,
+ * then by deadline, then by arrival, and the game is suspended until an
+ * engine thread has searched it and handed the game back to its
+ * GameScheduler. Each engine thread owns a Search, so searches never share
+ * a table and the pool's memory does not grow with the number of games.
+ *
+ * A request whose deadline comes before its own time budget runs out is
+ * searched until the deadline only. A request taken from the queue with less
+ * than MinimumMilliseconds left is answered by a depth 1 search and counted
+ * as late: a legal move in time beats a good one too late.
+ */
+class EnginePool {
+public:
+    static const int MinimumMilliseconds = 2;       ///< Time left below which a request is late.
+
+    /**
+     * @brief The Statistics struct describes the requests served so far.
+     */
+    struct Statistics {
+        long long requests = 0;                     ///< Requests searched.
+        long long late = 0;                         ///< Requests taken too close to their deadline.
+        double waitSeconds = 0.0;                   ///< Total time requests spent queued.
+        double maxWaitSeconds = 0.0;                ///< Longest time a request spent queued.
+    };
+
+    /**
+     * @brief The Awaiter class suspends a game until its request has been searched.
+     */
+    class Awaiter {
+    public:
+        Awaiter(EnginePool& pool, const EngineRequest& request) : pool(pool), request(request), sequence(0) {}
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        SearchResult await_resume() { return result; }
+
+    private:
+        friend class EnginePool;
+
+        EnginePool& pool;                                   ///< The pool searching the request.
+        EngineRequest request;                              ///< The request.
+        SearchResult result;                                ///< Filled in by the engine thread.
+        std::coroutine_handle<> handle;                     ///< The suspended game.
+        uint64_t sequence;                                  ///< Arrival order, to break ties.
+        std::chrono::steady_clock::time_point queued;       ///< When the request was queued.
+    };
+
+    /**
+     * @brief Constructor for the EnginePool class, starts the engine threads.
+     *
+     * @param scheduler The scheduler running the games that use the pool.
+     * @param threads Number of engine threads, at least one.
+     * @param hashMegabytes Transposition table of each engine thread.
+     */
+    EnginePool(GameScheduler& scheduler, int threads, size_t hashMegabytes);
+
+    /**
+     * @brief Stop the engine threads. No request may be pending.
+     */
+    ~EnginePool();
+
+    EnginePool(const EnginePool&) = delete;
+    EnginePool& operator=(const EnginePool&) = delete;
+
+    /**
+     * @brief Search a position. Use as `SearchResult result = co_await pool.think(request);`.
+     */
+    Awaiter think(const EngineRequest& request) { return Awaiter(*this, request); }
+
+    /**
+     * @brief Get the number of engine threads.
+     */
+    int size() const { return static_cast<int>(threads.size()); }
+
+    /**
+     * @brief Get the statistics of the requests served so far.
+     */
+    Statistics getStatistics() const;
+
+private:
+    /**
+     * @brief The Later struct orders the queue: the request to search next compares greatest.
+     */
+    struct Later {
+        bool operator()(const Awaiter* a, const Awaiter* b) const;
+    };
+
+    GameScheduler& scheduler;                       ///< Resumes the games.
+    mutable std::mutex mutex;                       ///< Guards queue, sequence, stopping and statistics.
+    std::condition_variable condition;              ///< Signalled when a request is queued or on shutdown.
+    std::vector<Awaiter*> queue;                    ///< Heap of waiting requests, ordered by Later.
+    uint64_t sequence;                              ///< Requests queued so far.
+    bool stopping;                                  ///< Set by the destructor.
+    Statistics statistics;                          ///< Requests served so far.
+    std::vector<std::unique_ptr<Search>> searches;  ///< One search per engine thread.
+    std::vector<std::thread> threads;               ///< The engine threads.
+
+    /**
+     * @brief Queue a request. Called by Awaiter::await_suspend().
+     */
+    void submit(Awaiter* awaiter);
+
+    /**
+     * @brief Loop of an engine thread.
+     */
+    void work(int engine);
+};
+
+#endif
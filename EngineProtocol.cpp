@@ -0,0 +1,266 @@
+#include "EngineProtocol.h"
+#include "MemoryAccounting.h"
+#include "Telemetry.h"
+#include <algorithm>
+
+/**
+ * @file EngineProtocol.cpp
+ * @brief Implementation of the line-based engine protocol.
+ */
+
+namespace {
+    std::string formatMoves(const std::vector<BoardMove>& moves) {
+        std::string text;
+        for (const BoardMove& move : moves) {
+            if (!text.empty()) {
+                text += ' ';
+            }
+            text += Position::moveToString(move);
+        }
+        return text;
+    }
+}
+
+EngineProtocol::EngineProtocol(std::istream& input, std::ostream& output)
+    : input(input), output(output), search(new Search(DefaultHashMegabytes)), searching(false), stopRequested(false), position(Position::initial()), games(0), lines(1) {
+    history.reset(position.hashKey());
+}
+
+EngineProtocol::~EngineProtocol() {
+    stopSearch();
+    delete search;
+}
+
+void EngineProtocol::setNetwork(const NnueNetwork* network) {
+    stopSearch();
+    search->setNetwork(network);
+}
+
+int EngineProtocol::run() {
+    std::string line;
+    while (std::getline(input, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        try {
+            if (!handle(line)) {
+                break;
+            }
+        }
+        catch (const std::exception& e) {
+            send(std::string("info string ") + e.what());
+        }
+    }
+
+    stopSearch();
+    finishGame();
+    return 0;
+}
+
+void EngineProtocol::finishGame() {
+    Telemetry::process().addGame("protocol game " + std::to_string(++games), "", search->getStatistics());
+    search->resetStatistics();
+}
+
+bool EngineProtocol::handle(const std::string& line) {
+    std::istringstream arguments(line);
+    std::string command;
+    arguments >> command;
+
+    if (command.empty()) {
+        return true;
+    }
+    else if (command == "uci") {
+        send("id name Checkers");
+        send("id author Checkers contributors");
+        send("option name Hash type spin default 64 min 1 max 4096");
+        send("option name MoveLimit type spin default " + std::to_string(GameHistory::DefaultMoveLimit) + " min 1 max " +
+            std::to_string(GameHistory::Capacity / 2 - 1));
+        send("option name MultiPV type spin default 1 min 1 max " + std::to_string(MoveList::Capacity));
+        send("option name EvalFile type string default <empty>");
+        send("uciok");
+    }
+    else if (command == "isready") {
+        send("readyok");
+    }
+    else if (command == "setoption") {
+        std::string word, name, value;
+        arguments >> word >> name >> word >> value;
+        if (name == "Hash" && !value.empty()) {
+            stopSearch();
+            search->setHashSize(std::stoul(value));
+        }
+        else if (name == "MoveLimit" && !value.empty()) {
+            stopSearch();
+            history.setMoveLimit(std::stoi(value));
+        }
+        else if (name == "MultiPV" && !value.empty()) {
+            lines = std::max(1, std::stoi(value));
+        }
+        else if (name == "EvalFile") {
+            stopSearch();
+            if (value.empty() || value == "<empty>") {
+                search->setNetwork(nullptr);
+                network.reset();
+            }
+            else {
+                // Load first, so that a bad file keeps the current evaluation
+                std::unique_ptr<NnueNetwork> loaded(new NnueNetwork());
+                loaded->load(value);
+                search->setNetwork(loaded.get());
+                network = std::move(loaded);
+                send("info string evaluating with the network " + value);
+            }
+        }
+    }
+    else if (command == "ucinewgame") {
+        stopSearch();
+        search->clear();
+        finishGame();
+        position = Position::initial();
+        history.reset(position.hashKey());
+    }
+    else if (command == "position") {
+        stopSearch();
+        setPosition(arguments);
+    }
+    else if (command == "go") {
+        stopSearch();
+        go(arguments);
+    }
+    else if (command == "stop") {
+        stopSearch();
+    }
+    else if (command == "d") {
+        send("info string position " + position.toString());
+    }
+    else if (command == "memory") {
+        std::ostringstream report;
+        MemoryAccounting::report(report);
+        std::istringstream table(report.str());
+        std::string row;
+        while (std::getline(table, row)) {
+            send("info string " + row);
+        }
+    }
+    else if (command == "quit") {
+        return false;
+    }
+    else {
+        send("info string unknown command " + command);
+    }
+
+    return true;
+}
+
+void EngineProtocol::setPosition(std::istringstream& arguments) {
+    // Build the new position aside, so that a bad command leaves the previous one in place
+    Position next = position;
+    GameHistory nextHistory = history;
+    std::string word;
+    arguments >> word;
+
+    if (word == "startpos") {
+        next = Position::initial();
+        arguments >> word;
+    }
+    else if (word == "fen") {
+        std::string text;
+        arguments >> text;
+        try {
+            next = Position::fromString(text);
+        }
+        catch (const std::exception& e) {
+            send(std::string("info string ") + e.what());
+            return;
+        }
+        arguments >> word;
+    }
+
+    nextHistory.reset(next.hashKey());
+    if (word == "moves") {
+        std::string text;
+        while (arguments >> text) {
+            BoardMove move;
+            if (!next.findMove(text, move)) {
+                send("info string illegal move " + text);
+                return;
+            }
+            bool irreversible = GameHistory::isIrreversible(next, move);
+            next.makeMove(move);
+            nextHistory.push(next.hashKey(), irreversible);
+        }
+    }
+
+    position = next;
+    history = nextHistory;
+}
+
+void EngineProtocol::go(std::istringstream& arguments) {
+    SearchLimits limits;
+    limits.lines = lines;
+    bool infinite = false;
+    std::string word;
+
+    while (arguments >> word) {
+        if (word == "depth") {
+            arguments >> limits.depth;
+        }
+        else if (word == "nodes") {
+            arguments >> limits.nodes;
+        }
+        else if (word == "movetime") {
+            arguments >> limits.milliseconds;
+        }
+        else if (word == "infinite") {
+            limits.depth = Search::MaxPly;
+            infinite = true;
+        }
+    }
+
+    Position root = position;
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopRequested = false;
+    }
+    searching.store(true);
+    searchThread = std::thread([this, root, limits, infinite]() {
+        SearchResult result = search->think(root, limits, [this](const SearchInfo& info) {
+            std::ostringstream text;
+            long long milliseconds = static_cast<long long>(info.seconds * 1000.0);
+            long long nps = info.seconds > 0 ? static_cast<long long>(info.nodes / info.seconds) : 0;
+            text << "info depth " << info.depth << " multipv " << info.line << " score " << info.score << " nodes " << info.nodes
+                << " time " << milliseconds << " nps " << nps << " pv " << formatMoves(info.pv);
+            send(text.str());
+        }, &history); // Commands that change the history stop the search first
+
+        if (infinite) {
+            // A forced score ends the search early, but "go infinite" answers only to stop
+            std::unique_lock<std::mutex> lock(stopMutex);
+            stopSignal.wait(lock, [this] { return stopRequested; });
+        }
+        send("bestmove " + (result.hasMove ? Position::moveToString(result.bestMove) : std::string("none")));
+        searching.store(false);
+    });
+}
+
+void EngineProtocol::stopSearch() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopRequested = true;
+    }
+    stopSignal.notify_all();
+    // Keep signalling: a stop sent before the thread entered the search would be lost
+    while (searching.load()) {
+        search->stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (searchThread.joinable()) {
+        searchThread.join();
+    }
+}
+
+void EngineProtocol::send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    output << line << std::endl;
+}
@@ -0,0 +1,128 @@
+#ifndef ENGINEPROTOCOL_H
+#define ENGINEPROTOCOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "Nnue.h"
+#include "Position.h"
+#include "Search.h"
+
+/**
+ * @brief The EngineProtocol class drives the engine with a line-based text protocol.
+ *
+ * It is modelled on UCI so that an orchestration layer can run the engine as a
+ * subprocess over stdin/stdout. Searches run on a separate thread, so commands
+ * are still read while the engine thinks and "stop" interrupts it at once.
+ *
+ * Commands:
+ * - `uci` - identify the engine, answered by `id name ...` and `uciok`.
+ * - `isready` - answered by `readyok`.
+ * - `setoption name Hash value <megabytes>` - resize the transposition table.
+ * - `setoption name MoveLimit value <moves>` - moves per side without capture or pawn move before a draw.
+ * - `setoption name MultiPV value <lines>` - number of best moves to search and report, default 1.
+ * - `setoption name EvalFile value [<file>]` - evaluate with the NNUE network in the file, or with the
+ *   classic evaluation when no file is given.
+ * - `ucinewgame` - forget the previous game.
+ * - `position startpos|fen <position> [moves <move> ...]` - set the position (see Position::fromString).
+ * - `go [depth <n>] [nodes <n>] [movetime <ms>] [infinite]` - start searching; with `infinite` the
+ *   best move is reported only after `stop` or `quit`, even if the search ends by itself.
+ * - `stop` - stop the search, which then reports its best move.
+ * - `d` - print the current position.
+ * - `memory` - print the heap memory of every subsystem (see MemoryAccounting).
+ * - `quit` - stop and exit.
+ *
+ * Repetitions and the move limit are detected over the moves given with
+ * `position`, so the engine steers towards or away from draws correctly.
+ *
+ * While searching the engine prints `info depth <d> multipv <k> score <cp> nodes <n> time <ms> nps <n> pv <moves>`
+ * for every line of every iteration and finally `bestmove <move>` (or `bestmove none`).
+ */
+class EngineProtocol {
+public:
+    static const size_t DefaultHashMegabytes = 64; ///< Default transposition table size.
+
+    /**
+     * @brief Constructor for the EngineProtocol class.
+     *
+     * @param input Stream the commands are read from.
+     * @param output Stream the replies are written to.
+     */
+    EngineProtocol(std::istream& input, std::ostream& output);
+
+    /**
+     * @brief Destructor for the EngineProtocol class, stops any running search.
+     */
+    ~EngineProtocol();
+
+    /**
+     * @brief Read and execute commands until "quit" or the end of the input.
+     *
+     * @return The process exit code.
+     */
+    int run();
+
+    /**
+     * @brief Evaluate with an NNUE network, as if given with the EvalFile option.
+     *
+     * @param network The network, which must outlive the protocol; null for the classic evaluation.
+     */
+    void setNetwork(const NnueNetwork* network);
+
+private:
+    std::istream& input;          ///< Command stream.
+    std::ostream& output;         ///< Reply stream.
+    std::mutex outputMutex;       ///< Serialises replies of the command and search threads.
+    Search* search;               ///< The engine.
+    std::thread searchThread;     ///< Thread running the current search.
+    std::atomic<bool> searching;  ///< True until the search thread has reported its best move.
+    std::mutex stopMutex;         ///< Guards stopRequested.
+    std::condition_variable stopSignal; ///< Signalled when stopRequested is set.
+    bool stopRequested;           ///< Set by stopSearch(), releases an infinite search that has finished.
+    Position position;            ///< Position set by the last "position" command.
+    GameHistory history;          ///< Positions from the "position" command up to position.
+    int games;                    ///< Games started with "ucinewgame", for the telemetry labels.
+    int lines;                    ///< Lines searched by "go", set with the MultiPV option.
+    std::unique_ptr<NnueNetwork> network; ///< Network loaded with the EvalFile option.
+
+    /**
+     * @brief Execute one command line.
+     *
+     * @return False if the command asks to quit.
+     */
+    bool handle(const std::string& line);
+
+    /**
+     * @brief Handle the "position" command.
+     *
+     * The position and history change only if the whole command is valid.
+     */
+    void setPosition(std::istringstream& arguments);
+
+    /**
+     * @brief Handle the "go" command.
+     */
+    void go(std::istringstream& arguments);
+
+    /**
+     * @brief Stop the running search, if any, and wait for it to report.
+     */
+    void stopSearch();
+
+    /**
+     * @brief Add the searches of the current game to the telemetry and start a new game.
+     */
+    void finishGame();
+
+    /**
+     * @brief Write one line of output.
+     */
+    void send(const std::string& line);
+};
+
+#endif
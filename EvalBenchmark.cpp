@@ -0,0 +1,156 @@
+#include "EvalBenchmark.h"
+#include "Evaluation.h"
+#include "Nnue.h"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @file EvalBenchmark.cpp
+ * @brief Implementation of the evaluation speed benchmark.
+ */
+
+namespace {
+    const int CorpusGames = 200;      // Random games in the corpus
+    const int MaxGamePlies = 150;     // Plies after which a random game is cut
+    const int Repetitions = 20;       // Passes over the corpus per measurement
+
+    /**
+     * @brief A random game: its root position and the moves played from it.
+     */
+    struct Game {
+        Position root;
+        std::vector<BoardMove> moves;
+    };
+
+    std::vector<Game> buildCorpus() {
+        std::vector<Game> games;
+        uint32_t state = 12345;
+
+        for (int g = 0; g < CorpusGames; g++) {
+            Game game;
+            game.root = Position::initial();
+            Position position = game.root;
+
+            for (int ply = 0; ply < MaxGamePlies; ply++) {
+                MoveList list;
+                position.generateMoves(list);
+                if (list.count == 0) {
+                    break;
+                }
+
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                const BoardMove& move = list[state % list.count];
+                game.moves.push_back(move);
+                position.makeMove(move);
+            }
+
+            games.push_back(game);
+        }
+
+        return games;
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const char* name, long long evaluations, double seconds, long long checksum) {
+        std::cout << name << ": " << evaluations << " evals in " << seconds << " s, "
+            << static_cast<long long>(evaluations / seconds) << " evals/s (checksum " << checksum << ")" << std::endl;
+    }
+}
+
+int EvalBenchmark::run(const std::string& weightsPath) {
+    NnueNetwork* network = new NnueNetwork();
+
+    try {
+        if (weightsPath.empty()) {
+            network->randomize(2024);
+            std::cout << "Using random NNUE weights" << std::endl;
+        }
+        else {
+            network->load(weightsPath);
+            std::cout << "Loaded NNUE weights from " << weightsPath << std::endl;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        delete network;
+        return 1;
+    }
+
+    std::cout << "NNUE inference: " << NnueNetwork::simdName() << std::endl;
+
+    std::vector<Game> games = buildCorpus();
+    std::vector<Position> positions;
+    for (const Game& game : games) {
+        Position position = game.root;
+        positions.push_back(position);
+        for (const BoardMove& move : game.moves) {
+            position.makeMove(move);
+            positions.push_back(position);
+        }
+    }
+    std::cout << "Corpus: " << games.size() << " games, " << positions.size() << " positions" << std::endl;
+
+    // Classic evaluation
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < Repetitions; r++) {
+        for (const Position& position : positions) {
+            checksum += Evaluation::evaluate(position);
+        }
+    }
+    double classicSeconds = secondsSince(start);
+    long long evaluations = static_cast<long long>(positions.size()) * Repetitions;
+    report("Classic", evaluations, classicSeconds, checksum);
+
+    // NNUE with the accumulator rebuilt for every position
+    NnueEvaluator evaluator(*network);
+    checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < Repetitions; r++) {
+        for (const Position& position : positions) {
+            evaluator.reset(position);
+            checksum += evaluator.evaluate(position);
+        }
+    }
+    double refreshSeconds = secondsSince(start);
+    report("NNUE refresh", evaluations, refreshSeconds, checksum);
+
+    // NNUE updated incrementally while the games are played and taken back
+    checksum = 0;
+    long long incrementalEvaluations = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < Repetitions; r++) {
+        for (const Game& game : games) {
+            Position position = game.root;
+            evaluator.reset(position);
+            checksum += evaluator.evaluate(position);
+            incrementalEvaluations++;
+
+            for (const BoardMove& move : game.moves) {
+                evaluator.push(position, move);
+                position.makeMove(move);
+                checksum += evaluator.evaluate(position);
+                incrementalEvaluations++;
+            }
+            for (auto it = game.moves.rbegin(); it != game.moves.rend(); ++it) {
+                position.unmakeMove(*it);
+                evaluator.pop();
+            }
+        }
+    }
+    double incrementalSeconds = secondsSince(start);
+    report("NNUE incremental", incrementalEvaluations, incrementalSeconds, checksum);
+
+    std::cout << "NNUE incremental / classic speed: "
+        << (incrementalEvaluations / incrementalSeconds) / (evaluations / classicSeconds) << std::endl;
+
+    delete network;
+    return 0;
+}
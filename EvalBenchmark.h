@@ -0,0 +1,24 @@
+#ifndef EVALBENCHMARK_H
+#define EVALBENCHMARK_H
+
+#include <string>
+
+/**
+ * @brief The EvalBenchmark class compares the speed of the evaluation functions.
+ *
+ * It builds a fixed corpus of positions from seeded random games and reports
+ * evaluations per second for the classic Evaluation, for the NNUE with a full
+ * accumulator refresh and for the NNUE updated incrementally along the games.
+ */
+class EvalBenchmark {
+public:
+    /**
+     * @brief Run the benchmark and print the results.
+     *
+     * @param weightsPath Path of an NNUE weights file, or an empty string to use random weights.
+     * @return 0 on success, 1 if the weights could not be loaded.
+     */
+    static int run(const std::string& weightsPath);
+};
+
+#endif
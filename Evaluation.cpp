@@ -0,0 +1,38 @@
+#include "Evaluation.h"
+
+/**
+ * @file Evaluation.cpp
+ * @brief Implementation of the classic evaluation function.
+ */
+
+namespace {
+    const uint32_t whiteBackRow = 0xF0000000u;   // Row 7, where white starts
+    const uint32_t blackBackRow = 0x0000000Fu;   // Row 0, where black starts
+    const uint32_t centre = 0x00666600u;         // The eight central squares of rows 2-5
+
+    const int AdvanceBonus = 3;   // Per row a pawn has advanced
+    const int BackRowBonus = 8;   // Per pawn still guarding the back row
+    const int CentreBonus = 6;    // Per piece on a central square
+
+    /**
+     * @brief Score one side from white's point of view.
+     */
+    int scoreSide(uint32_t pieces, uint32_t kings, bool isWhite) {
+        uint32_t pawns = pieces & ~kings;
+        int score = popCount(pawns) * Evaluation::PawnValue + popCount(pieces & kings) * Evaluation::QueenValue;
+
+        for (uint32_t rest = pawns; rest != 0; rest &= rest - 1) {
+            int row = Position::squareRow(lowestBit(rest));
+            score += AdvanceBonus * (isWhite ? 7 - row : row);
+        }
+
+        score += BackRowBonus * popCount(pawns & (isWhite ? whiteBackRow : blackBackRow));
+        score += CentreBonus * popCount(pieces & centre);
+        return score;
+    }
+}
+
+int Evaluation::evaluate(const Position& position) {
+    int score = scoreSide(position.white, position.kings, true) - scoreSide(position.black, position.kings, false);
+    return position.whiteToMove ? score : -score;
+}
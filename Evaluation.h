@@ -0,0 +1,27 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "Position.h"
+
+/**
+ * @brief The Evaluation class is the classic hand-written evaluation function.
+ *
+ * It scores a position from the point of view of the side to move using
+ * material, pawn advancement, back row defence and centre control. Scores are
+ * in hundredths of a pawn.
+ */
+class Evaluation {
+public:
+    static const int PawnValue = 100;  ///< Value of a pawn.
+    static const int QueenValue = 250; ///< Value of a queen.
+
+    /**
+     * @brief Evaluate a position.
+     *
+     * @param position The position to evaluate.
+     * @return The score for the side to move (positive is good for it).
+     */
+    static int evaluate(const Position& position);
+};
+
+#endif
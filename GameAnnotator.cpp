@@ -0,0 +1,241 @@
+#include "GameAnnotator.h"
+#include "MemoryAccounting.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * @file GameAnnotator.cpp
+ * @brief Implementation of the batch annotation of game collections.
+ */
+
+namespace {
+    bool isResult(const std::string& word) {
+        return word == "1-0" || word == "0-1" || word == "1/2-1/2" || word == "2-0" || word == "0-2" || word == "1-1" || word == "*";
+    }
+
+    bool isMoveNumber(const std::string& word) {
+        size_t digits = word.find_first_not_of("0123456789");
+        return digits > 0 && digits != std::string::npos && word.find_first_not_of('.', digits) == std::string::npos;
+    }
+
+    int clampScore(int score) {
+        return std::max(-GameAnnotator::ScoreClamp, std::min(GameAnnotator::ScoreClamp, score));
+    }
+
+    bool sameMove(const BoardMove& a, const BoardMove& b) {
+        return a.from == b.from && a.to == b.to && a.captured == b.captured;
+    }
+}
+
+std::vector<GameAnnotator::Game> GameAnnotator::load(const std::string& path) {
+    MemoryScope scope(MemoryTag::Books);
+    std::ifstream stream(path);
+    if (!stream) {
+        throw std::runtime_error("Cannot read the games " + path);
+    }
+
+    std::vector<Game> games;
+    std::string line;
+    int number = 0;
+    while (std::getline(stream, line)) {
+        number++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        Game game;
+        game.line = number;
+
+        std::istringstream words(line);
+        std::string word;
+        bool first = true;
+        while (words >> word) {
+            if (first) {
+                first = false;
+                if (word.size() > 2 && word[1] == ':') {
+                    game.moves.reset(Position::fromString(word));
+                    continue;
+                }
+            }
+            if (isMoveNumber(word)) {
+                continue;
+            }
+            if (isResult(word)) {
+                game.result = word;
+                break;
+            }
+
+            BoardMove move;
+            if (!game.moves.current().findMove(word, move)) {
+                throw std::runtime_error("Line " + std::to_string(number) + " of " + path + ": " + word + " is not a legal move.");
+            }
+            game.moves.push(move);
+        }
+
+        games.push_back(game);
+    }
+    return games;
+}
+
+std::vector<GameAnnotator::Ply> GameAnnotator::annotate(const Game& game, Search& search, const SearchLimits& limits, int& finalScore) {
+    search.clear();
+
+    Position position = game.moves.start();
+    GameHistory history;
+    history.reset(position.hashKey());
+
+    std::vector<Ply> plies;
+    SearchResult before = search.think(position, limits, nullptr, &history);
+    for (int i = 0; i < game.moves.length(); i++) {
+        MoveList list;
+        position.generateMoves(list);
+        BoardMove move = list[game.moves[i].find(list)];
+        bool irreversible = GameHistory::isIrreversible(position, move);
+        position.makeMove(move);
+        history.push(position.hashKey(), irreversible);
+
+        // The next search scores the move played for the opponent
+        SearchResult after = search.think(position, limits, nullptr, &history);
+
+        Ply ply;
+        ply.played = move;
+        ply.best = before.bestMove;
+        ply.score = before.score;
+        ply.depth = before.depth;
+        ply.loss = sameMove(move, before.bestMove) ? 0 : std::max(0, clampScore(before.score) - clampScore(-after.score));
+        plies.push_back(ply);
+
+        before = after;
+    }
+
+    finalScore = before.score;
+    return plies;
+}
+
+std::string GameAnnotator::format(const Game& game, const std::vector<Ply>& plies, int finalScore) {
+    std::ostringstream text;
+    text << "Game at line " << game.line;
+    if (!game.result.empty()) {
+        text << " (" << game.result << ")";
+    }
+    text << "\n";
+
+    bool white = game.moves.start().whiteToMove;
+    int moveNumber = 1;
+    for (const Ply& ply : plies) {
+        std::string number = std::to_string(moveNumber) + (white ? "." : "...");
+        text << "  " << std::left << std::setw(6) << number << std::setw(14) << Position::moveToString(ply.played)
+            << "eval " << std::right << std::showpos << std::setw(6) << ply.score << std::noshowpos
+            << "  depth " << std::setw(2) << ply.depth;
+        if (!sameMove(ply.played, ply.best)) {
+            text << "  best " << Position::moveToString(ply.best);
+            if (ply.loss >= BlunderLoss) {
+                text << " ?? (-" << ply.loss << ")";
+            }
+            else if (ply.loss >= MistakeLoss) {
+                text << " ? (-" << ply.loss << ")";
+            }
+        }
+        text << "\n";
+
+        if (!white) {
+            moveNumber++;
+        }
+        white = !white;
+    }
+    text << "  final eval " << std::showpos << finalScore << std::noshowpos << "\n";
+    return text.str();
+}
+
+int GameAnnotator::runFile(const std::string& path, const std::string& outputPath, int threads, const std::string& budget) {
+    try {
+        SearchLimits limits;
+        try {
+            if (budget.size() > 2 && budget.compare(budget.size() - 2, 2, "ms") == 0) {
+                limits.milliseconds = std::stoi(budget.substr(0, budget.size() - 2));
+            }
+            else {
+                limits.nodes = std::stoll(budget);
+            }
+        }
+        catch (const std::logic_error&) {
+            throw std::runtime_error("The budget must be a number of nodes or milliseconds written as \"500ms\", not \"" +
+                budget + "\".");
+        }
+        if (threads <= 0) {
+            threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+
+        std::vector<Game> games = load(path);
+
+        std::ofstream file;
+        if (outputPath != "-") {
+            file.open(outputPath);
+            if (!file) {
+                throw std::runtime_error("Cannot write the annotations to " + outputPath);
+            }
+        }
+        std::ostream& output = outputPath != "-" ? file : std::cout;
+
+        WorkStealingPool pool(threads);
+        std::vector<std::unique_ptr<Search>> searches;
+        for (int i = 0; i < pool.size(); i++) {
+            searches.emplace_back(new Search(HashMegabytes));
+        }
+
+        // Finished games wait here until every game before them has been written
+        std::mutex outputMutex;
+        std::vector<std::string> annotations(games.size());
+        std::vector<bool> finished(games.size(), false);
+        size_t written = 0;
+        long long plies = 0;
+        int mistakes = 0;
+        int blunders = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        pool.run(games.size(), [&](size_t task, int worker) {
+            int finalScore = 0;
+            std::vector<Ply> annotated = annotate(games[task], *searches[worker], limits, finalScore);
+            std::string text = format(games[task], annotated, finalScore);
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            plies += annotated.size();
+            for (const Ply& ply : annotated) {
+                blunders += ply.loss >= BlunderLoss ? 1 : 0;
+                mistakes += ply.loss >= MistakeLoss && ply.loss < BlunderLoss ? 1 : 0;
+            }
+            annotations[task] = text;
+            finished[task] = true;
+            while (written < games.size() && finished[written]) {
+                output << annotations[written];
+                annotations[written].clear();
+                written++;
+            }
+            output.flush();
+        });
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Annotated " << games.size() << " games, " << plies << " plies with " << pool.size() << " threads in "
+            << std::fixed << std::setprecision(2) << seconds << " s: " << std::setprecision(0)
+            << (seconds > 0.0 ? games.size() * 3600.0 / seconds : 0.0) << " games/hour, "
+            << (seconds > 0.0 ? plies / seconds : 0.0) << " plies/s" << std::defaultfloat << std::setprecision(6) << std::endl;
+        std::cout << "Flagged " << blunders << " blunders and " << mistakes << " mistakes" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
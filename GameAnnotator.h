@@ -0,0 +1,98 @@
+#ifndef GAMEANNOTATOR_H
+#define GAMEANNOTATOR_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "GameRecord.h"
+#include "Position.h"
+#include "Search.h"
+
+/**
+ * @brief The GameAnnotator class annotates a collection of games with engine evaluations.
+ *
+ * A collection file has one game per line: an optional starting position in
+ * the format of Position::fromString, the moves in any notation accepted by
+ * Position::findMove and an optional result (1-0, 0-1 or 1/2-1/2). Move
+ * numbers such as "12." are skipped, as are empty lines and lines starting
+ * with '#':
+ *
+ *     1. c6-b5 f3-g4 2. b7-c6 g4-h5 ... 1-0
+ *
+ * Every game is replayed through the rules and every position searched with
+ * the same budget. The search of a game keeps its transposition table from
+ * ply to ply, because consecutive positions share most of their trees, and
+ * knows the game history for repetitions. The score of a move is the negated
+ * score of the position it leads to, so one search per ply gives both the
+ * evaluation and the loss of the move played against the best one; moves
+ * losing at least BlunderLoss are flagged "??", at least MistakeLoss "?".
+ *
+ * Games are shared out to a WorkStealingPool, one Search per worker, and the
+ * annotations are written in the order of the collection as soon as all
+ * games before them are done.
+ */
+class GameAnnotator {
+public:
+    static const int MistakeLoss = 100;         ///< Loss in hundredths of a pawn flagged "?".
+    static const int BlunderLoss = 300;         ///< Loss flagged "??".
+    static constexpr int ScoreClamp = 1000;     ///< Mate scores count as this much when measuring losses.
+    static const size_t HashMegabytes = 16;     ///< Transposition table of each worker.
+
+    /**
+     * @brief The Game struct is one game of a collection.
+     */
+    struct Game {
+        int line;                           ///< Line of the collection file.
+        GameRecord moves;                   ///< Starting position and moves.
+        std::string result;                 ///< Result as written in the file, may be empty.
+    };
+
+    /**
+     * @brief The Ply struct is the annotation of one move.
+     */
+    struct Ply {
+        BoardMove played;                   ///< The move of the game.
+        BoardMove best;                     ///< The engine's choice.
+        int score;                          ///< Score of the position before the move, for the side to move.
+        int loss;                           ///< Score of the best move minus that of the move played, 0 or more.
+        int depth;                          ///< Depth of the search.
+    };
+
+    /**
+     * @brief Load a collection file.
+     *
+     * @param path The file.
+     * @return The games in file order.
+     * @throw std::runtime_error if the file cannot be read or a move is illegal.
+     */
+    static std::vector<Game> load(const std::string& path);
+
+    /**
+     * @brief Search every position of one game.
+     *
+     * @param game The game.
+     * @param search The search to use; its table is cleared first.
+     * @param limits The budget of every search.
+     * @param finalScore Receives the score of the position after the last move.
+     * @return One annotation per move.
+     */
+    static std::vector<Ply> annotate(const Game& game, Search& search, const SearchLimits& limits, int& finalScore);
+
+    /**
+     * @brief Format the annotation of a game, one move per line.
+     */
+    static std::string format(const Game& game, const std::vector<Ply>& plies, int finalScore);
+
+    /**
+     * @brief Annotate a collection from the command line.
+     *
+     * @param path The collection file.
+     * @param outputPath File for the annotations, "-" for the console.
+     * @param threads Worker threads, 0 for one per core.
+     * @param budget Nodes per position, or milliseconds when it ends in "ms".
+     * @return 0 on success, 1 on error.
+     */
+    static int runFile(const std::string& path, const std::string& outputPath, int threads, const std::string& budget);
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "GameClock.h"
+#include <algorithm>
+#include <cstdio>
+
+/**
+ * @file GameClock.cpp
+ * @brief Implementation of the millisecond game clock.
+ */
+
+GameClock::GameClock(const TimeControl& control) : control(control), running(false), runningWhite(true) {
+    left[0] = left[1] = control.base;
+    spent[0] = spent[1] = 0;
+}
+
+void GameClock::start(bool white) {
+    if (running) {
+        return;
+    }
+    running = true;
+    runningWhite = white;
+    moveStart = Clock::now();
+}
+
+long long GameClock::stop() {
+    if (!running) {
+        return 0;
+    }
+
+    long long milliseconds = elapsed();
+    int side = runningWhite ? 1 : 0;
+    spent[side] += milliseconds;
+    left[side] -= charged(milliseconds);
+    if (isTimed() && left[side] >= 0) {
+        left[side] += control.increment;
+    }
+
+    running = false;
+    return milliseconds;
+}
+
+long long GameClock::elapsed() const {
+    if (!running) {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - moveStart).count();
+}
+
+long long GameClock::charged(long long milliseconds) const {
+    return std::max(0LL, milliseconds - control.delay);
+}
+
+long long GameClock::remaining(bool white) const {
+    if (!isTimed()) {
+        return 0;
+    }
+    long long result = left[white ? 1 : 0];
+    if (running && runningWhite == white) {
+        result -= charged(elapsed());
+    }
+    return result;
+}
+
+long long GameClock::used(bool white) const {
+    long long result = spent[white ? 1 : 0];
+    if (running && runningWhite == white) {
+        result += elapsed();
+    }
+    return result;
+}
+
+GameClock::Clock::time_point GameClock::deadline() const {
+    if (!isTimed() || !running) {
+        return Clock::time_point::max();
+    }
+    return moveStart + std::chrono::milliseconds(left[runningWhite ? 1 : 0] + control.delay);
+}
+
+int GameClock::moveBudget() const {
+    if (!isTimed() || !running) {
+        return 0;
+    }
+
+    // Time that can be spent before the flag falls, less what has already gone
+    long long available = left[runningWhite ? 1 : 0] + control.delay - elapsed() - SafetyMargin;
+    long long budget = left[runningWhite ? 1 : 0] / MovesToGo + control.increment + control.delay;
+    budget = std::min(budget, available);
+    return static_cast<int>(std::max(1LL, budget));
+}
+
+std::string GameClock::formatTime(long long milliseconds) {
+    long long magnitude = milliseconds < 0 ? -milliseconds : milliseconds;
+    char text[32];
+    std::snprintf(text, sizeof(text), "%s%lld:%02lld.%03lld", milliseconds < 0 ? "-" : "",
+        magnitude / 60000, magnitude / 1000 % 60, magnitude % 1000);
+    return text;
+}
+
+std::string GameClock::toString() const {
+    if (!isTimed()) {
+        return "White used " + formatTime(used(true)) + " | Black used " + formatTime(used(false));
+    }
+    return "White " + formatTime(remaining(true)) + " | Black " + formatTime(remaining(false));
+}
@@ -0,0 +1,134 @@
+#ifndef GAMECLOCK_H
+#define GAMECLOCK_H
+
+#include <chrono>
+#include <string>
+
+/**
+ * @brief The TimeControl struct describes the time each side gets.
+ *
+ * All values are in milliseconds. A base time of 0 means an untimed game: the
+ * clock then only measures the time used.
+ */
+struct TimeControl {
+    long long base = 0;         ///< Starting time of each side.
+    long long increment = 0;    ///< Fischer increment added after every completed move.
+    long long delay = 0;        ///< Delay at the start of every move before the clock runs down.
+};
+
+/**
+ * @brief The GameClock class is the chess clock of the interactive game.
+ *
+ * Time is measured with std::chrono::steady_clock in milliseconds. Only one
+ * side's clock runs at a time: start() starts it for the side to move and
+ * stop() charges the elapsed time, less the delay, and adds the increment.
+ * A side whose remaining time falls below zero has lost on time (flag fall).
+ */
+class GameClock {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static const int MovesToGo = 25;                ///< Moves the remaining time is spread over when budgeting.
+    static const long long SafetyMargin = 50;       ///< Milliseconds kept in reserve for move overhead.
+
+    /**
+     * @brief Constructor for the GameClock class.
+     *
+     * @param control The time control of both sides.
+     */
+    explicit GameClock(const TimeControl& control = TimeControl());
+
+    /**
+     * @brief Check if the game is played with a time limit.
+     */
+    bool isTimed() const { return control.base > 0; }
+
+    /**
+     * @brief Start the clock of a side; does nothing if it is already running.
+     *
+     * @param white True for white's clock.
+     */
+    void start(bool white);
+
+    /**
+     * @brief Stop the running clock after a completed move.
+     *
+     * The increment is only added if the side did not run out of time.
+     *
+     * @return The milliseconds the move took.
+     */
+    long long stop();
+
+    /**
+     * @brief Get the remaining time of a side, including the running move.
+     *
+     * @param white True for white.
+     * @return Milliseconds left, negative once the flag has fallen; 0 for untimed games.
+     */
+    long long remaining(bool white) const;
+
+    /**
+     * @brief Get the time a side has used in the game, including the running move.
+     *
+     * @param white True for white.
+     * @return Milliseconds used.
+     */
+    long long used(bool white) const;
+
+    /**
+     * @brief Check if a side has run out of time.
+     *
+     * @param white True for white.
+     */
+    bool hasFlagged(bool white) const { return isTimed() && remaining(white) < 0; }
+
+    /**
+     * @brief Get the moment the running side's flag falls.
+     *
+     * @return The deadline; Clock::time_point::max() for untimed games or a stopped clock.
+     */
+    Clock::time_point deadline() const;
+
+    /**
+     * @brief Get the thinking time for the running side's move.
+     *
+     * The budget is a share of the remaining time plus the increment and the
+     * delay, and always ends before deadline() with a safety margin.
+     *
+     * @return Milliseconds to think, 0 for untimed games or a stopped clock.
+     */
+    int moveBudget() const;
+
+    /**
+     * @brief Format the clock of both sides, e.g. "White 2:58.312 | Black 3:00.000".
+     */
+    std::string toString() const;
+
+    /**
+     * @brief Format a duration as minutes, seconds and milliseconds.
+     *
+     * @param milliseconds The duration, may be negative.
+     * @return Text such as "2:58.312".
+     */
+    static std::string formatTime(long long milliseconds);
+
+private:
+    TimeControl control;            ///< Time control of both sides.
+    long long left[2];              ///< Remaining time per side (black, white) before the running move.
+    long long spent[2];             ///< Time used per side before the running move.
+    bool running;                   ///< True while a side's clock runs.
+    bool runningWhite;              ///< The side whose clock runs.
+    Clock::time_point moveStart;    ///< When the running move started.
+
+    /**
+     * @brief Get the milliseconds since the running move started, 0 if the clock is stopped.
+     */
+    long long elapsed() const;
+
+    /**
+     * @brief Get the part of the elapsed time charged to the running side, after the delay.
+     */
+    long long charged(long long milliseconds) const;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include "GameHistory.h"
+
+/**
+ * @file GameHistory.cpp
+ * @brief Implementation of the position history used for draw detection.
+ */
+
+GameHistory::GameHistory(int moveLimit) : size(0), moveLimit(DefaultMoveLimit) {
+    setMoveLimit(moveLimit);
+}
+
+void GameHistory::reset(uint64_t key) {
+    size = 0;
+    push(key, true);
+}
+
+void GameHistory::push(uint64_t key, bool irreversible) {
+    int run = irreversible || size == 0 ? 0 : reversible[top()] + 1;
+
+    size++;
+    keys[top()] = key;
+    // The run never needs to exceed the move limit, which keeps it inside the buffer
+    reversible[top()] = static_cast<uint16_t>(run < Capacity - 1 ? run : Capacity - 1);
+}
+
+void GameHistory::pop() {
+    if (size > 0) {
+        size--;
+    }
+}
+
+int GameHistory::repetitions() const {
+    if (size == 0) {
+        return 0;
+    }
+
+    uint64_t key = keys[top()];
+    int run = reversible[top()];
+    if (run > size - 1) {
+        run = size - 1; // Older positions have been overwritten or were never recorded
+    }
+
+    int count = 0;
+    for (int back = 2; back <= run; back += 2) {
+        if (keys[(size - 1 - back) & (Capacity - 1)] == key) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void GameHistory::setMoveLimit(int moves) {
+    if (moves < 1) {
+        moves = 1;
+    }
+    moveLimit = moves < Capacity / 2 ? moves : Capacity / 2 - 1;
+}
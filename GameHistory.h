@@ -0,0 +1,123 @@
+#ifndef GAMEHISTORY_H
+#define GAMEHISTORY_H
+
+#include <cstdint>
+#include "Position.h"
+
+/**
+ * @brief The GameHistory class remembers the hash keys of the positions of a game.
+ *
+ * The keys are kept in a fixed ring buffer together with the number of
+ * reversible plies (queen moves without capture) that led to each position.
+ * A position can only repeat within such a reversible run, so a repetition
+ * check compares at most the keys back to the last capture or pawn move, and
+ * only every second one (the key includes the side to move). Push and pop are
+ * O(1) and never allocate, so the search keeps its own copy and updates it at
+ * every node.
+ *
+ * Two draw rules are detected:
+ * - threefold repetition of a position with the same side to move;
+ * - the move limit: moveLimit moves by each side without a capture or a pawn move.
+ */
+class GameHistory {
+public:
+    static const int Capacity = 1024;            ///< Ring buffer size, a power of two.
+    static const int DefaultMoveLimit = 40;      ///< Default moves per side without capture or pawn move.
+
+    /**
+     * @brief Constructor for the GameHistory class, creates an empty history.
+     *
+     * @param moveLimit Moves per side without capture or pawn move after which the game is drawn.
+     */
+    explicit GameHistory(int moveLimit = DefaultMoveLimit);
+
+    /**
+     * @brief Start a new history from a position.
+     *
+     * @param key Hash key of the start position.
+     */
+    void reset(uint64_t key);
+
+    /**
+     * @brief Record the position reached by a move.
+     *
+     * @param key Hash key of the new position.
+     * @param irreversible True if the move captured or moved a pawn (see isIrreversible()).
+     */
+    void push(uint64_t key, bool irreversible);
+
+    /**
+     * @brief Forget the last recorded position.
+     */
+    void pop();
+
+    /**
+     * @brief Count the earlier occurrences of the current position.
+     *
+     * Only the positions since the last irreversible move are compared.
+     *
+     * @return 0 if the current position is new, 2 if it occurs for the third time.
+     */
+    int repetitions() const;
+
+    /**
+     * @brief Check if the current position occurs for the third time.
+     */
+    bool isThreefoldRepetition() const { return repetitions() >= 2; }
+
+    /**
+     * @brief Check if the move limit has been reached.
+     */
+    bool isMoveLimitReached() const { return size > 0 && reversible[top()] >= 2 * moveLimit; }
+
+    /**
+     * @brief Get the number of plies since the last capture or pawn move.
+     */
+    int reversiblePlies() const { return size > 0 ? reversible[top()] : 0; }
+
+    /**
+     * @brief Get the number of recorded positions.
+     */
+    int length() const { return size; }
+
+    /**
+     * @brief Get the hash key of the current position.
+     */
+    uint64_t lastKey() const { return size > 0 ? keys[top()] : 0; }
+
+    /**
+     * @brief Get the move limit.
+     */
+    int getMoveLimit() const { return moveLimit; }
+
+    /**
+     * @brief Change the move limit.
+     *
+     * @param moves Moves per side without capture or pawn move, at most Capacity / 2.
+     */
+    void setMoveLimit(int moves);
+
+    /**
+     * @brief Check if a move can never be taken back: a capture or a pawn move.
+     *
+     * @param before The position the move is played in.
+     * @param move The move.
+     * @return True if no earlier position can repeat after the move.
+     */
+    static bool isIrreversible(const Position& before, const BoardMove& move) {
+        return move.isCapture() || ((before.kings >> move.from) & 1u) == 0;
+    }
+
+private:
+    uint64_t keys[Capacity];        ///< Hash keys, indexed by ply modulo Capacity.
+    uint16_t reversible[Capacity];  ///< Reversible plies before each position.
+    int size;                       ///< Number of recorded positions.
+    int moveLimit;                  ///< Moves per side without capture or pawn move before a draw.
+
+    /**
+     * @brief Get the ring buffer index of the current position.
+     */
+    int top() const { return (size - 1) & (Capacity - 1); }
+};
+
+#endif
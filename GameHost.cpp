@@ -0,0 +1,147 @@
+#include "GameHost.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @file GameHost.cpp
+ * @brief Implementation of the coroutine games and the --host mode.
+ */
+
+GameTask GameHost::play(EnginePool& engines, Game& game) {
+    Position position = game.moves.start();
+    GameHistory history;
+    history.reset(position.hashKey());
+
+    while (true) {
+        if (!position.hasLegalMove()) {
+            game.result = position.whiteToMove ? "0-1" : "1-0";
+            break;
+        }
+        if (history.isThreefoldRepetition() || history.isMoveLimitReached() || game.moves.length() >= MaxPlies) {
+            game.result = "1/2-1/2";
+            break;
+        }
+
+        const Seat& seat = position.whiteToMove ? game.white : game.black;
+        BoardMove move;
+        if (seat.inbox != nullptr) {
+            if (game.log != nullptr) {
+                MoveList list;
+                position.generateMoves(list);
+                *game.log << "Game " << game.id << ": " << position.toString() << "\nYour move (";
+                for (int i = 0; i < list.count; i++) {
+                    *game.log << (i > 0 ? " " : "") << Position::moveToString(list[i]);
+                }
+                *game.log << "): " << std::flush;
+            }
+            std::string text = co_await seat.inbox->next();
+            if (text == "resign") {
+                game.result = position.whiteToMove ? "0-1" : "1-0";
+                break;
+            }
+            if (!position.findMove(text, move)) {
+                if (game.log != nullptr) {
+                    *game.log << text << " is not a legal move." << std::endl;
+                }
+                continue;
+            }
+        }
+        else {
+            EngineRequest request;
+            request.position = position;
+            request.history = &history;
+            request.limits.depth = Search::MaxPly;
+            request.limits.milliseconds = game.milliseconds;
+            request.priority = seat.priority;
+            request.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(DeadlineFactor * game.milliseconds);
+            SearchResult result = co_await engines.think(request);
+            move = result.bestMove;
+            if (game.log != nullptr) {
+                *game.log << "Game " << game.id << ": engine plays " << Position::moveToString(move) << std::endl;
+            }
+        }
+
+        bool irreversible = GameHistory::isIrreversible(position, move);
+        position.makeMove(move);
+        history.push(position.hashKey(), irreversible);
+        game.moves.push(move);
+    }
+
+    if (game.log != nullptr) {
+        *game.log << "Game " << game.id << " ends " << game.result << ": " << game.moves.toString() << std::endl;
+    }
+    if (game.white.inbox != nullptr) {
+        game.white.inbox->close();
+    }
+}
+
+int GameHost::run(int games, int threads, int engineThreads, int milliseconds, bool human) {
+    try {
+        if (games < 1 || milliseconds < 1) {
+            throw std::runtime_error("Usage: checkers --host <games> [threads] [engine threads] [ms per move] [human]");
+        }
+        if (engineThreads <= 0) {
+            engineThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+
+        // Declared in this order so that the pool stops before the scheduler and both outlive the games
+        GameScheduler scheduler(threads);
+        EnginePool engines(scheduler, engineThreads, HashMegabytes);
+        MoveInbox console(scheduler);
+
+        std::vector<Game> hosted(games);
+        for (int i = 0; i < games; i++) {
+            hosted[i].id = i;
+            hosted[i].milliseconds = milliseconds;
+        }
+        if (human) {
+            // The human's opponent answers first, so it does not keep them waiting behind the other games
+            hosted[0].white.inbox = &console;
+            hosted[0].black.priority = 1;
+            hosted[0].log = &std::cout;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (Game& game : hosted) {
+            scheduler.spawn(play(engines, game));
+        }
+        if (human) {
+            std::string line;
+            while (console.waitUntilWanted()) {
+                console.post(std::getline(std::cin, line) ? line : "resign");
+            }
+        }
+        scheduler.wait();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        long long plies = 0;
+        int whiteWins = 0;
+        int blackWins = 0;
+        for (const Game& game : hosted) {
+            plies += game.moves.length();
+            whiteWins += game.result == "1-0" ? 1 : 0;
+            blackWins += game.result == "0-1" ? 1 : 0;
+        }
+        EnginePool::Statistics statistics = engines.getStatistics();
+
+        std::cout << "Played " << games << " games, " << plies << " plies on " << scheduler.size() << " game threads and "
+            << engines.size() << " engine threads in " << std::fixed << std::setprecision(2) << seconds << " s ("
+            << std::setprecision(0) << (seconds > 0.0 ? plies / seconds : 0.0) << " plies/s, " << scheduler.resumes()
+            << " resumes)" << std::endl;
+        std::cout << "Results: " << whiteWins << " white wins, " << games - whiteWins - blackWins << " draws, " << blackWins
+            << " black wins" << std::endl;
+        std::cout << "Engine requests: " << statistics.requests << ", mean queue wait " << std::setprecision(2)
+            << (statistics.requests > 0 ? statistics.waitSeconds * 1000.0 / statistics.requests : 0.0) << " ms, max "
+            << statistics.maxWaitSeconds * 1000.0 << " ms, " << statistics.late << " past their deadline"
+            << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#ifndef GAMEHOST_H
+#define GAMEHOST_H
+
+#include <ostream>
+#include <string>
+#include "EnginePool.h"
+#include "GameRecord.h"
+#include "GameScheduler.h"
+
+/**
+ * @brief The GameHost class plays many games at once as coroutines.
+ *
+ * Every game is a GameTask. On each turn it awaits the move of the side to
+ * move: a MoveInbox for a human or a network player, or the EnginePool for
+ * the engine. A waiting game holds no thread, so a few scheduler threads and
+ * one engine thread per core serve thousands of games; the rules and the
+ * game end are the same as in the interactive game.
+ */
+class GameHost {
+public:
+    static const int MaxPlies = 400;                ///< Games reaching this length are ended as draws.
+    static const int DeadlineFactor = 3;            ///< An engine move is due this many budgets after it is asked for.
+    static const size_t HashMegabytes = 16;         ///< Transposition table of each engine thread.
+
+    /**
+     * @brief The Seat struct is one side of a game.
+     */
+    struct Seat {
+        MoveInbox* inbox = nullptr;     ///< Source of the moves, or null for the engine.
+        int priority = 0;               ///< Priority of the engine requests of this side.
+    };
+
+    /**
+     * @brief The Game struct is one hosted game.
+     */
+    struct Game {
+        int id = 0;                     ///< Number of the game.
+        Seat white;                     ///< White side.
+        Seat black;                     ///< Black side.
+        int milliseconds = 100;         ///< Engine budget per move.
+        std::ostream* log = nullptr;    ///< Receives the moves as they are played, may be null.
+        GameRecord moves;               ///< The moves played.
+        std::string result;             ///< "1-0", "0-1" or "1/2-1/2" once finished.
+    };
+
+    /**
+     * @brief Play one game.
+     *
+     * @param engines The pool searching the engine moves.
+     * @param game The game; it must outlive the coroutine.
+     * @return The coroutine, to give to GameScheduler::spawn().
+     */
+    static GameTask play(EnginePool& engines, Game& game);
+
+    /**
+     * @brief Host engine games from the command line, optionally with a human playing white in the first one.
+     *
+     * @param games Number of games played at once.
+     * @param threads Scheduler threads.
+     * @param engineThreads Engine threads, 0 for one per core.
+     * @param milliseconds Engine budget per move.
+     * @param human True to read white's moves in the first game from the console.
+     * @return 0 on success, 1 on error.
+     */
+    static int run(int games, int threads, int engineThreads, int milliseconds, bool human);
+};
+
+#endif
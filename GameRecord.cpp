@@ -0,0 +1,91 @@
+#include "GameRecord.h"
+#include <stdexcept>
+
+/**
+ * @file GameRecord.cpp
+ * @brief Implementation of the compact game record.
+ */
+
+GameRecord::GameRecord() {
+    reset(Position::initial());
+}
+
+void GameRecord::reset(const Position& start) {
+    moves.clear();
+    moves.reserve(DefaultPlies);
+    checkpoints.clear();
+    checkpoints.reserve(DefaultPlies / CheckpointInterval + 1);
+    checkpoints.push_back(start);
+    position = start;
+}
+
+void GameRecord::push(const BoardMove& move) {
+    MoveList list;
+    position.generateMoves(list);
+    int index = -1;
+    for (int i = 0; i < list.count && index < 0; i++) {
+        if (list[i].from == move.from && list[i].to == move.to && list[i].captured == move.captured) {
+            index = i;
+        }
+    }
+    if (index < 0) {
+        throw std::runtime_error("The move " + Position::moveToString(move) + " is not legal in " + position.toString());
+    }
+
+    moves.push_back(PackedMove::pack(list, index));
+    position.makeMove(list[index]);
+    if (moves.size() % CheckpointInterval == 0) {
+        checkpoints.push_back(position);
+    }
+}
+
+void GameRecord::takeBack() {
+    if (moves.empty()) {
+        return;
+    }
+    if (moves.size() % CheckpointInterval == 0) {
+        checkpoints.pop_back();
+    }
+    moves.pop_back();
+    position = positionAt(length());
+}
+
+Position GameRecord::positionAt(int ply) const {
+    Position replayed = checkpoints[ply / CheckpointInterval];
+    for (int i = ply - ply % CheckpointInterval; i < ply; i++) {
+        MoveList list;
+        replayed.generateMoves(list);
+        replayed.makeMove(list[moves[i].find(list)]);
+    }
+    return replayed;
+}
+
+BoardMove GameRecord::moveAt(int ply) const {
+    Position before = positionAt(ply);
+    MoveList list;
+    before.generateMoves(list);
+    return list[moves[ply].find(list)];
+}
+
+std::string GameRecord::toString() const {
+    std::string text;
+    Position replayed = start();
+    int moveNumber = 1;
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (replayed.whiteToMove || i == 0) {
+            text += std::to_string(moveNumber) + (replayed.whiteToMove ? ". " : "... ");
+        }
+        MoveList list;
+        replayed.generateMoves(list);
+        const BoardMove& move = list[moves[i].find(list)];
+        text += Position::moveToString(move) + " ";
+        if (!replayed.whiteToMove) {
+            moveNumber++;
+        }
+        replayed.makeMove(move);
+    }
+    if (!text.empty()) {
+        text.pop_back();
+    }
+    return text;
+}
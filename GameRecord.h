@@ -0,0 +1,102 @@
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include <string>
+#include <vector>
+#include "PackedMove.h"
+#include "Position.h"
+
+/**
+ * @brief The GameRecord class stores the moves of a game compactly.
+ *
+ * The moves are a flat array of 16-bit PackedMove values. Every
+ * CheckpointInterval plies the position is kept as well, so the position at
+ * any ply is rebuilt by replaying fewer than CheckpointInterval moves from
+ * the checkpoint before it; taking back a move costs the same bounded
+ * replay. A game therefore takes about three bytes per ply, and the arrays
+ * are reserved for DefaultPlies plies when the game starts, so recording a
+ * game of normal length never allocates.
+ */
+class GameRecord {
+public:
+    static const int CheckpointInterval = 16;   ///< Plies between stored positions.
+    static const int DefaultPlies = 256;        ///< Plies reserved by reset().
+
+    /**
+     * @brief Constructor for the GameRecord class, starting from the initial position.
+     */
+    GameRecord();
+
+    /**
+     * @brief Forget the moves and start again from a position.
+     *
+     * @param start The position before the first move.
+     */
+    void reset(const Position& start);
+
+    /**
+     * @brief Get the position before the first move.
+     */
+    const Position& start() const { return checkpoints[0]; }
+
+    /**
+     * @brief Get the position after the last move.
+     */
+    const Position& current() const { return position; }
+
+    /**
+     * @brief Get the number of recorded plies.
+     */
+    int length() const { return static_cast<int>(moves.size()); }
+
+    /**
+     * @brief Get the packed move of a ply.
+     */
+    PackedMove operator[](int ply) const { return moves[ply]; }
+
+    /**
+     * @brief Record a move played in the current position.
+     *
+     * @param move A legal move of current().
+     * @throw std::runtime_error if the move is not legal.
+     */
+    void push(const BoardMove& move);
+
+    /**
+     * @brief Remove the last move, if any.
+     */
+    void takeBack();
+
+    /**
+     * @brief Rebuild the position before a ply.
+     *
+     * @param ply From 0 (the start) to length() (the current position).
+     * @return The position.
+     */
+    Position positionAt(int ply) const;
+
+    /**
+     * @brief Get the full move of a ply.
+     *
+     * @param ply From 0 to length() - 1.
+     * @return The move, as generated in positionAt(ply).
+     */
+    BoardMove moveAt(int ply) const;
+
+    /**
+     * @brief Get the bytes used by the moves and checkpoints.
+     */
+    size_t memoryBytes() const { return moves.size() * sizeof(PackedMove) + checkpoints.size() * sizeof(Position); }
+
+    /**
+     * @brief Format the moves with move numbers, e.g. "1. c3-d4 f6-e5 2. ...".
+     */
+    std::string toString() const;
+
+private:
+    std::vector<PackedMove> moves;          ///< One packed move per ply.
+    std::vector<Position> checkpoints;      ///< Position before ply k * CheckpointInterval.
+    Position position;                      ///< Position after the last move.
+};
+
+#endif
@@ -0,0 +1,142 @@
+#include "GameScheduler.h"
+
+/**
+ * @file GameScheduler.cpp
+ * @brief Implementation of the coroutine game scheduler.
+ */
+
+void GameTask::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+    // The frame may be destroyed from its own final suspension point
+    GameScheduler* scheduler = handle.promise().scheduler;
+    std::exception_ptr exception = handle.promise().exception;
+    handle.destroy();
+    scheduler->finished(exception);
+}
+
+GameScheduler::GameScheduler(int threads) : live(0), resumeCount(0), stopping(false) {
+    for (int i = 0; i < (threads > 0 ? threads : 1); i++) {
+        this->threads.emplace_back(&GameScheduler::work, this);
+    }
+}
+
+GameScheduler::~GameScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    readyCondition.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void GameScheduler::spawn(GameTask task) {
+    std::coroutine_handle<GameTask::promise_type> handle = task.handle;
+    task.handle = nullptr;
+    handle.promise().scheduler = this;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        live++;
+    }
+    schedule(handle);
+}
+
+void GameScheduler::schedule(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(handle);
+    }
+    readyCondition.notify_one();
+}
+
+void GameScheduler::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return live == 0; });
+    if (error) {
+        std::exception_ptr first = error;
+        error = nullptr;
+        std::rethrow_exception(first);
+    }
+}
+
+long long GameScheduler::resumes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return resumeCount;
+}
+
+void GameScheduler::finished(std::exception_ptr exception) {
+    bool last;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (exception && !error) {
+            error = exception;
+        }
+        last = --live == 0;
+    }
+    if (last) {
+        doneCondition.notify_all();
+    }
+}
+
+void GameScheduler::work() {
+    while (true) {
+        std::coroutine_handle<> handle;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            readyCondition.wait(lock, [this] { return stopping || !ready.empty(); });
+            if (ready.empty()) {
+                return;
+            }
+            handle = ready.front();
+            ready.pop_front();
+            resumeCount++;
+        }
+        // Runs until the game awaits something or finishes; either way the
+        // handle may already belong to another thread when this returns
+        handle.resume();
+    }
+}
+
+bool MoveInbox::Awaiter::await_suspend(std::coroutine_handle<> handle) {
+    std::lock_guard<std::mutex> lock(inbox.mutex);
+    if (!inbox.moves.empty()) {
+        return false;
+    }
+    inbox.waiting = handle;
+    inbox.wanted.notify_all();
+    return true;
+}
+
+std::string MoveInbox::Awaiter::await_resume() {
+    std::lock_guard<std::mutex> lock(inbox.mutex);
+    std::string move = inbox.moves.front();
+    inbox.moves.pop_front();
+    return move;
+}
+
+void MoveInbox::post(const std::string& move) {
+    std::coroutine_handle<> handle;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        moves.push_back(move);
+        handle = waiting;
+        waiting = nullptr;
+    }
+    if (handle) {
+        scheduler.schedule(handle);
+    }
+}
+
+void MoveInbox::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+    wanted.notify_all();
+}
+
+bool MoveInbox::waitUntilWanted() {
+    std::unique_lock<std::mutex> lock(mutex);
+    wanted.wait(lock, [this] { return closed || (waiting && moves.empty()); });
+    return !closed;
+}
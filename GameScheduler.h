@@ -0,0 +1,210 @@
+#ifndef GAMESCHEDULER_H
+#define GAMESCHEDULER_H
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class GameScheduler;
+
+/**
+ * @brief The GameTask class is a game written as a C++20 coroutine.
+ *
+ * A function returning GameTask is a coroutine that does not run until it is
+ * given to GameScheduler::spawn(). From then on it runs on the scheduler's
+ * threads, suspending with co_await whenever it waits for a move (see
+ * MoveInbox and EnginePool), so a waiting game holds no thread. When the
+ * coroutine returns its frame is destroyed and the scheduler is told.
+ */
+class GameTask {
+public:
+    /**
+     * @brief The promise_type struct is the coroutine's state as seen by the compiler.
+     */
+    struct promise_type {
+        GameScheduler* scheduler = nullptr;     ///< Set by GameScheduler::spawn().
+        std::exception_ptr exception;           ///< Exception that ended the game, if any.
+
+        GameTask get_return_object() { return GameTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+
+        /**
+         * @brief The FinalAwaiter struct destroys the finished coroutine and tells the scheduler.
+         */
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+            void await_resume() noexcept {}
+        };
+
+        FinalAwaiter final_suspend() noexcept { return {}; }
+    };
+
+    GameTask(GameTask&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    GameTask(const GameTask&) = delete;
+    GameTask& operator=(const GameTask&) = delete;
+
+    /**
+     * @brief Destroy a coroutine that was never spawned.
+     */
+    ~GameTask() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+private:
+    friend class GameScheduler;
+
+    std::coroutine_handle<promise_type> handle;     ///< The coroutine, null once spawned.
+
+    explicit GameTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+};
+
+/**
+ * @brief The GameScheduler class runs game coroutines on a fixed number of threads.
+ *
+ * Ready coroutines wait in one FIFO queue; each thread takes the next one and
+ * resumes it until it suspends again or finishes. Whatever a game waits for
+ * puts it back in the queue with schedule() when the wait is over, from any
+ * thread. Thousands of games waiting for moves therefore cost their
+ * coroutine frames and nothing else.
+ */
+class GameScheduler {
+public:
+    /**
+     * @brief Constructor for the GameScheduler class, starts the threads.
+     *
+     * @param threads Number of threads, at least one.
+     */
+    explicit GameScheduler(int threads);
+
+    /**
+     * @brief Stop the threads. Call wait() first: unfinished games are leaked.
+     */
+    ~GameScheduler();
+
+    GameScheduler(const GameScheduler&) = delete;
+    GameScheduler& operator=(const GameScheduler&) = delete;
+
+    /**
+     * @brief Start a game.
+     *
+     * @param task The coroutine; it is queued to run on a scheduler thread.
+     */
+    void spawn(GameTask task);
+
+    /**
+     * @brief Queue a suspended coroutine to be resumed. Thread-safe.
+     */
+    void schedule(std::coroutine_handle<> handle);
+
+    /**
+     * @brief Wait until every spawned game has finished.
+     *
+     * @throw The first exception that ended a game, after all have finished.
+     */
+    void wait();
+
+    /**
+     * @brief Get the number of threads.
+     */
+    int size() const { return static_cast<int>(threads.size()); }
+
+    /**
+     * @brief Get the number of times a coroutine was resumed.
+     */
+    long long resumes() const;
+
+private:
+    friend struct GameTask::promise_type::FinalAwaiter;
+
+    mutable std::mutex mutex;                       ///< Guards every member below except threads.
+    std::condition_variable readyCondition;         ///< Signalled when a coroutine is queued or on shutdown.
+    std::condition_variable doneCondition;          ///< Signalled when the last game finishes.
+    std::deque<std::coroutine_handle<>> ready;      ///< Coroutines waiting for a thread.
+    int live;                                       ///< Spawned games not finished.
+    long long resumeCount;                          ///< Coroutines resumed.
+    bool stopping;                                  ///< Set by the destructor.
+    std::exception_ptr error;                       ///< First exception that ended a game.
+    std::vector<std::thread> threads;               ///< The threads.
+
+    /**
+     * @brief Record that a game has finished. Called by its final suspension.
+     */
+    void finished(std::exception_ptr exception);
+
+    /**
+     * @brief Loop of a scheduler thread.
+     */
+    void work();
+};
+
+/**
+ * @brief The MoveInbox class delivers moves from outside, such as a console or a network connection, to a game.
+ *
+ * The game awaits next(); another thread calls post() when the move arrives.
+ * A move posted before it is awaited is kept until then.
+ */
+class MoveInbox {
+public:
+    /**
+     * @brief Constructor for the MoveInbox class.
+     *
+     * @param scheduler The scheduler running the game that reads the inbox.
+     */
+    explicit MoveInbox(GameScheduler& scheduler) : scheduler(scheduler), waiting(nullptr), closed(false) {}
+
+    /**
+     * @brief The Awaiter class suspends a game until a move has been posted.
+     */
+    class Awaiter {
+    public:
+        explicit Awaiter(MoveInbox& inbox) : inbox(inbox) {}
+        bool await_ready() const { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        std::string await_resume();
+
+    private:
+        MoveInbox& inbox;       ///< The inbox awaited.
+    };
+
+    /**
+     * @brief Wait for the next move. Use as `std::string text = co_await inbox.next();`.
+     */
+    Awaiter next() { return Awaiter(*this); }
+
+    /**
+     * @brief Deliver a move text. Thread-safe.
+     */
+    void post(const std::string& move);
+
+    /**
+     * @brief Tell the sender that no more moves will be read.
+     */
+    void close();
+
+    /**
+     * @brief Block until the game is waiting for a move with none queued.
+     *
+     * @return False if the inbox was closed instead.
+     */
+    bool waitUntilWanted();
+
+private:
+    GameScheduler& scheduler;               ///< Resumes the waiting game.
+    std::mutex mutex;                       ///< Guards the members below.
+    std::condition_variable wanted;         ///< Signalled when a game starts waiting or the inbox closes.
+    std::deque<std::string> moves;          ///< Moves posted and not read yet.
+    std::coroutine_handle<> waiting;        ///< The game waiting for a move, or null.
+    bool closed;                            ///< Set by close().
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef GAMESTATE_HPP
 #define GAMESTATE_HPP
 
+#include "MemoryAccounting.h"
 
 /**
  * @brief The GameState class represents a state of the chess game.
@@ -19,6 +20,16 @@ public:
      */
     virtual void displayState() = 0;
 
+    /**
+     * @brief Allocate game states in the MemoryTag::Board account.
+     */
+    static void* operator new(size_t size) { return MemoryAccounting::allocateOrThrow(size, MemoryTag::Board); }
+
+    /**
+     * @brief Free game states allocated by operator new.
+     */
+    static void operator delete(void* memory) noexcept { MemoryAccounting::release(memory); }
+
     /**
      * @brief Virtual destructor for the GameState class.
      */
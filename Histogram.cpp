@@ -0,0 +1,118 @@
+#include "Histogram.h"
+#include <iomanip>
+
+/**
+ * @file Histogram.cpp
+ * @brief Implementation of the lock-free log-linear histogram.
+ */
+
+namespace {
+    /**
+     * @brief Get the index of the highest set bit of a non-zero value.
+     */
+    int highestBit(uint64_t value) {
+        int bit = 0;
+        while (value >>= 1) {
+            bit++;
+        }
+        return bit;
+    }
+}
+
+Histogram::Histogram() {
+    reset();
+}
+
+void Histogram::reset() {
+    for (std::atomic<uint64_t>& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    smallest.store(UINT64_MAX, std::memory_order_relaxed);
+    largest.store(0, std::memory_order_relaxed);
+}
+
+int Histogram::bucketIndex(uint64_t value) {
+    if (value < static_cast<uint64_t>(SubBuckets)) {
+        return static_cast<int>(value);
+    }
+    int exponent = highestBit(value);
+    int sub = static_cast<int>((value >> (exponent - SubBucketBits)) & (SubBuckets - 1));
+    return (exponent - SubBucketBits + 1) * SubBuckets + sub;
+}
+
+uint64_t Histogram::bucketLimit(int index) {
+    if (index < SubBuckets) {
+        return static_cast<uint64_t>(index);
+    }
+    int exponent = index / SubBuckets + SubBucketBits - 1;
+    uint64_t sub = static_cast<uint64_t>(index % SubBuckets);
+    uint64_t width = uint64_t(1) << (exponent - SubBucketBits);
+    return ((SubBuckets + sub) << (exponent - SubBucketBits)) + (width - 1);
+}
+
+void Histogram::record(uint64_t value) {
+    buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t current = smallest.load(std::memory_order_relaxed);
+    while (value < current && !smallest.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+    current = largest.load(std::memory_order_relaxed);
+    while (value > current && !largest.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t Histogram::min() const {
+    return count() > 0 ? smallest.load(std::memory_order_relaxed) : 0;
+}
+
+double Histogram::mean() const {
+    uint64_t samples = count();
+    return samples > 0 ? static_cast<double>(sum.load(std::memory_order_relaxed)) / samples : 0.0;
+}
+
+uint64_t Histogram::percentile(double percent) const {
+    uint64_t samples = count();
+    if (samples == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(percent / 100.0 * samples + 0.5);
+    rank = rank < 1 ? 1 : (rank > samples ? samples : rank);
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BucketCount; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t limit = bucketLimit(i);
+            return limit < max() ? limit : max();
+        }
+    }
+    return max();
+}
+
+void Histogram::writeJson(std::ostream& stream, double scale) const {
+    // Unscaled values are written as integers so that large counts keep every digit
+    auto write = [&stream, scale](const char* name, uint64_t value) {
+        stream << ", \"" << name << "\": ";
+        if (scale == 1.0) {
+            stream << value;
+        }
+        else {
+            stream << value / scale;
+        }
+    };
+
+    stream << "{\"count\": " << count();
+    write("min", min());
+    stream << ", \"mean\": " << std::fixed << std::setprecision(2) << mean() / scale << std::defaultfloat << std::setprecision(6);
+    write("p50", percentile(50.0));
+    write("p90", percentile(90.0));
+    write("p99", percentile(99.0));
+    write("p999", percentile(99.9));
+    write("max", max());
+    stream << "}";
+}
@@ -1,4 +1,5 @@
 #include "HumanPlayer.h"
+#include "Trace.h"
 #include <iostream>
 
 /**
@@ -41,39 +42,32 @@ int HumanPlayer::convertCoordinate(char coordinate) {
  * @param isWhitePlayerTurn Whether it's the white player's turn.
  */
 void HumanPlayer::makeMove(Board& board, bool isWhitePlayerTurn) {
-    int maxCapturingMoves = 0;
-
-    // Find the maximum number of capturing moves available
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            Square* square = board.getSquare(row, col);
-            Piece* piece = square->getPiece();
-
-            if (piece != nullptr && piece->isWhite() == isWhitePlayerTurn) {
-                int capturingMoves = piece->countCapturingMoves(board, *square, isWhitePlayerTurn);
-                maxCapturingMoves = std::max(maxCapturingMoves, capturingMoves);
-            }
-        }
-    }
+    // Generate the legal moves and the capture tree once for the whole turn
+    Position position = board.toPosition(isWhitePlayerTurn);
+    MoveList moves;
+    position.generateMoves(moves);
+    captureTree.build(position, moves);
 
+    int maxCapturingMoves = captureTree.length();
     std::cout << "Max possible capturing on board: " << maxCapturingMoves << std::endl;
     bool canCapture = (maxCapturingMoves > 0);
 
-    int startYNumeric, startXNumeric;
-
-    // Loop until a valid piece is selected
+    // Loop until a complete valid move is entered
     while (true) {
         char startY, startX;
         std::cout << "Enter the starting position (x, y): ";
-        std::cin >> startX >> startY;
+        {
+            TRACE_SCOPE("wait for input");
+            std::cin >> startX >> startY;
+        }
 
         // Convert letter coordinates to numeric coordinates
-        startYNumeric = convertCoordinate(startY);
-        startXNumeric = convertCoordinate(startX);
+        int startYNumeric = convertCoordinate(startY);
+        int startXNumeric = convertCoordinate(startX);
+        int start = Position::squareIndex(startYNumeric, startXNumeric);
 
         // Get the corresponding square from the board
-        Square* startSquare = board.getSquare(startYNumeric, startXNumeric);
-        Piece* piece = startSquare->getPiece();
+        Piece* piece = board.getSquare(startYNumeric, startXNumeric)->getPiece();
 
         if (piece == nullptr) {
             std::cout << "Invalid move: No piece at the starting position." << std::endl;
@@ -85,97 +79,58 @@ void HumanPlayer::makeMove(Board& board, bool isWhitePlayerTurn) {
             continue;
         }
 
-        int maxCapturing = piece->countCapturingMoves(board, *startSquare, isWhitePlayerTurn);
-        if (canCapture && maxCapturing == 0) {
-            std::cout << "Invalid move: This piece cannot capture." << std::endl;
-            continue;
-        }
-
-        if (maxCapturing > 0) {
-            std::cout << "Possible capturing for selected " << piece->getType() << ": " << maxCapturing << std::endl;
-        }
-
         if (!canCapture) {
             char endY, endX;
-            int endYNumeric, endXNumeric;
-
             std::cout << "Enter the ending position (x, y): ";
-            std::cin >> endX >> endY;
-
-            endYNumeric = convertCoordinate(endY);
-            endXNumeric = convertCoordinate(endX);
+            {
+                TRACE_SCOPE("wait for input");
+                std::cin >> endX >> endY;
+            }
 
-            Square* endSquare = board.getSquare(endYNumeric, endXNumeric);
+            int end = Position::squareIndex(convertCoordinate(endY), convertCoordinate(endX));
+            int found = -1;
+            for (int i = 0; i < moves.count; i++) {
+                if (moves[i].from == start && moves[i].to == end) {
+                    found = i;
+                }
+            }
 
             // Check if the piece can move to the ending position
-            if (!piece->canMove(board, *startSquare, *endSquare, !isWhitePlayerTurn)) {
+            if (found < 0) {
                 std::cout << "Invalid move: The piece cannot move to the ending position." << std::endl;
                 continue;
             }
 
-            // Check for promotion to a queen
-            if (piece->getType() == "Pawn" && ((isWhitePlayerTurn && endYNumeric == 0) || (!isWhitePlayerTurn && endYNumeric == 7))) {
-                board.updateSquare(startYNumeric, startXNumeric, nullptr);
-                board.promoteQueen(endYNumeric, endXNumeric, piece);
-                return;
-            }
-
-            // Move your piece to the end square (without capturing)
-            endSquare->SetPiece(piece);
-            startSquare->SetPiece(nullptr);
+            board.applyMove(moves[found]);
             return;
         }
-        else {
-            // Handle capturing moves
-            std::vector<Square*> capturedPawnPositions;
-            int capturingCount = 0;
-            Square* currentSquare = startSquare;
 
-            while (capturingCount < maxCapturingMoves) {
-                char endY, endX;
-                int endYNumeric, endXNumeric;
+        // Handle capturing moves: follow the typed hops through the capture tree
+        int node = captureTree.root(start);
+        if (node == CaptureTree::None) {
+            std::cout << "Invalid move: This piece cannot capture." << std::endl;
+            continue;
+        }
+        std::cout << "Possible capturing for selected " << piece->getType() << ": " << maxCapturingMoves << std::endl;
 
-                std::cout << "Enter the ending position (x, y) for capture: ";
+        while (node != CaptureTree::None && !captureTree.isComplete(node)) {
+            char endY, endX;
+            std::cout << "Enter the ending position (x, y) for capture: ";
+            {
+                TRACE_SCOPE("wait for input");
                 std::cin >> endX >> endY;
-
-                endYNumeric = convertCoordinate(endY);
-                endXNumeric = convertCoordinate(endX);
-
-                Square* endSquare = board.getSquare(endYNumeric, endXNumeric);
-
-                if (piece->getType() == "Pawn") {
-                    Pawn* pawn = static_cast<Pawn*>(piece);
-                    if (pawn->simulateAndValidateCapturingMoves(board, *currentSquare, isWhitePlayerTurn, capturedPawnPositions, maxCapturingMoves, *endSquare, piece)) {
-                        capturingCount++;
-                        currentSquare = endSquare; // Update current square to new position after capturing
-                        // If there are more captures possible, continue; otherwise, break
-                        if (capturingCount >= maxCapturingMoves || piece->countCapturingMoves(board, *currentSquare, isWhitePlayerTurn) == 0) {
-                            break;
-                        }
-                    }
-                    else {
-                        // If the function returns false, restore captured enemy pawns to the board
-                        for (const auto& square : capturedPawnPositions) {
-                            square->SetPiece(new Pawn(!isWhitePlayerTurn)); // Create a new enemy pawn and place it back on the board
-                        }
-                        capturedPawnPositions.clear();
-                        startSquare->SetPiece(new Pawn(isWhitePlayerTurn));
-
-                        std::cout << "Invalid move: The piece cannot move to the ending position." << std::endl;
-                        break;
-                    }
-                }
             }
-            return;
-        }
-    }
-}
-
-
-
-
-
 
+            node = captureTree.hop(node, Position::squareIndex(convertCoordinate(endY), convertCoordinate(endX)));
+        }
 
+        if (node == CaptureTree::None) {
+            // Nothing was changed on the board, so the whole capture is simply entered again
+            std::cout << "Invalid move: The piece cannot move to the ending position." << std::endl;
+            continue;
+        }
 
- 
+        board.applyMove(moves[captureTree.moveIndex(node)]);
+        return;
+    }
+}
@@ -2,12 +2,17 @@
 #define HUMANPLAYER_H
 
 #include "Player.h"
+#include "CaptureTree.h"
 
 /**
  * @brief The HumanPlayer class represents a human player in a chess game.
  *
  * This class is a subclass of the Player class and is responsible for allowing
  * a human player to make moves on the chess board.
+ *
+ * Typed moves are checked against the legal moves of the position, which are
+ * generated once per turn; captures are checked hop by hop against a
+ * CaptureTree. The board is only changed when a complete move has been entered.
  */
 class HumanPlayer : public Player {
 public:
@@ -22,7 +27,8 @@ public:
      * @brief Make a move on the chess board during the human player's turn.
      *
      * This function is responsible for allowing the human player to select and make
-     * a move on the given chess board.
+     * a move on the given chess board. When a capture is possible, the landing
+     * square of every jump is asked for until the longest capture is complete.
      *
      * @param board The chess board on which the move is to be made.
      * @param isWhitePlayerTurn Indicates whether it is the white player's turn.
@@ -39,6 +45,9 @@ public:
      * @return The numeric coordinate (0-7) corresponding to the character coordinate.
      */
     int convertCoordinate(char coordinate);
+
+private:
+    CaptureTree captureTree; ///< Legal capture sequences of the current turn.
 };
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file MappedFile.cpp
+ * @brief Implementation of the portable read-only file mapping.
+ */
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) : bytes(nullptr), length(0), file(INVALID_HANDLE_VALUE), mapping(nullptr) {
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot get the size of " + path);
+    }
+    length = static_cast<size_t>(size.QuadPart);
+    if (length == 0) {
+        return;
+    }
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+        bytes = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (bytes == nullptr) {
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        throw std::runtime_error("Cannot map " + path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (bytes != nullptr) {
+        UnmapViewOfFile(bytes);
+    }
+    if (mapping != nullptr) {
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) : bytes(nullptr), length(0) {
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        close(file);
+        throw std::runtime_error("Cannot get the size of " + path);
+    }
+    length = static_cast<size_t>(status.st_size);
+
+    // The mapping stays valid after the descriptor is closed
+    if (length > 0) {
+        void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, file, 0);
+        if (address == MAP_FAILED) {
+            close(file);
+            throw std::runtime_error("Cannot map " + path);
+        }
+        bytes = static_cast<const unsigned char*>(address);
+    }
+    close(file);
+}
+
+MappedFile::~MappedFile() {
+    if (bytes != nullptr) {
+        munmap(const_cast<unsigned char*>(bytes), length);
+    }
+}
+
+#endif
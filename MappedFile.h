@@ -0,0 +1,51 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief The MappedFile class maps a whole file into memory for reading.
+ *
+ * The pages are loaded by the operating system when they are first touched,
+ * so opening even a large file is immediate and only the parts that are read
+ * cost memory. Like Socket it hides the differences between Windows and POSIX.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Map a file.
+     *
+     * @param path The file.
+     * @throw std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path);
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Get the contents, null for an empty file.
+     */
+    const unsigned char* data() const { return bytes; }
+
+    /**
+     * @brief Get the size in bytes.
+     */
+    size_t size() const { return length; }
+
+private:
+    const unsigned char* bytes;     ///< Start of the mapping.
+    size_t length;                  ///< Size of the file.
+#ifdef _WIN32
+    void* file;                     ///< File handle.
+    void* mapping;                  ///< File mapping handle.
+#endif
+};
+
+#endif
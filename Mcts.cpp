@@ -0,0 +1,252 @@
+#include "Mcts.h"
+#include "Evaluation.h"
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+/**
+ * @file Mcts.cpp
+ * @brief Implementation of the tree-parallel Monte Carlo tree search.
+ */
+
+namespace {
+    const int MaxTreeDepth = 256;           // Longest path followed from the root
+    const double Exploration = 1.0;         // UCT exploration constant
+    const int DecisiveScore = 150;          // Evaluation that decides a cut-off playout
+    const uint32_t NoNode = UINT32_MAX;
+
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}
+
+MctsNodePool::MctsNodePool(size_t capacity) : nodes(capacity), next(0) {}
+
+uint32_t MctsNodePool::allocate(uint32_t count) {
+    // Check first so that a full pool does not keep advancing the counter
+    if (static_cast<size_t>(next.load(std::memory_order_relaxed)) + count > nodes.size()) {
+        return NoNode;
+    }
+
+    uint32_t first = next.fetch_add(count, std::memory_order_relaxed);
+    if (static_cast<size_t>(first) + count > nodes.size()) {
+        return NoNode;
+    }
+
+    for (uint32_t i = first; i < first + count; i++) {
+        nodes[i].visits.store(0, std::memory_order_relaxed);
+        nodes[i].score.store(0, std::memory_order_relaxed);
+        nodes[i].firstChild.store(0, std::memory_order_relaxed);
+        nodes[i].state.store(0, std::memory_order_relaxed);
+        nodes[i].childCount = 0;
+    }
+    return first;
+}
+
+void MctsNodePool::reset() {
+    next.store(0, std::memory_order_relaxed);
+}
+
+size_t MctsNodePool::used() const {
+    size_t allocated = next.load(std::memory_order_relaxed);
+    return allocated < nodes.size() ? allocated : nodes.size();
+}
+
+MctsSearch::MctsSearch(size_t nodeCapacity, int threads)
+    : pool(nodeCapacity), threads(threads > 0 ? threads : 1), stopFlag(false), playoutCount(0) {}
+
+MctsResult MctsSearch::search(const Position& root, int milliseconds, long long maxPlayouts) {
+    MctsResult result = {};
+    auto start = std::chrono::steady_clock::now();
+
+    MoveList rootMoves;
+    root.generateMoves(rootMoves);
+    result.hasMove = rootMoves.count > 0;
+    if (rootMoves.count <= 1) {
+        // Nothing to think about
+        if (result.hasMove) {
+            result.bestMove = rootMoves[0];
+            result.winRate = 0.5;
+        }
+        return result;
+    }
+
+    pool.reset();
+    pool.allocate(1);
+    stopFlag.store(false);
+    playoutCount.store(0);
+
+    // The calling thread searches too, the others join it
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threads; i++) {
+        helpers.emplace_back(&MctsSearch::worker, this, std::cref(root), 0x9E3779B9u * (i + 1));
+    }
+
+    auto deadline = start + std::chrono::milliseconds(milliseconds);
+    uint32_t random = 0x2545F491u;
+    while (!stopFlag.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < 32; i++) {
+            iterate(root, random);
+        }
+        if (std::chrono::steady_clock::now() >= deadline || (maxPlayouts > 0 && playoutCount.load() >= maxPlayouts)) {
+            stopFlag.store(true);
+        }
+    }
+
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    // Play the most visited move
+    MctsNode& rootNode = pool[0];
+    int bestIndex = 0;
+    int32_t bestVisits = -1;
+    if (rootNode.state.load() == 2) {
+        for (int i = 0; i < rootNode.childCount; i++) {
+            MctsNode& child = pool[rootNode.firstChild.load() + i];
+            if (child.visits.load() > bestVisits) {
+                bestVisits = child.visits.load();
+                bestIndex = i;
+            }
+        }
+        MctsNode& best = pool[rootNode.firstChild.load() + bestIndex];
+        result.winRate = best.visits.load() > 0 ? best.score.load() / (2.0 * best.visits.load()) : 0.5;
+    }
+
+    result.bestMove = rootMoves[bestIndex];
+    result.playouts = playoutCount.load();
+    result.nodes = pool.used();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void MctsSearch::worker(const Position& root, uint32_t seed) {
+    uint32_t random = seed;
+    while (!stopFlag.load(std::memory_order_relaxed)) {
+        iterate(root, random);
+    }
+}
+
+void MctsSearch::iterate(const Position& root, uint32_t& random) {
+    Position position = root;
+    uint32_t path[MaxTreeDepth];
+    int depth = 0;
+
+    uint32_t index = 0;
+    pool[index].visits.fetch_add(VirtualLoss, std::memory_order_relaxed);
+    path[depth++] = index;
+
+    // Selection: follow UCT down to a leaf, expanding it if it was visited before
+    while (depth < MaxTreeDepth) {
+        MctsNode& node = pool[index];
+
+        if (node.state.load(std::memory_order_acquire) != 2) {
+            if (node.state.load(std::memory_order_relaxed) == 0 && node.visits.load(std::memory_order_relaxed) > VirtualLoss) {
+                expand(index, position);
+            }
+            if (node.state.load(std::memory_order_acquire) != 2) {
+                break;
+            }
+        }
+        if (node.childCount == 0) {
+            break;
+        }
+
+        uint32_t first = node.firstChild.load(std::memory_order_relaxed);
+        double logVisits = std::log(static_cast<double>(node.visits.load(std::memory_order_relaxed)) + 1.0);
+        int bestChild = 0;
+        double bestValue = -1.0;
+
+        for (int i = 0; i < node.childCount; i++) {
+            MctsNode& child = pool[first + i];
+            int32_t visits = child.visits.load(std::memory_order_relaxed);
+            if (visits == 0) {
+                bestChild = i;
+                break;
+            }
+            double value = child.score.load(std::memory_order_relaxed) / (2.0 * visits) + Exploration * std::sqrt(logVisits / visits);
+            if (value > bestValue) {
+                bestValue = value;
+                bestChild = i;
+            }
+        }
+
+        MoveList list;
+        position.generateMoves(list);
+        position.makeMove(list[bestChild]);
+
+        index = first + bestChild;
+        pool[index].visits.fetch_add(VirtualLoss, std::memory_order_relaxed);
+        path[depth++] = index;
+    }
+
+    int winner = playout(position, random);
+
+    // Backup: each node is scored for the side that made the move leading to it
+    for (int d = 0; d < depth; d++) {
+        bool moverWhite = (d % 2 == 1) ? root.whiteToMove : !root.whiteToMove;
+        int points = winner == 0 ? 1 : ((winner > 0) == moverWhite ? 2 : 0);
+        MctsNode& node = pool[path[d]];
+        node.visits.fetch_add(1 - VirtualLoss, std::memory_order_relaxed);
+        node.score.fetch_add(points, std::memory_order_relaxed);
+    }
+
+    playoutCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MctsSearch::expand(uint32_t index, const Position& position) {
+    MctsNode& node = pool[index];
+    uint8_t expected = 0;
+    if (!node.state.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+        return; // Another thread is expanding it
+    }
+
+    MoveList list;
+    position.generateMoves(list);
+
+    if (list.count > 0) {
+        uint32_t first = pool.allocate(static_cast<uint32_t>(list.count));
+        if (first == NoNode) {
+            // Pool exhausted: the node stays a leaf
+            node.state.store(0, std::memory_order_release);
+            return;
+        }
+        node.firstChild.store(first, std::memory_order_relaxed);
+    }
+
+    node.childCount = static_cast<uint8_t>(list.count);
+    node.state.store(2, std::memory_order_release);
+}
+
+int MctsSearch::playout(Position position, uint32_t& random) {
+    for (int ply = 0; ply < MaxPlayoutPlies; ply++) {
+        MoveList list;
+        position.generateMoves(list);
+        if (list.count == 0) {
+            // The side to move is blocked or has no pieces left and loses
+            return position.whiteToMove ? -1 : 1;
+        }
+
+        // Light guidance: take a promotion half of the time it is available
+        int choice = static_cast<int>(nextRandom(random) % static_cast<uint32_t>(list.count));
+        if ((nextRandom(random) & 1u) != 0) {
+            for (int i = 0; i < list.count; i++) {
+                if (list[i].promotes) {
+                    choice = i;
+                    break;
+                }
+            }
+        }
+
+        position.makeMove(list[choice]);
+    }
+
+    int score = Evaluation::evaluate(position);
+    if (!position.whiteToMove) {
+        score = -score;
+    }
+    return score > DecisiveScore ? 1 : (score < -DecisiveScore ? -1 : 0);
+}
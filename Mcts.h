@@ -0,0 +1,158 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "Position.h"
+
+/**
+ * @brief The MctsNode struct is one node of the Monte Carlo search tree.
+ *
+ * A node does not store its move: the children of a node are allocated as one
+ * contiguous block in the order produced by Position::generateMoves, so child i
+ * corresponds to move i of the parent position. All fields are atomics because
+ * several threads walk and update the same tree.
+ */
+struct MctsNode {
+    std::atomic<int32_t> visits;       ///< Visits, including pending virtual losses.
+    std::atomic<int32_t> score;        ///< Sum of results in half points (win 2, draw 1, loss 0).
+    std::atomic<uint32_t> firstChild;  ///< Pool index of the first child.
+    std::atomic<uint8_t> state;        ///< 0 - leaf, 1 - being expanded, 2 - expanded.
+    uint8_t childCount;                ///< Number of children once expanded.
+};
+
+/**
+ * @brief The MctsNodePool class is a bump allocator for tree nodes.
+ *
+ * All nodes live in one preallocated array so that expanding a node is a single
+ * atomic add and the whole tree is released at once by reset().
+ */
+class MctsNodePool {
+public:
+    /**
+     * @brief Constructor for the MctsNodePool class.
+     *
+     * @param capacity Maximum number of nodes.
+     */
+    explicit MctsNodePool(size_t capacity);
+
+    /**
+     * @brief Allocate a block of consecutive nodes.
+     *
+     * @param count Number of nodes to allocate.
+     * @return Index of the first node, or UINT32_MAX if the pool is full.
+     */
+    uint32_t allocate(uint32_t count);
+
+    /**
+     * @brief Release all nodes.
+     */
+    void reset();
+
+    /**
+     * @brief Get a node by index.
+     *
+     * @param index The node index.
+     * @return Reference to the node.
+     */
+    MctsNode& operator[](uint32_t index) { return nodes[index]; }
+
+    /**
+     * @brief Get the number of nodes in use.
+     *
+     * @return The number of allocated nodes.
+     */
+    size_t used() const;
+
+    /**
+     * @brief Get the maximum number of nodes.
+     *
+     * @return The capacity of the pool.
+     */
+    size_t capacity() const { return nodes.size(); }
+
+private:
+    std::vector<MctsNode> nodes;    ///< Node storage.
+    std::atomic<uint32_t> next;     ///< Index of the first free node.
+};
+
+/**
+ * @brief The MctsResult struct reports the outcome of an MCTS search.
+ */
+struct MctsResult {
+    BoardMove bestMove;       ///< The most visited root move.
+    bool hasMove;             ///< False if the root position has no legal move.
+    long long playouts;       ///< Number of playouts run.
+    double seconds;           ///< Wall time of the search.
+    size_t nodes;             ///< Number of tree nodes allocated.
+    double winRate;           ///< Expected score of the best move (0-1) for the side to move.
+};
+
+/**
+ * @brief The MctsSearch class runs a tree-parallel Monte Carlo tree search.
+ *
+ * Every thread repeatedly selects a leaf with UCT, expands it, plays a lightly
+ * guided random game to the end and backs the result up. Threads share one tree
+ * and use virtual losses to spread over different branches.
+ */
+class MctsSearch {
+public:
+    static const int VirtualLoss = 3;        ///< Visits added to a node while a thread is below it.
+    static const int MaxPlayoutPlies = 120;  ///< Playouts longer than this are scored by Evaluation.
+
+    /**
+     * @brief Constructor for the MctsSearch class.
+     *
+     * @param nodeCapacity Size of the node pool.
+     * @param threads Number of search threads.
+     */
+    MctsSearch(size_t nodeCapacity, int threads);
+
+    /**
+     * @brief Search a position.
+     *
+     * @param root The position to search.
+     * @param milliseconds Thinking time.
+     * @param maxPlayouts Stop after this many playouts (0 for no limit).
+     * @return The best move and search statistics.
+     */
+    MctsResult search(const Position& root, int milliseconds, long long maxPlayouts);
+
+    /**
+     * @brief Get the memory used by one tree node.
+     *
+     * @return The size of MctsNode in bytes.
+     */
+    static size_t bytesPerNode() { return sizeof(MctsNode); }
+
+private:
+    MctsNodePool pool;                      ///< Tree storage.
+    int threads;                            ///< Number of search threads.
+    std::atomic<bool> stopFlag;             ///< Set when the search must stop.
+    std::atomic<long long> playoutCount;    ///< Playouts finished so far.
+
+    /**
+     * @brief Body of one search thread.
+     */
+    void worker(const Position& root, uint32_t seed);
+
+    /**
+     * @brief Run one selection, expansion, playout and backup from the root.
+     */
+    void iterate(const Position& root, uint32_t& random);
+
+    /**
+     * @brief Expand a leaf if this thread wins the race to do so.
+     */
+    void expand(uint32_t index, const Position& position);
+
+    /**
+     * @brief Play a random game and return the winner.
+     *
+     * @return 1 if white wins, -1 if black wins, 0 for a draw.
+     */
+    static int playout(Position position, uint32_t& random);
+};
+
+#endif
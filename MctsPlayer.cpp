@@ -0,0 +1,51 @@
+#include "MctsPlayer.h"
+#include "MemoryAccounting.h"
+#include <iostream>
+#include <thread>
+
+/**
+ * @brief Constructor for MctsPlayer class.
+ *
+ * @param whiteside True if the player is playing as the white side, false otherwise.
+ */
+MctsPlayer::MctsPlayer(bool whiteside) : Player() {
+    this->whiteside = whiteside;
+    this->humanPlayer = false;
+
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    MemoryScope scope(MemoryTag::Search);
+    search = new MctsSearch(DefaultNodes, threads > 0 ? threads : 1);
+}
+
+/**
+ * @brief Destructor for MctsPlayer class.
+ */
+MctsPlayer::~MctsPlayer() {
+    delete search;
+}
+
+/**
+ * @brief Make a move on the board for the MCTS player.
+ *
+ * @param board The game board on which the move will be made.
+ * @param isWhitePlayerTurn True if it's the white player's turn, false otherwise.
+ */
+void MctsPlayer::makeMove(Board& board, bool isWhitePlayerTurn) {
+    Position position = board.toPosition(isWhitePlayerTurn);
+    MctsResult result = search->search(position, moveBudget > 0 ? moveBudget : DefaultMilliseconds, 0);
+
+    if (!result.hasMove) {
+        std::cout << getName() << " has no legal move." << std::endl;
+        return;
+    }
+
+    board.applyMove(result.bestMove);
+
+    std::cout << getName() << " plays " << Position::moveToString(result.bestMove) << std::endl;
+    if (result.playouts > 0) {
+        std::cout << "MCTS: " << result.playouts << " playouts in " << result.seconds << " s ("
+            << static_cast<long long>(result.playouts / result.seconds) << " playouts/s), win rate "
+            << result.winRate << ", " << result.nodes << " nodes x " << MctsSearch::bytesPerNode()
+            << " bytes = " << (result.nodes * MctsSearch::bytesPerNode()) / 1024 << " KB" << std::endl;
+    }
+}
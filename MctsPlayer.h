@@ -0,0 +1,45 @@
+#ifndef MCTSPLAYER_H
+#define MCTSPLAYER_H
+
+#include "Player.h"
+#include "Mcts.h"
+
+/**
+ * @brief The MctsPlayer class represents a computer player driven by Monte Carlo tree search.
+ *
+ * It is a complement to ComputerPlayer for unclear middlegames: instead of a
+ * minimax score it plays the move that won most often in random playouts.
+ */
+class MctsPlayer : public Player {
+public:
+    static const int DefaultMilliseconds = 1000;     ///< Thinking time per move in untimed games.
+    static const size_t DefaultNodes = 1 << 22;      ///< Size of the node pool.
+
+    /**
+     * @brief Constructor for the MctsPlayer class.
+     *
+     * @param whiteside Indicates whether the player is playing as the white side.
+     */
+    MctsPlayer(bool whiteside);
+
+    /**
+     * @brief Destructor for the MctsPlayer class.
+     */
+    ~MctsPlayer();
+
+    /**
+     * @brief Search the board with MCTS and play the best move.
+     *
+     * The playout rate and the tree memory are printed after the move so that
+     * the node pool and thinking time can be sized.
+     *
+     * @param board The chess board on which the move is to be made.
+     * @param isWhitePlayerTurn Indicates whether it is the white player's turn.
+     */
+    virtual void makeMove(Board& board, bool isWhitePlayerTurn) override;
+
+private:
+    MctsSearch* search; ///< The search and its node pool, reused between moves.
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include "MemoryAccounting.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+/**
+ * @file MemoryAccounting.cpp
+ * @brief Implementation of the per-subsystem heap accounting and the replaced global operator new.
+ */
+
+namespace {
+    const int TagCount = static_cast<int>(MemoryTag::Count);
+
+    /**
+     * @brief The Counters struct is the state of one tag, alone on its cache line.
+     */
+    struct alignas(64) Counters {
+        std::atomic<long long> live{ 0 };
+        std::atomic<long long> peak{ 0 };
+        std::atomic<long long> allocations{ 0 };
+        std::atomic<long long> frees{ 0 };
+        std::atomic<long long> allocated{ 0 };
+    };
+
+    /**
+     * @brief The Header struct precedes every block.
+     */
+    struct Header {
+        uint64_t size;          ///< Bytes requested.
+        uint32_t offset;        ///< Distance from the start of the malloc block to the user block.
+        uint8_t tag;            ///< MemoryTag charged.
+        uint8_t reserved[3];
+    };
+
+    // Constant-initialized, so they work for allocations made before main
+    Counters counters[TagCount];
+    thread_local MemoryTag current = MemoryTag::Other;
+
+    const std::chrono::steady_clock::time_point programStart = std::chrono::steady_clock::now();
+
+    const char* const TagNames[TagCount] = { "other", "board", "pieces", "players", "search", "books", "io" };
+}
+
+static_assert(sizeof(Header) == 16, "blocks keep the 16-byte alignment of malloc");
+
+void* MemoryAccounting::allocate(size_t size, MemoryTag tag, size_t alignment) noexcept {
+    size_t step = alignment > sizeof(Header) ? alignment : sizeof(Header);
+    char* base = static_cast<char*>(std::malloc(size + step));
+    if (base == nullptr) {
+        return nullptr;
+    }
+    // malloc returns 16-byte aligned memory, so the first aligned address after the header is at most step bytes in
+    uintptr_t user = (reinterpret_cast<uintptr_t>(base) + sizeof(Header) + step - 1) & ~static_cast<uintptr_t>(step - 1);
+    Header* header = reinterpret_cast<Header*>(user) - 1;
+    header->size = size;
+    header->offset = static_cast<uint32_t>(user - reinterpret_cast<uintptr_t>(base));
+    header->tag = static_cast<uint8_t>(tag);
+
+    Counters& counter = counters[static_cast<int>(tag)];
+    long long live = counter.live.fetch_add(static_cast<long long>(size), std::memory_order_relaxed) + static_cast<long long>(size);
+    long long peak = counter.peak.load(std::memory_order_relaxed);
+    while (live > peak && !counter.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    counter.allocations.fetch_add(1, std::memory_order_relaxed);
+    counter.allocated.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    return reinterpret_cast<void*>(user);
+}
+
+void* MemoryAccounting::allocateOrThrow(size_t size, MemoryTag tag, size_t alignment) {
+    void* memory = allocate(size, tag, alignment);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void MemoryAccounting::release(void* memory) noexcept {
+    if (memory == nullptr) {
+        return;
+    }
+    Header* header = static_cast<Header*>(memory) - 1;
+    Counters& counter = counters[header->tag];
+    counter.live.fetch_sub(static_cast<long long>(header->size), std::memory_order_relaxed);
+    counter.frees.fetch_add(1, std::memory_order_relaxed);
+    std::free(static_cast<char*>(memory) - header->offset);
+}
+
+MemoryTag MemoryAccounting::currentTag() noexcept {
+    return current;
+}
+
+const char* MemoryAccounting::tagName(MemoryTag tag) {
+    return static_cast<int>(tag) < TagCount ? TagNames[static_cast<int>(tag)] : "?";
+}
+
+std::vector<MemoryAccounting::Usage> MemoryAccounting::snapshot() {
+    std::vector<Usage> usages;
+    for (int i = 0; i < TagCount; i++) {
+        Usage usage;
+        usage.tag = static_cast<MemoryTag>(i);
+        usage.liveBytes = counters[i].live.load(std::memory_order_relaxed);
+        usage.peakBytes = counters[i].peak.load(std::memory_order_relaxed);
+        usage.allocations = counters[i].allocations.load(std::memory_order_relaxed);
+        usage.frees = counters[i].frees.load(std::memory_order_relaxed);
+        usage.allocatedBytes = counters[i].allocated.load(std::memory_order_relaxed);
+        usages.push_back(usage);
+    }
+    return usages;
+}
+
+long long MemoryAccounting::totalAllocations() {
+    long long total = 0;
+    for (const Counters& counter : counters) {
+        total += counter.allocations.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void MemoryAccounting::report(std::ostream& stream) {
+    std::vector<Usage> usages = snapshot();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - programStart).count();
+    auto rate = [seconds](double value) { return seconds > 0.0 ? value / seconds : 0.0; };
+
+    stream << std::left << std::setw(10) << "memory" << std::right << std::setw(14) << "live bytes" << std::setw(14)
+        << "peak bytes" << std::setw(12) << "allocs" << std::setw(12) << "frees" << std::setw(12) << "allocs/s"
+        << std::setw(12) << "KB/s" << std::endl;
+    Usage total = { MemoryTag::Count, 0, 0, 0, 0, 0 };
+    for (const Usage& usage : usages) {
+        stream << std::left << std::setw(10) << tagName(usage.tag) << std::right << std::setw(14) << usage.liveBytes
+            << std::setw(14) << usage.peakBytes << std::setw(12) << usage.allocations << std::setw(12) << usage.frees
+            << std::fixed << std::setprecision(0) << std::setw(12) << rate(static_cast<double>(usage.allocations))
+            << std::setw(12) << rate(usage.allocatedBytes / 1024.0) << std::defaultfloat << std::setprecision(6) << std::endl;
+        total.liveBytes += usage.liveBytes;
+        total.allocations += usage.allocations;
+        total.frees += usage.frees;
+    }
+    stream << std::left << std::setw(10) << "total" << std::right << std::setw(14) << total.liveBytes << std::setw(14) << ""
+        << std::setw(12) << total.allocations << std::setw(12) << total.frees << "  over " << std::fixed
+        << std::setprecision(1) << seconds << " s" << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+MemoryScope::MemoryScope(MemoryTag tag) noexcept : previous(current) {
+    current = tag;
+}
+
+MemoryScope::~MemoryScope() {
+    current = previous;
+}
+
+// The engine library leaves the allocator of its host alone and charges only the scopes it uses
+#ifndef CHECKERS_API_EXPORTS
+
+void* operator new(std::size_t size) {
+    return MemoryAccounting::allocateOrThrow(size, current);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return MemoryAccounting::allocate(size, current);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return MemoryAccounting::allocateOrThrow(size, current, static_cast<size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return MemoryAccounting::allocate(size, current, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+    MemoryAccounting::release(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    MemoryAccounting::release(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    MemoryAccounting::release(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    MemoryAccounting::release(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    MemoryAccounting::release(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    MemoryAccounting::release(memory);
+}
+
+#endif
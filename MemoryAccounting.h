@@ -0,0 +1,132 @@
+#ifndef MEMORYACCOUNTING_H
+#define MEMORYACCOUNTING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief The MemoryTag enum names the subsystems heap memory is charged to.
+ */
+enum class MemoryTag : uint8_t {
+    Other,          ///< Anything not tagged, including the standard library's own allocations.
+    Board,          ///< The interactive board: squares, game states and the game record.
+    Pieces,         ///< Pawns and queens of the interactive board.
+    Players,        ///< Player objects.
+    Search,         ///< Transposition tables, search statistics, MCTS trees and proof-number tables.
+    Books,          ///< Game collections and the position database.
+    Io,             ///< Socket, trace and batch buffers.
+    Count           ///< Number of tags.
+};
+
+/**
+ * @brief The MemoryAccounting class counts the heap memory of every subsystem.
+ *
+ * The global operator new and delete are replaced in MemoryAccounting.cpp,
+ * except in the engine library, which must not take over the allocator of
+ * the program that loads it.
+ * Every block carries a 16-byte header with its size and tag, so a delete is
+ * charged back to the subsystem that allocated, whatever thread frees it. A
+ * block is charged to the tag of the innermost MemoryScope of the allocating
+ * thread; classes that are always one subsystem's, such as Piece, instead
+ * declare their own operator new calling allocate().
+ *
+ * Each tag keeps live and peak bytes and the number of allocations, frees and
+ * bytes allocated in relaxed atomics on its own cache line, so accounting
+ * costs a handful of atomic adds per allocation and is always on. The
+ * totals can be read at any time with snapshot() or report(), and main writes
+ * the report when the program ends with `--memory <file>`. Blocks still live
+ * at the end are leaks of their subsystem, or objects with static lifetime.
+ */
+class MemoryAccounting {
+public:
+    /**
+     * @brief The Usage struct is the state of one tag.
+     */
+    struct Usage {
+        MemoryTag tag;                  ///< The subsystem.
+        long long liveBytes;            ///< Bytes allocated and not freed.
+        long long peakBytes;            ///< Highest liveBytes so far.
+        long long allocations;          ///< Blocks allocated.
+        long long frees;                ///< Blocks freed.
+        long long allocatedBytes;       ///< Bytes allocated in total.
+    };
+
+    /**
+     * @brief Allocate a block charged to a tag.
+     *
+     * @param size Bytes requested.
+     * @param tag The subsystem.
+     * @param alignment Alignment of the block, a power of two; at most 16 uses the plain header.
+     * @return The block, or null if the heap is exhausted.
+     */
+    static void* allocate(size_t size, MemoryTag tag, size_t alignment = 16) noexcept;
+
+    /**
+     * @brief Allocate a block charged to a tag, as operator new does.
+     *
+     * @throw std::bad_alloc if the heap is exhausted.
+     */
+    static void* allocateOrThrow(size_t size, MemoryTag tag, size_t alignment = 16);
+
+    /**
+     * @brief Free a block from allocate(). Accepts null.
+     */
+    static void release(void* memory) noexcept;
+
+    /**
+     * @brief Get the tag the current thread charges its allocations to.
+     */
+    static MemoryTag currentTag() noexcept;
+
+    /**
+     * @brief Get the name of a tag, e.g. "search".
+     */
+    static const char* tagName(MemoryTag tag);
+
+    /**
+     * @brief Read the counters of every tag.
+     */
+    static std::vector<Usage> snapshot();
+
+    /**
+     * @brief Get the number of blocks allocated by the process so far.
+     */
+    static long long totalAllocations();
+
+    /**
+     * @brief Print the counters of every tag, with the allocation rates since the program started.
+     *
+     * @param stream Receives the table.
+     */
+    static void report(std::ostream& stream);
+};
+
+/**
+ * @brief The MemoryScope class charges the allocations of the current thread to a tag while it lives.
+ *
+ * Scopes nest; the previous tag is restored when a scope ends.
+ */
+class MemoryScope {
+public:
+    /**
+     * @brief Constructor for the MemoryScope class.
+     *
+     * @param tag The subsystem to charge.
+     */
+    explicit MemoryScope(MemoryTag tag) noexcept;
+
+    /**
+     * @brief Restore the previous tag.
+     */
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryTag previous;     ///< Tag of the enclosing scope.
+};
+
+#endif
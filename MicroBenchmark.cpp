@@ -0,0 +1,349 @@
+#include "MicroBenchmark.h"
+#include "Board.h"
+#include "Evaluation.h"
+#include "MemoryAccounting.h"
+#include "Pawn.h"
+#include "Queen.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @file MicroBenchmark.cpp
+ * @brief Implementation of the micro-benchmark suite.
+ *
+ * Heap allocations are counted by MemoryAccounting, which replaces the global
+ * operator new for the whole program.
+ */
+
+namespace {
+    const int CorpusGames = 64;         // Random games in the corpus
+    const int MaxGamePlies = 120;       // Plies after which a random game is cut
+    const int SampleEvery = 3;          // Plies between two positions taken from a game
+    const int DensePositions = 64;      // Positions with the longest captures used by countCapturingMoves
+    const int WarmupPasses = 3;         // Untimed passes over the corpus
+    const int Repetitions = 15;         // Timed passes over the corpus
+
+    /**
+     * @brief The positions every benchmark runs over, as compact positions and as interactive boards.
+     */
+    struct Corpus {
+        std::vector<Position> positions;    ///< Positions of the random games, none of them finished.
+        std::vector<Board*> boards;         ///< The same positions on interactive boards.
+        std::vector<size_t> dense;          ///< Indices of the positions with the longest captures.
+    };
+
+    /**
+     * @brief The result of one benchmark.
+     */
+    struct Result {
+        std::string name;               ///< Benchmark name.
+        long long operations;           ///< Operations per repetition.
+        double fastest;                 ///< Nanoseconds per operation of the fastest repetition.
+        double median;                  ///< Nanoseconds per operation of the median repetition.
+        double allocations;             ///< Heap allocations per operation.
+        long long checksum;             ///< Sum of the results, keeps the work from being optimised away.
+    };
+
+    Board* loadBoard(const Position& position) {
+        Board* board = new Board();
+        for (int square = 0; square < 32; square++) {
+            uint32_t bit = 1u << square;
+            if (((position.white | position.black) & bit) == 0) {
+                continue;
+            }
+            bool white = (position.white & bit) != 0;
+            Piece* piece = (position.kings & bit) != 0 ? static_cast<Piece*>(new Queen(white)) : new Pawn(white);
+            board->getSquare(Position::squareRow(square), Position::squareColumn(square))->SetPiece(piece);
+        }
+        return board;
+    }
+
+    void freeBoard(Board* board) {
+        for (int square = 0; square < 32; square++) {
+            Square* cell = board->getSquare(Position::squareRow(square), Position::squareColumn(square));
+            delete cell->getPiece();
+            cell->SetPiece(nullptr);
+        }
+        delete board;
+    }
+
+    Corpus buildCorpus() {
+        Corpus corpus;
+        std::vector<std::pair<int, size_t>> captures;
+        uint32_t state = 2024;
+
+        for (int g = 0; g < CorpusGames; g++) {
+            Position position = Position::initial();
+
+            for (int ply = 0; ply < MaxGamePlies; ply++) {
+                MoveList list;
+                position.generateMoves(list);
+                if (list.count == 0) {
+                    break;
+                }
+
+                if (ply % SampleEvery == 0) {
+                    if (list[0].isCapture()) {
+                        captures.push_back(std::make_pair(-list[0].hops * list.count, corpus.positions.size()));
+                    }
+                    corpus.positions.push_back(position);
+                    corpus.boards.push_back(loadBoard(position));
+                }
+
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                position.makeMove(list[state % list.count]);
+            }
+        }
+
+        // Longest and most numerous captures first
+        std::stable_sort(captures.begin(), captures.end());
+        for (size_t i = 0; i < captures.size() && i < static_cast<size_t>(DensePositions); i++) {
+            corpus.dense.push_back(captures[i].second);
+        }
+        return corpus;
+    }
+
+    /**
+     * @brief Time a benchmark body.
+     *
+     * @param name The benchmark name.
+     * @param body Runs one pass over the corpus, adds to the checksum and returns the number of operations.
+     */
+    template <typename Body>
+    Result measure(const std::string& name, Body body) {
+        Result result = {};
+        result.name = name;
+
+        for (int i = 0; i < WarmupPasses; i++) {
+            body(result.checksum);
+        }
+
+        std::vector<double> times;
+        times.reserve(Repetitions);
+        long long allocationsBefore = MemoryAccounting::totalAllocations();
+        for (int i = 0; i < Repetitions; i++) {
+            auto start = std::chrono::steady_clock::now();
+            result.operations = body(result.checksum);
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            times.push_back(elapsed.count() / (result.operations > 0 ? result.operations : 1));
+        }
+        long long allocations = MemoryAccounting::totalAllocations() - allocationsBefore;
+
+        std::sort(times.begin(), times.end());
+        result.fastest = times.front();
+        result.median = times[times.size() / 2];
+        result.allocations = result.operations > 0 ? static_cast<double>(allocations) / (static_cast<double>(result.operations) * Repetitions) : 0.0;
+        return result;
+    }
+
+    std::vector<Result> runAll(const Corpus& corpus) {
+        std::vector<Result> results;
+
+        results.push_back(measure("pawn_can_move", [&corpus](long long& checksum) {
+            long long operations = 0;
+            for (size_t i = 0; i < corpus.boards.size(); i++) {
+                Board& board = *corpus.boards[i];
+                bool white = corpus.positions[i].whiteToMove;
+                for (uint32_t pieces = corpus.positions[i].ownPieces() & ~corpus.positions[i].kings; pieces != 0; pieces &= pieces - 1) {
+                    int square = lowestBit(pieces);
+                    Square* start = board.getSquare(Position::squareRow(square), Position::squareColumn(square));
+                    for (int direction = 0; direction < 4; direction++) {
+                        int target = Position::neighbor(square, direction);
+                        if (target >= 0) {
+                            Square* end = board.getSquare(Position::squareRow(target), Position::squareColumn(target));
+                            checksum += start->getPiece()->canMove(board, *start, *end, !white);
+                            operations++;
+                        }
+                    }
+                }
+            }
+            return operations;
+        }));
+
+        results.push_back(measure("queen_can_move", [&corpus](long long& checksum) {
+            long long operations = 0;
+            for (size_t i = 0; i < corpus.boards.size(); i++) {
+                Board& board = *corpus.boards[i];
+                bool white = corpus.positions[i].whiteToMove;
+                for (uint32_t pieces = corpus.positions[i].ownPieces() & corpus.positions[i].kings; pieces != 0; pieces &= pieces - 1) {
+                    int square = lowestBit(pieces);
+                    Square* start = board.getSquare(Position::squareRow(square), Position::squareColumn(square));
+                    for (int direction = 0; direction < 4; direction++) {
+                        int target = Position::neighbor(square, direction);
+                        if (target >= 0) {
+                            Square* end = board.getSquare(Position::squareRow(target), Position::squareColumn(target));
+                            checksum += start->getPiece()->canMove(board, *start, *end, !white);
+                            operations++;
+                        }
+                    }
+                }
+            }
+            return operations;
+        }));
+
+        results.push_back(measure("count_capturing_moves", [&corpus](long long& checksum) {
+            long long operations = 0;
+            for (size_t i : corpus.dense) {
+                Board& board = *corpus.boards[i];
+                bool white = corpus.positions[i].whiteToMove;
+                for (uint32_t pieces = corpus.positions[i].jumpers(); pieces != 0; pieces &= pieces - 1) {
+                    int square = lowestBit(pieces);
+                    Square* start = board.getSquare(Position::squareRow(square), Position::squareColumn(square));
+                    checksum += start->getPiece()->countCapturingMoves(board, *start, white);
+                    operations++;
+                }
+            }
+            return operations;
+        }));
+
+        results.push_back(measure("check_game_over", [&corpus](long long& checksum) {
+            for (size_t i = 0; i < corpus.boards.size(); i++) {
+                checksum += corpus.boards[i]->CheckGameOver(corpus.positions[i].whiteToMove);
+            }
+            return static_cast<long long>(corpus.boards.size());
+        }));
+
+        results.push_back(measure("generate_moves", [&corpus](long long& checksum) {
+            MoveList list;
+            for (const Position& position : corpus.positions) {
+                position.generateMoves(list);
+                checksum += list.count;
+            }
+            return static_cast<long long>(corpus.positions.size());
+        }));
+
+        results.push_back(measure("make_unmake", [&corpus](long long& checksum) {
+            long long operations = 0;
+            MoveList list;
+            for (Position position : corpus.positions) {
+                position.generateMoves(list);
+                for (int i = 0; i < list.count; i++) {
+                    position.makeMove(list[i]);
+                    checksum += position.white;
+                    position.unmakeMove(list[i]);
+                }
+                operations += list.count;
+            }
+            return operations;
+        }));
+
+        results.push_back(measure("evaluate", [&corpus](long long& checksum) {
+            for (const Position& position : corpus.positions) {
+                checksum += Evaluation::evaluate(position);
+            }
+            return static_cast<long long>(corpus.positions.size());
+        }));
+
+        results.push_back(measure("render_board", [&corpus](long long& checksum) {
+            std::ostringstream stream;
+            for (const Board* board : corpus.boards) {
+                stream.str(std::string());
+                stream << *board;
+                checksum += static_cast<long long>(stream.tellp());
+            }
+            return static_cast<long long>(corpus.boards.size());
+        }));
+
+        return results;
+    }
+
+    /**
+     * @brief Read the median times of a results file written by saveResults().
+     */
+    std::map<std::string, double> loadBaseline(const std::string& path) {
+        std::ifstream stream(path);
+        if (!stream) {
+            throw std::runtime_error("Cannot read the baseline " + path);
+        }
+
+        // One benchmark per line: {"name": "...", ..., "median_ns": ..., ...}
+        std::map<std::string, double> medians;
+        std::string line;
+        while (std::getline(stream, line)) {
+            size_t name = line.find("\"name\": \"");
+            size_t median = line.find("\"median_ns\": ");
+            if (name == std::string::npos || median == std::string::npos) {
+                continue;
+            }
+            name += 9;
+            medians[line.substr(name, line.find('"', name) - name)] = std::stod(line.substr(median + 13));
+        }
+        return medians;
+    }
+
+    void saveResults(const std::string& path, const Corpus& corpus, const std::vector<Result>& results) {
+        std::ofstream stream(path);
+        if (!stream) {
+            throw std::runtime_error("Cannot write the results to " + path);
+        }
+
+        stream << "{\n  \"positions\": " << corpus.positions.size() << ",\n  \"repetitions\": " << Repetitions
+            << ",\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& result = results[i];
+            stream << "    {\"name\": \"" << result.name << "\", \"operations\": " << result.operations
+                << ", \"fastest_ns\": " << result.fastest << ", \"median_ns\": " << result.median
+                << ", \"allocations_per_op\": " << result.allocations << ", \"checksum\": " << result.checksum << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        stream << "  ]\n}\n";
+    }
+}
+
+int MicroBenchmark::run(const std::string& outputPath, const std::string& baselinePath) {
+    try {
+        std::map<std::string, double> baseline;
+        if (!baselinePath.empty()) {
+            baseline = loadBaseline(baselinePath);
+        }
+
+        Corpus corpus = buildCorpus();
+        std::cout << "Corpus: " << corpus.positions.size() << " positions, " << corpus.dense.size()
+            << " with dense captures" << std::endl;
+
+        std::vector<Result> results = runAll(corpus);
+
+        std::cout << std::left << std::setw(24) << "benchmark" << std::right << std::setw(12) << "ops"
+            << std::setw(12) << "fastest ns" << std::setw(12) << "median ns" << std::setw(12) << "allocs/op";
+        if (!baseline.empty()) {
+            std::cout << std::setw(12) << "baseline" << std::setw(10) << "change";
+        }
+        std::cout << std::endl;
+
+        std::cout << std::fixed << std::setprecision(2);
+        for (const Result& result : results) {
+            std::cout << std::left << std::setw(24) << result.name << std::right << std::setw(12) << result.operations
+                << std::setw(12) << result.fastest << std::setw(12) << result.median << std::setw(12) << result.allocations;
+            auto previous = baseline.find(result.name);
+            if (previous != baseline.end() && previous->second > 0.0) {
+                std::cout << std::setw(12) << previous->second << std::setw(9)
+                    << (result.median / previous->second - 1.0) * 100.0 << "%";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << std::defaultfloat << std::setprecision(6);
+
+        if (!outputPath.empty()) {
+            saveResults(outputPath, corpus, results);
+            std::cout << "Results saved to " << outputPath << std::endl;
+        }
+
+        for (Board* board : corpus.boards) {
+            freeBoard(board);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#ifndef MICROBENCHMARK_H
+#define MICROBENCHMARK_H
+
+#include <string>
+
+/**
+ * @brief The MicroBenchmark class measures the hot paths of the rules, the engine and the display.
+ *
+ * Every benchmark runs over a fixed corpus of positions taken from seeded
+ * random games, so runs on the same build are comparable. Each one is warmed
+ * up, then timed over several repetitions; the fastest and the median
+ * repetition are reported in nanoseconds per operation, together with the
+ * number of heap allocations per operation. Results can be saved as JSON and
+ * compared with an earlier run.
+ *
+ * Benchmarks: Pawn::canMove and Queen::canMove on every step of every piece,
+ * countCapturingMoves on the positions with the densest captures,
+ * Board::CheckGameOver, Position::generateMoves, makeMove/unmakeMove of every
+ * legal move, Evaluation::evaluate and rendering the board with operator<<.
+ */
+class MicroBenchmark {
+public:
+    /**
+     * @brief Run all benchmarks and print the results.
+     *
+     * @param outputPath File to save the results to as JSON, empty to only print them.
+     * @param baselinePath Results of an earlier run to compare with, empty for none.
+     * @return 0 on success, 1 if a file could not be read or written.
+     */
+    static int run(const std::string& outputPath, const std::string& baselinePath);
+};
+
+#endif
@@ -0,0 +1,383 @@
+#include "Nnue.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#define NNUE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NNUE_SSE2
+#include <emmintrin.h>
+#endif
+
+/**
+ * @file Nnue.cpp
+ * @brief Implementation of the neural-network evaluation and its SIMD kernels.
+ */
+
+namespace {
+    const char FileMagic[4] = { 'C', 'K', 'N', 'N' };
+
+    /**
+     * @brief Add the columns in added and subtract the ones in removed from a row.
+     */
+    void updateRow(int16_t* output, const int16_t* input, const NnueNetwork& network, const int* added, int addedCount, const int* removed, int removedCount) {
+        const int size = NnueNetwork::Hidden;
+#if defined(NNUE_AVX2)
+        for (int i = 0; i < size; i += 16) {
+            __m256i sum = _mm256_load_si256(reinterpret_cast<const __m256i*>(input + i));
+            for (int k = 0; k < addedCount; k++) {
+                sum = _mm256_add_epi16(sum, _mm256_load_si256(reinterpret_cast<const __m256i*>(&network.featureWeights[added[k]][i])));
+            }
+            for (int k = 0; k < removedCount; k++) {
+                sum = _mm256_sub_epi16(sum, _mm256_load_si256(reinterpret_cast<const __m256i*>(&network.featureWeights[removed[k]][i])));
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(output + i), sum);
+        }
+#elif defined(NNUE_SSE2)
+        for (int i = 0; i < size; i += 8) {
+            __m128i sum = _mm_load_si128(reinterpret_cast<const __m128i*>(input + i));
+            for (int k = 0; k < addedCount; k++) {
+                sum = _mm_add_epi16(sum, _mm_load_si128(reinterpret_cast<const __m128i*>(&network.featureWeights[added[k]][i])));
+            }
+            for (int k = 0; k < removedCount; k++) {
+                sum = _mm_sub_epi16(sum, _mm_load_si128(reinterpret_cast<const __m128i*>(&network.featureWeights[removed[k]][i])));
+            }
+            _mm_store_si128(reinterpret_cast<__m128i*>(output + i), sum);
+        }
+#else
+        for (int i = 0; i < size; i++) {
+            int sum = input[i];
+            for (int k = 0; k < addedCount; k++) {
+                sum += network.featureWeights[added[k]][i];
+            }
+            for (int k = 0; k < removedCount; k++) {
+                sum -= network.featureWeights[removed[k]][i];
+            }
+            output[i] = static_cast<int16_t>(sum);
+        }
+#endif
+    }
+
+    /**
+     * @brief Clamp int16 activations to 0-127 and narrow them to bytes.
+     */
+    void clippedRelu(uint8_t* output, const int16_t* input, int size) {
+#if defined(NNUE_AVX2)
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i limit = _mm256_set1_epi16(127);
+        for (int i = 0; i < size; i += 32) {
+            __m256i a = _mm256_min_epi16(_mm256_max_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(input + i)), zero), limit);
+            __m256i b = _mm256_min_epi16(_mm256_max_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(input + i + 16)), zero), limit);
+            // packus works per 128-bit lane, the permute restores the element order
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+        }
+#elif defined(NNUE_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i limit = _mm_set1_epi16(127);
+        for (int i = 0; i < size; i += 16) {
+            __m128i a = _mm_min_epi16(_mm_max_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(input + i)), zero), limit);
+            __m128i b = _mm_min_epi16(_mm_max_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(input + i + 8)), zero), limit);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi16(a, b));
+        }
+#else
+        for (int i = 0; i < size; i++) {
+            output[i] = static_cast<uint8_t>(std::min<int>(std::max<int>(input[i], 0), 127));
+        }
+#endif
+    }
+
+    /**
+     * @brief Dot product of unsigned activations and signed weights.
+     *
+     * size must be a multiple of 32. Activations are at most 127, so the pairwise
+     * int16 sums of maddubs cannot saturate.
+     */
+    int32_t dotProduct(const uint8_t* input, const int8_t* weights, int size) {
+#if defined(NNUE_AVX2)
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < size; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, b), ones));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+        return _mm_cvtsi128_si32(half);
+#elif defined(NNUE_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < size; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+            // Widen to int16: zero-extend the activations, sign-extend the weights
+            __m128i aLow = _mm_unpacklo_epi8(a, zero);
+            __m128i aHigh = _mm_unpackhi_epi8(a, zero);
+            __m128i bLow = _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8);
+            __m128i bHigh = _mm_srai_epi16(_mm_unpackhi_epi8(b, b), 8);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(aLow, bLow));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(aHigh, bHigh));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        return _mm_cvtsi128_si32(sum);
+#else
+        int32_t sum = 0;
+        for (int i = 0; i < size; i++) {
+            sum += static_cast<int32_t>(input[i]) * weights[i];
+        }
+        return sum;
+#endif
+    }
+
+    /**
+     * @brief Run one int8 layer followed by a clipped ReLU.
+     */
+    template <int Outputs, int InputSize>
+    void denseLayer(uint8_t* output, const uint8_t* input, const int8_t (&weights)[Outputs][InputSize], const int32_t (&bias)[Outputs]) {
+        for (int j = 0; j < Outputs; j++) {
+            int32_t value = (bias[j] + dotProduct(input, weights[j], InputSize)) >> NnueNetwork::WeightShift;
+            output[j] = static_cast<uint8_t>(std::min(std::max(value, 0), 127));
+        }
+    }
+
+    /**
+     * @brief Small xorshift generator for deterministic weights.
+     */
+    uint32_t nextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    int randomInRange(uint32_t& state, int low, int high) {
+        return low + static_cast<int>(nextRandom(state) % static_cast<uint32_t>(high - low + 1));
+    }
+
+    template <typename T>
+    void readArray(std::ifstream& file, T& array) {
+        file.read(reinterpret_cast<char*>(&array), sizeof(array));
+    }
+
+    template <typename T>
+    void writeArray(std::ofstream& file, const T& array) {
+        file.write(reinterpret_cast<const char*>(&array), sizeof(array));
+    }
+}
+
+NnueNetwork::NnueNetwork() {
+    std::memset(featureWeights, 0, sizeof(featureWeights));
+    std::memset(featureBias, 0, sizeof(featureBias));
+    std::memset(layer1Weights, 0, sizeof(layer1Weights));
+    std::memset(layer1Bias, 0, sizeof(layer1Bias));
+    std::memset(layer2Weights, 0, sizeof(layer2Weights));
+    std::memset(layer2Bias, 0, sizeof(layer2Bias));
+    std::memset(outputWeights, 0, sizeof(outputWeights));
+    outputBias = 0;
+}
+
+void NnueNetwork::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open network file: " + path);
+    }
+
+    char magic[4];
+    uint32_t header[5];
+    file.read(magic, sizeof(magic));
+    readArray(file, header);
+
+    if (!file || std::memcmp(magic, FileMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a network file: " + path);
+    }
+    if (header[0] != FileVersion || header[1] != Inputs || header[2] != Hidden || header[3] != Layer1 || header[4] != Layer2) {
+        throw std::runtime_error("Network file does not match this build: " + path);
+    }
+
+    readArray(file, featureWeights);
+    readArray(file, featureBias);
+    readArray(file, layer1Weights);
+    readArray(file, layer1Bias);
+    readArray(file, layer2Weights);
+    readArray(file, layer2Bias);
+    readArray(file, outputWeights);
+    readArray(file, outputBias);
+
+    if (!file) {
+        throw std::runtime_error("Network file is truncated: " + path);
+    }
+}
+
+void NnueNetwork::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot create network file: " + path);
+    }
+
+    const uint32_t header[5] = { FileVersion, Inputs, Hidden, Layer1, Layer2 };
+    file.write(FileMagic, sizeof(FileMagic));
+    writeArray(file, header);
+    writeArray(file, featureWeights);
+    writeArray(file, featureBias);
+    writeArray(file, layer1Weights);
+    writeArray(file, layer1Bias);
+    writeArray(file, layer2Weights);
+    writeArray(file, layer2Bias);
+    writeArray(file, outputWeights);
+    writeArray(file, outputBias);
+
+    if (!file) {
+        throw std::runtime_error("Cannot write network file: " + path);
+    }
+}
+
+void NnueNetwork::randomize(uint32_t seed) {
+    uint32_t state = seed != 0 ? seed : 1;
+
+    for (auto& column : featureWeights) {
+        for (auto& weight : column) {
+            weight = static_cast<int16_t>(randomInRange(state, -24, 24));
+        }
+    }
+    for (auto& bias : featureBias) {
+        bias = static_cast<int16_t>(randomInRange(state, 0, 64));
+    }
+    for (auto& row : layer1Weights) {
+        for (auto& weight : row) {
+            weight = static_cast<int8_t>(randomInRange(state, -16, 16));
+        }
+    }
+    for (auto& bias : layer1Bias) {
+        bias = randomInRange(state, 0, 2048);
+    }
+    for (auto& row : layer2Weights) {
+        for (auto& weight : row) {
+            weight = static_cast<int8_t>(randomInRange(state, -32, 32));
+        }
+    }
+    for (auto& bias : layer2Bias) {
+        bias = randomInRange(state, 0, 2048);
+    }
+    for (auto& weight : outputWeights) {
+        weight = static_cast<int8_t>(randomInRange(state, -64, 64));
+    }
+    outputBias = 0;
+}
+
+uint64_t NnueNetwork::checksum() const {
+    // FNV-1a over the weights in file order
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    mix(featureWeights, sizeof(featureWeights));
+    mix(featureBias, sizeof(featureBias));
+    mix(layer1Weights, sizeof(layer1Weights));
+    mix(layer1Bias, sizeof(layer1Bias));
+    mix(layer2Weights, sizeof(layer2Weights));
+    mix(layer2Bias, sizeof(layer2Bias));
+    mix(outputWeights, sizeof(outputWeights));
+    mix(&outputBias, sizeof(outputBias));
+    return hash;
+}
+
+int NnueNetwork::featureIndex(int perspective, int square, bool isWhitePiece, bool isKing) {
+    // Black sees the board rotated by 180 degrees, which maps square s to 31 - s
+    int relativeSquare = perspective == 0 ? square : 31 - square;
+    bool own = isWhitePiece == (perspective == 0);
+    int kind = (own ? 0 : 2) + (isKing ? 1 : 0);
+    return kind * 32 + relativeSquare;
+}
+
+int NnueNetwork::propagate(const NnueAccumulator& accumulator, bool whiteToMove) const {
+    alignas(32) uint8_t transformed[2 * Hidden];
+    alignas(32) uint8_t hidden1[Layer1];
+    alignas(32) uint8_t hidden2[Layer2];
+
+    // The side to move always comes first
+    int us = whiteToMove ? 0 : 1;
+    clippedRelu(transformed, accumulator.values[us], Hidden);
+    clippedRelu(transformed + Hidden, accumulator.values[1 - us], Hidden);
+
+    denseLayer(hidden1, transformed, layer1Weights, layer1Bias);
+    denseLayer(hidden2, hidden1, layer2Weights, layer2Bias);
+
+    return (outputBias + dotProduct(hidden2, outputWeights, Layer2)) / OutputScale;
+}
+
+const char* NnueNetwork::simdName() {
+#if defined(NNUE_AVX2)
+    return "AVX2";
+#elif defined(NNUE_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+NnueEvaluator::NnueEvaluator(const NnueNetwork& network) : network(network), stack(64), ply(0) {}
+
+void NnueEvaluator::reset(const Position& position) {
+    ply = 0;
+
+    int features[2][32];
+    int counts[2] = { 0, 0 };
+    for (uint32_t pieces = position.white | position.black; pieces != 0; pieces &= pieces - 1) {
+        int square = lowestBit(pieces);
+        bool isWhitePiece = (position.white >> square) & 1u;
+        bool isKing = (position.kings >> square) & 1u;
+        for (int perspective = 0; perspective < 2; perspective++) {
+            features[perspective][counts[perspective]++] = NnueNetwork::featureIndex(perspective, square, isWhitePiece, isKing);
+        }
+    }
+
+    for (int perspective = 0; perspective < 2; perspective++) {
+        updateRow(stack[0].values[perspective], network.featureBias, network, features[perspective], counts[perspective], nullptr, 0);
+    }
+}
+
+void NnueEvaluator::push(const Position& position, const BoardMove& move) {
+    if (ply + 1 >= stack.size()) {
+        stack.resize(stack.size() * 2);
+    }
+
+    bool moverWhite = position.whiteToMove;
+    bool moverKing = (position.kings >> move.from) & 1u;
+
+    for (int perspective = 0; perspective < 2; perspective++) {
+        int added[1];
+        int removed[1 + BoardMove::MaxHops];
+        int removedCount = 0;
+
+        added[0] = NnueNetwork::featureIndex(perspective, move.to, moverWhite, moverKing || move.promotes);
+        removed[removedCount++] = NnueNetwork::featureIndex(perspective, move.from, moverWhite, moverKing);
+
+        for (uint32_t captured = move.captured; captured != 0; captured &= captured - 1) {
+            int square = lowestBit(captured);
+            removed[removedCount++] = NnueNetwork::featureIndex(perspective, square, !moverWhite, (move.capturedKings >> square) & 1u);
+        }
+
+        updateRow(stack[ply + 1].values[perspective], stack[ply].values[perspective], network, added, 1, removed, removedCount);
+    }
+
+    ply++;
+}
+
+void NnueEvaluator::pop() {
+    if (ply > 0) {
+        ply--;
+    }
+}
+
+int NnueEvaluator::evaluate(const Position& position) const {
+    return network.propagate(stack[ply], position.whiteToMove);
+}
@@ -0,0 +1,163 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Position.h"
+
+/**
+ * @brief The NnueAccumulator struct holds the first-layer activations of one position.
+ *
+ * There is one row per perspective (0 - white, 1 - black). Each row is the sum
+ * of the feature transformer columns of the pieces seen from that side, so it
+ * can be updated by adding and subtracting a few columns when a move is made.
+ */
+struct NnueAccumulator {
+    static const int Size = 128; ///< Number of first-layer neurons per perspective.
+
+    alignas(32) int16_t values[2][Size]; ///< Activations per perspective.
+};
+
+/**
+ * @brief The NnueNetwork class holds the weights of the neural-network evaluation.
+ *
+ * The network is a small NNUE: 128 sparse inputs per perspective (4 piece kinds
+ * times 32 squares, mirrored for black) feed a 128-wide int16 accumulator, which
+ * is followed by two int8 layers of 32 neurons and a single output. Inference runs
+ * on the CPU with AVX2 or SSE2 when the compiler targets them and falls back to
+ * plain C++ otherwise.
+ */
+class NnueNetwork {
+public:
+    static const int Inputs = 128;                          ///< Features per perspective.
+    static const int Hidden = NnueAccumulator::Size;        ///< Accumulator width per perspective.
+    static const int Layer1 = 32;                           ///< Width of the first int8 layer.
+    static const int Layer2 = 32;                           ///< Width of the second int8 layer.
+    static const int WeightShift = 6;                       ///< Right shift applied after each int8 layer.
+    static const int OutputScale = 16;                      ///< Divisor turning the output into hundredths of a pawn.
+    static const uint32_t FileVersion = 1;                  ///< Version of the weights file format.
+
+    alignas(32) int16_t featureWeights[Inputs][Hidden];     ///< Feature transformer columns.
+    alignas(32) int16_t featureBias[Hidden];                ///< Feature transformer bias.
+    alignas(32) int8_t layer1Weights[Layer1][2 * Hidden];   ///< First int8 layer weights.
+    alignas(32) int32_t layer1Bias[Layer1];                 ///< First int8 layer bias.
+    alignas(32) int8_t layer2Weights[Layer2][Layer1];       ///< Second int8 layer weights.
+    alignas(32) int32_t layer2Bias[Layer2];                 ///< Second int8 layer bias.
+    alignas(32) int8_t outputWeights[Layer2];               ///< Output neuron weights.
+    int32_t outputBias;                                     ///< Output neuron bias.
+
+    /**
+     * @brief Default constructor, creates a network with all weights set to zero.
+     */
+    NnueNetwork();
+
+    /**
+     * @brief Load the weights from a file written by save().
+     *
+     * @param path Path of the weights file.
+     * @throw std::runtime_error if the file cannot be read or does not match this network.
+     */
+    void load(const std::string& path);
+
+    /**
+     * @brief Save the weights to a file.
+     *
+     * @param path Path of the weights file.
+     * @throw std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Fill the network with deterministic pseudo-random weights.
+     *
+     * Useful for benchmarking inference speed when no trained weights are available.
+     *
+     * @param seed Seed of the generator.
+     */
+    void randomize(uint32_t seed);
+
+    /**
+     * @brief Get a checksum of the weights, which tells networks apart.
+     */
+    uint64_t checksum() const;
+
+    /**
+     * @brief Get the index of the input feature of a piece for one perspective.
+     *
+     * @param perspective 0 for white, 1 for black.
+     * @param square Square of the piece (0-31).
+     * @param isWhitePiece True if the piece is white.
+     * @param isKing True if the piece is a queen.
+     * @return The feature index (0-127).
+     */
+    static int featureIndex(int perspective, int square, bool isWhitePiece, bool isKing);
+
+    /**
+     * @brief Run the int8 layers on an accumulator.
+     *
+     * @param accumulator The accumulator of the position.
+     * @param whiteToMove True if white is the side to move.
+     * @return The score for the side to move in hundredths of a pawn.
+     */
+    int propagate(const NnueAccumulator& accumulator, bool whiteToMove) const;
+
+    /**
+     * @brief Get the name of the instruction set used for inference.
+     *
+     * @return "AVX2", "SSE2" or "scalar".
+     */
+    static const char* simdName();
+};
+
+/**
+ * @brief The NnueEvaluator class evaluates positions with an NnueNetwork.
+ *
+ * It keeps a stack of accumulators that follows the moves made on a Position:
+ * push() is called with the position and move just before Position::makeMove and
+ * updates the accumulator incrementally, pop() is called after Position::unmakeMove.
+ */
+class NnueEvaluator {
+public:
+    /**
+     * @brief Constructor for the NnueEvaluator class.
+     *
+     * @param network The network to evaluate with. It must outlive the evaluator.
+     */
+    explicit NnueEvaluator(const NnueNetwork& network);
+
+    /**
+     * @brief Recompute the accumulator of a position from scratch and clear the stack.
+     *
+     * @param position The root position.
+     */
+    void reset(const Position& position);
+
+    /**
+     * @brief Update the accumulator for a move about to be made.
+     *
+     * @param position The position before the move.
+     * @param move The move that will be made.
+     */
+    void push(const Position& position, const BoardMove& move);
+
+    /**
+     * @brief Return to the accumulator before the last push().
+     */
+    void pop();
+
+    /**
+     * @brief Evaluate the current position.
+     *
+     * @param position The position matching the top of the stack.
+     * @return The score for the side to move in hundredths of a pawn.
+     */
+    int evaluate(const Position& position) const;
+
+private:
+    const NnueNetwork& network;           ///< Network weights.
+    std::vector<NnueAccumulator> stack;   ///< Accumulator per ply.
+    size_t ply;                           ///< Index of the current accumulator.
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef PACKEDMOVE_H
+#define PACKEDMOVE_H
+
+#include <cstdint>
+#include "BoardMove.h"
+
+/**
+ * @brief The PackedMove struct stores a move in 16 bits.
+ *
+ * Bits 0-4 hold the start square, bits 5-9 the end square and bits 10-15
+ * tell apart the captures that share both squares but take different paths
+ * or pieces: the number of moves with the same squares before it in the
+ * generated move list. A packed move is only meaningful together with the
+ * position it is played in, which is how GameRecord stores its moves.
+ */
+struct PackedMove {
+    uint16_t bits;    ///< From, to and variant.
+
+    /**
+     * @brief Get the start square.
+     */
+    int from() const { return bits & 31; }
+
+    /**
+     * @brief Get the end square.
+     */
+    int to() const { return (bits >> 5) & 31; }
+
+    /**
+     * @brief Get the rank of the move among the generated moves with the same squares.
+     */
+    int variant() const { return bits >> 10; }
+
+    /**
+     * @brief Pack a generated move.
+     *
+     * @param list The moves generated in the position.
+     * @param index Index of the move in list.
+     * @return The packed move.
+     */
+    static PackedMove pack(const MoveList& list, int index) {
+        const BoardMove& move = list[index];
+        int variant = 0;
+        for (int i = 0; i < index; i++) {
+            variant += list[i].from == move.from && list[i].to == move.to ? 1 : 0;
+        }
+        PackedMove packed = { static_cast<uint16_t>(move.from | move.to << 5 | variant << 10) };
+        return packed;
+    }
+
+    /**
+     * @brief Find the move in the moves generated in its position.
+     *
+     * @param list The moves generated in the position.
+     * @return Index of the move in list, or -1 if it is not there.
+     */
+    int find(const MoveList& list) const {
+        int variant = this->variant();
+        for (int i = 0; i < list.count; i++) {
+            if (list[i].from == from() && list[i].to == to() && variant-- == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+
+#endif
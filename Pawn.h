@@ -32,20 +32,6 @@ public:
      */
     bool canMove(Board& board, Square& start, Square& end, bool isWhite) const override;
 
-    /**
-     * @brief Simulate and validate capturing moves for the pawn.
-     *
-     * @param board The chess board on which moves are being simulated and validated.
-     * @param start The starting square of the move.
-     * @param isWhite Indicates whether the pawn is a white piece.
-     * @param capturedPawnPositions A vector to store captured pawn positions during simulation.
-     * @param maxCapturingMoves The maximum number of capturing moves to simulate.
-     * @param endSquare The square to which the pawn intends to move.
-     * @param piece Pointer to the piece being captured, if applicable.
-     * @return True if the move is valid and captures other pieces, otherwise false.
-     */
-    bool simulateAndValidateCapturingMoves(Board& board, Square& start, bool isWhite, std::vector<Square*>& capturedPawnPositions, int maxCapturingMoves, Square& endSquare, Piece* piece);
-
     /**
  
    
@@ -4,6 +4,7 @@
 #include "Board.h"
 #include "vector"
 #include "Square.h"
+#include "MemoryAccounting.h"
 
 class Board;
 class Square;
@@ -28,6 +29,16 @@ public:
      */
     Piece(bool isWhite);
 
+    /**
+     * @brief Allocate pieces in the MemoryTag::Pieces account.
+     */
+    static void* operator new(size_t size) { return MemoryAccounting::allocateOrThrow(size, MemoryTag::Pieces); }
+
+    /**
+     * @brief Free pieces allocated by operator new.
+     */
+    static void operator delete(void* memory) noexcept { MemoryAccounting::release(memory); }
+
     /**
      * @brief Virtual destructor for the Piece class.
      */
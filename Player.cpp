@@ -6,6 +6,7 @@
 #include "Queen.h"
 #include "HumanPlayer.h"
 #include "ComputerPlayer.h"
+#include "MctsPlayer.h"
 
 /**
  * @file Player.cpp
@@ -66,6 +67,15 @@ std::string Player::getName() const {
     return playerName;
 }
 
+/**
+ * @brief Setter for the moveBudget attribute.
+ *
+ * @param milliseconds The thinking time of the next move, 0 for the default.
+ */
+void Player::setMoveBudget(int milliseconds) {
+    moveBudget = milliseconds;
+}
+
 /**
  * @brief Constructor for the Human class.
  *
@@ -89,7 +99,7 @@ Computer::Computer(bool whiteside) : Player() {
 /**
  * @brief Function to choose player type, set name, and display player information.
  *
- * This function allows the user to select the player type (Human or Computer),
+ * This function allows the user to select the player type (Human, Computer or MCTS),
  * set the player's name, and displays the player's name.
  *
  * @param playerNumber The number assigned to the player.
@@ -98,7 +108,7 @@ Computer::Computer(bool whiteside) : Player() {
  */
 Player* Player::chooseAndSetNameAndDisplay(int playerNumber, bool isWhite) {
     int choice;
-    std::cout << "Choose player " << playerNumber << " type (1 - Human, 2 - Computer): ";
+    std::cout << "Choose player " << playerNumber << " type (1 - Human, 2 - Computer, 3 - MCTS): ";
     std::cin >> choice;
 
     Player* player = nullptr;
@@ -109,6 +119,9 @@ Player* Player::chooseAndSetNameAndDisplay(int playerNumber, bool isWhite) {
     else if (choice == 2) {
         player = new ComputerPlayer(isWhite);
     }
+    else if (choice == 3) {
+        player = new MctsPlayer(isWhite);
+    }
     else {
         throw std::runtime_error("Invalid choice.");
     }
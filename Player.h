@@ -7,6 +7,10 @@
 #include "Pawn.h"
 #include "Square.h"
 #include "Queen.h"
+#include "MemoryAccounting.h"
+
+class NnueNetwork;
+class SearchStatistics;
 
 /**
  * @brief The Player class represents a player in a chess game.
@@ -23,6 +27,22 @@ public:
     std::string playerName; ///< The name of the player.
     Square start; ///< The starting square for a move.
     Square end; ///< The ending square for a move.
+    int moveBudget = 0; ///< Thinking time in milliseconds for the next move from the game clock, 0 for the player's default.
+
+    /**
+     * @brief Allocate players in the MemoryTag::Players account.
+     */
+    static void* operator new(size_t size) { return MemoryAccounting::allocateOrThrow(size, MemoryTag::Players); }
+
+    /**
+     * @brief Free players allocated by operator new.
+     */
+    static void operator delete(void* memory) noexcept { MemoryAccounting::release(memory); }
+
+    /**
+     * @brief Virtual destructor for the Player class.
+     */
+    virtual ~Player() = default;
 
     /**
      * @brief Check if the player is on the white side.
@@ -66,6 +86,42 @@ public:
      */
     std::string getName() const;
 
+    /**
+     * @brief Set the thinking time of the next move.
+     *
+     * The game clock calls this before every move of a timed game so that
+     * engine players finish before their flag falls.
+     *
+     * @param milliseconds The time budget, 0 for the player's default.
+     */
+    void setMoveBudget(int milliseconds);
+
+    /**
+     * @brief Get the statistics of the player's searches in this game, for the telemetry.
+     *
+     * @return The statistics, or null for players that do not use the alpha-beta search.
+     */
+    virtual const SearchStatistics* getStatistics() const { return nullptr; }
+
+    /**
+     * @brief Warm-start the player's hash table from a file and save it there when the player is destroyed.
+     *
+     * Players without a hash table ignore it.
+     *
+     * @param path The file, which need not exist yet.
+     * @return True if the player took the file, false if it ignores it.
+     */
+    virtual bool setHashFile(const std::string& /*path*/) { return false; }
+
+    /**
+     * @brief Evaluate with an NNUE network instead of the classic evaluation.
+     *
+     * Players without the alpha-beta search ignore it.
+     *
+     * @param network The network, which must outlive the player.
+     */
+    virtual void setNetwork(const NnueNetwork* /*network*/) {}
+
     /**
      * @brief Make a move on the chess board.
      *
@@ -80,7 +136,7 @@ public:
     /**
      * @brief Create and set up a player instance based on user input.
      *
-     * This function allows the user to choose the player type (human or computer)
+     * This function allows the user to choose the player type (human, computer or MCTS)
      * and set the player's name based on user input.
      *
      * @param playerNumber The number of the player (1 or 2).
@@ -0,0 +1,362 @@
+#include "Position.h"
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @file Position.cpp
+ * @brief Implementation of the compact engine board and its move generator.
+ */
+
+namespace {
+    // Rows on which pawns of each colour are promoted
+    const uint32_t whitePromotionRow = 0x0000000Fu;
+    const uint32_t blackPromotionRow = 0xF0000000u;
+
+    /**
+     * @brief Finalizer of the splitmix64 generator, a cheap full-avalanche mix.
+     */
+    uint64_t mix(uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief Append the pieces of one colour to a position string.
+     */
+    void appendPieces(std::string& text, char colour, uint32_t pieces, uint32_t kings) {
+        text += ':';
+        text += colour;
+        bool first = true;
+        for (uint32_t rest = pieces; rest != 0; rest &= rest - 1) {
+            int square = lowestBit(rest);
+            if (!first) {
+                text += ',';
+            }
+            if ((kings >> square) & 1u) {
+                text += 'K';
+            }
+            text += std::to_string(square + 1);
+            first = false;
+        }
+    }
+}
+
+Position::Position() : white(0), black(0), kings(0), whiteToMove(true) {}
+
+Position Position::initial() {
+    Position position;
+    position.black = 0x00000FFFu; // Rows 0-2
+    position.white = 0xFFF00000u; // Rows 5-7
+    return position;
+}
+
+Position Position::fromString(const std::string& text) {
+    Position position;
+
+    if (text.size() < 1 || (text[0] != 'W' && text[0] != 'B')) {
+        throw std::runtime_error("Invalid position: missing side to move.");
+    }
+    position.whiteToMove = text[0] == 'W';
+
+    std::stringstream stream(text.substr(1));
+    std::string section;
+    while (std::getline(stream, section, ':')) {
+        if (section.empty()) {
+            continue;
+        }
+        if (section[0] != 'W' && section[0] != 'B') {
+            throw std::runtime_error("Invalid position: unknown colour in \"" + section + "\".");
+        }
+
+        uint32_t& pieces = section[0] == 'W' ? position.white : position.black;
+        std::stringstream squares(section.substr(1));
+        std::string item;
+        while (std::getline(squares, item, ',')) {
+            bool isKing = !item.empty() && item[0] == 'K';
+            std::string number = isKing ? item.substr(1) : item;
+            if (number.empty() || number.find_first_not_of("0123456789") != std::string::npos) {
+                throw std::runtime_error("Invalid position: bad square \"" + item + "\".");
+            }
+
+            int square = std::stoi(number) - 1;
+            if (square < 0 || square >= 32) {
+                throw std::runtime_error("Invalid position: square out of range \"" + item + "\".");
+            }
+
+            uint32_t bit = 1u << square;
+            if (((position.white | position.black) & bit) != 0) {
+                throw std::runtime_error("Invalid position: square used twice \"" + item + "\".");
+            }
+            pieces |= bit;
+            if (isKing) {
+                position.kings |= bit;
+            }
+        }
+    }
+
+    return position;
+}
+
+std::string Position::toString() const {
+    std::string text(1, whiteToMove ? 'W' : 'B');
+    appendPieces(text, 'W', white, kings);
+    appendPieces(text, 'B', black, kings);
+    return text;
+}
+
+uint64_t Position::hashKey() const {
+    uint64_t pieces = (static_cast<uint64_t>(white) << 32) | black;
+    uint64_t rest = (static_cast<uint64_t>(kings) << 1) | (whiteToMove ? 1u : 0u);
+    uint64_t key = mix(pieces ^ mix(rest + 0x9E3779B97F4A7C15ull));
+    return key != 0 ? key : 1;
+}
+
+Position Position::mirrored() const {
+    Position result;
+    result.white = reverseBits(black);
+    result.black = reverseBits(white);
+    result.kings = reverseBits(kings);
+    result.whiteToMove = !whiteToMove;
+    return result;
+}
+
+BoardMove Position::mirrorMove(const BoardMove& move) {
+    BoardMove result = move;
+    result.from = static_cast<uint8_t>(31 - move.from);
+    result.to = static_cast<uint8_t>(31 - move.to);
+    for (int i = 0; i < move.hops; i++) {
+        result.path[i] = static_cast<uint8_t>(31 - move.path[i]);
+    }
+    result.captured = reverseBits(move.captured);
+    result.capturedKings = reverseBits(move.capturedKings);
+    return result;
+}
+
+uint32_t Position::shift(uint32_t mask, int direction) {
+    // Even rows (0, 2, ...) start with a light square, so the index step to a
+    // diagonal neighbour depends on the row parity; the masks drop the squares
+    // on the edge the step would leave
+    switch (direction) {
+    case 0:
+        return ((mask & 0x0F0F0F00u) >> 4) | ((mask & 0xE0E0E0E0u) >> 5);
+    case 1:
+        return ((mask & 0x07070700u) >> 3) | ((mask & 0xF0F0F0F0u) >> 4);
+    case 2:
+        return ((mask & 0x0F0F0F0Fu) << 4) | ((mask & 0x00E0E0E0u) << 3);
+    default:
+        return ((mask & 0x07070707u) << 5) | ((mask & 0x00F0F0F0u) << 4);
+    }
+}
+
+std::string Position::squareName(int square) {
+    std::string name;
+    name += static_cast<char>('a' + squareColumn(square));
+    name += static_cast<char>('1' + squareRow(square));
+    return name;
+}
+
+std::string Position::moveToString(const BoardMove& move) {
+    std::string text = squareName(move.from);
+
+    if (!move.isCapture()) {
+        return text + "-" + squareName(move.to);
+    }
+
+    for (int i = 0; i < move.hops; i++) {
+        text += "x" + squareName(move.path[i]);
+    }
+    return text;
+}
+
+bool Position::findMove(const std::string& text, BoardMove& move) const {
+    MoveList list;
+    generateMoves(list);
+
+    for (int i = 0; i < list.count; i++) {
+        if (moveToString(list[i]) == text) {
+            move = list[i];
+            return true;
+        }
+    }
+
+    // Short form: only the first and last square
+    if (text.size() != 5 || (text[2] != '-' && text[2] != 'x')) {
+        return false;
+    }
+
+    int matches = 0;
+    for (int i = 0; i < list.count; i++) {
+        if (squareName(list[i].from) == text.substr(0, 2) && squareName(list[i].to) == text.substr(3, 2) &&
+            list[i].isCapture() == (text[2] == 'x')) {
+            move = list[i];
+            matches++;
+        }
+    }
+    return matches == 1;
+}
+
+uint32_t Position::movers() const {
+    uint32_t own = ownPieces();
+    uint32_t empty = emptySquares();
+    uint32_t result = 0;
+
+    for (int direction = 0; direction < 4; direction++) {
+        // Pawns only move forward: white towards row 0, black towards row 7
+        bool forward = whiteToMove ? direction < 2 : direction >= 2;
+        uint32_t pieces = forward ? own : own & kings;
+        result |= shift(shift(pieces, direction) & empty, 3 - direction);
+    }
+
+    return result;
+}
+
+uint32_t Position::jumpers() const {
+    uint32_t own = ownPieces();
+    uint32_t opponent = opponentPieces();
+    uint32_t empty = emptySquares();
+    uint32_t result = 0;
+
+    // Pawns and queens both capture an adjacent piece in all four directions
+    for (int direction = 0; direction < 4; direction++) {
+        uint32_t landing = shift(shift(own, direction) & opponent, direction) & empty;
+        result |= shift(shift(landing, 3 - direction), 3 - direction);
+    }
+
+    return result;
+}
+
+void Position::generateMoves(MoveList& list) const {
+    list.count = 0;
+
+    uint32_t own = ownPieces();
+    uint32_t opponent = opponentPieces();
+    uint32_t empty = emptySquares();
+
+    // Captures are compulsory, so look for them first, starting only from pieces that can capture
+    int best = 0;
+    for (uint32_t pieces = jumpers(); pieces != 0; pieces &= pieces - 1) {
+        int square = lowestBit(pieces);
+        BoardMove current = {};
+        current.from = static_cast<uint8_t>(square);
+        addCaptures(square, (kings >> square) & 1u, empty | (1u << square), opponent, current, list, best);
+    }
+
+    if (list.count > 0) {
+        return;
+    }
+
+    // No capture available: generate the quiet one-step moves
+    uint32_t promotionRow = whiteToMove ? whitePromotionRow : blackPromotionRow;
+    for (uint32_t pieces = own; pieces != 0; pieces &= pieces - 1) {
+        int square = lowestBit(pieces);
+        bool isKing = (kings >> square) & 1u;
+
+        for (int direction = 0; direction < 4; direction++) {
+            // Pawns only move forward: white towards row 0, black towards row 7
+            if (!isKing && (whiteToMove ? direction >= 2 : direction < 2)) {
+                continue;
+            }
+
+            int target = squareTables.neighbor[square][direction];
+            if (target < 0 || ((empty >> target) & 1u) == 0) {
+                continue;
+            }
+
+            BoardMove move = {};
+            move.from = static_cast<uint8_t>(square);
+            move.to = static_cast<uint8_t>(target);
+            move.promotes = !isKing && ((promotionRow >> target) & 1u);
+            list.add(move);
+        }
+    }
+}
+
+void Position::addCaptures(int square, bool isKing, uint32_t empty, uint32_t targets, BoardMove& current, MoveList& list, int& best) const {
+    bool extended = false;
+
+    // Pawns capture in all four directions, like queens (see Pawn::countCapturingMoves)
+    for (int direction = 0; direction < 4; direction++) {
+        int over = squareTables.neighbor[square][direction];
+        if (over < 0 || ((targets >> over) & 1u) == 0) {
+            continue;
+        }
+
+        int landing = squareTables.jump[square][direction];
+        if (landing < 0 || ((empty >> landing) & 1u) == 0 || current.hops >= BoardMove::MaxHops) {
+            continue;
+        }
+
+        extended = true;
+
+        // The captured piece is removed immediately, as in countCapturingMoves
+        uint32_t overBit = 1u << over;
+        uint32_t landingBit = 1u << landing;
+        BoardMove next = current;
+        next.captured |= overBit;
+        next.capturedKings |= kings & overBit;
+        next.path[next.hops++] = static_cast<uint8_t>(landing);
+
+        addCaptures(landing, isKing, (empty | overBit | (1u << square)) & ~landingBit, targets & ~overBit, next, list, best);
+    }
+
+    if (extended || current.hops == 0 || current.hops < best) {
+        return;
+    }
+
+    // A finished sequence: keep only the longest ones
+    if (current.hops > best) {
+        best = current.hops;
+        list.count = 0;
+    }
+
+    current.to = current.path[current.hops - 1];
+    uint32_t promotionRow = whiteToMove ? whitePromotionRow : blackPromotionRow;
+    current.promotes = !isKing && ((promotionRow >> current.to) & 1u);
+
+    // Different routes capturing the same pieces are the same move
+    for (int i = 0; i < list.count; i++) {
+        if (list[i].from == current.from && list[i].to == current.to && list[i].captured == current.captured) {
+            return;
+        }
+    }
+
+    list.add(current);
+}
+
+void Position::makeMove(const BoardMove& move) {
+    uint32_t fromBit = 1u << move.from;
+    uint32_t toBit = 1u << move.to;
+    uint32_t& own = whiteToMove ? white : black;
+    uint32_t& opponent = whiteToMove ? black : white;
+
+    bool isKing = (kings & fromBit) != 0;
+    own = (own & ~fromBit) | toBit;
+    kings &= ~fromBit;
+    if (isKing || move.promotes) {
+        kings |= toBit;
+    }
+
+    opponent &= ~move.captured;
+    kings &= ~move.captured;
+    whiteToMove = !whiteToMove;
+}
+
+void Position::unmakeMove(const BoardMove& move) {
+    whiteToMove = !whiteToMove;
+
+    uint32_t fromBit = 1u << move.from;
+    uint32_t toBit = 1u << move.to;
+    uint32_t& own = whiteToMove ? white : black;
+    uint32_t& opponent = whiteToMove ? black : white;
+
+    bool isKing = (kings & toBit) != 0 && !move.promotes;
+    own = (own & ~toBit) | fromBit;
+    kings &= ~toBit;
+    if (isKing) {
+        kings |= fromBit;
+    }
+
+    opponent |= move.captured;
+    kings |= move.capturedKings;
+}
@@ -0,0 +1,371 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+#include <string>
+#include "BoardMove.h"
+#include "SquareTables.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * @brief Count the set bits of a square mask.
+ *
+ * @param mask The mask to count.
+ * @return The number of set bits.
+ */
+inline int popCount(uint32_t mask) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt(mask));
+#else
+    return __builtin_popcount(mask);
+#endif
+}
+
+/**
+ * @brief Get the index of the lowest set bit of a non-zero square mask.
+ *
+ * @param mask The mask to scan, must not be zero.
+ * @return The index (0-31) of the lowest set bit.
+ */
+inline int lowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/**
+ * @brief Count the set bits of a 64-bit square mask, used by the 10x10 variants.
+ *
+ * @param mask The mask to count.
+ * @return The number of set bits.
+ */
+inline int popCount(uint64_t mask) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(mask));
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+/**
+ * @brief Get the index of the lowest set bit of a non-zero 64-bit square mask.
+ *
+ * @param mask The mask to scan, must not be zero.
+ * @return The index (0-63) of the lowest set bit.
+ */
+inline int lowestBit(uint64_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+/**
+ * @brief Reverse the order of the bits of a square mask.
+ *
+ * Square s becomes square 31 - s, which is the square turned by 180 degrees.
+ *
+ * @param mask The mask to reverse.
+ * @return The reversed mask.
+ */
+inline uint32_t reverseBits(uint32_t mask) {
+    mask = ((mask >> 1) & 0x55555555u) | ((mask & 0x55555555u) << 1);
+    mask = ((mask >> 2) & 0x33333333u) | ((mask & 0x33333333u) << 2);
+    mask = ((mask >> 4) & 0x0F0F0F0Fu) | ((mask & 0x0F0F0F0Fu) << 4);
+    mask = ((mask >> 8) & 0x00FF00FFu) | ((mask & 0x00FF00FFu) << 8);
+    return (mask >> 16) | (mask << 16);
+}
+
+/**
+ * @brief The Position class is the compact board representation used by the engine.
+ *
+ * Only the 32 playable squares are stored, numbered row by row: square
+ * `4 * x + y / 2` is the square at row x, column y of Board (rows 0-7 from the
+ * top, columns A-H). Each side's pieces and the queens are kept as 32-bit masks,
+ * so a position fits in a few bytes and can be copied, hashed and searched
+ * without touching the heap. White pawns move towards row 0 and black pawns
+ * towards row 7, exactly as in Pawn::canMove and Board::promoteQueen.
+ */
+class Position {
+public:
+    uint32_t white;    ///< Squares holding white pieces.
+    uint32_t black;    ///< Squares holding black pieces.
+    uint32_t kings;    ///< Squares holding queens of either colour.
+    bool whiteToMove;  ///< True if white is the side to move.
+
+    /**
+     * @brief Default constructor, creates an empty board with white to move.
+     */
+    Position();
+
+    /**
+     * @brief Create the standard starting position.
+     *
+     * @return The position produced by Board::GameCreation.
+     */
+    static Position initial();
+
+    /**
+     * @brief Parse a position from text.
+     *
+     * The format is "W:W21,22,K30:B1,2,K5": the side to move, then the white and
+     * black pieces as square numbers 1-32 (square index + 1), queens prefixed by K.
+     *
+     * @param text The position text.
+     * @return The parsed position.
+     * @throw std::runtime_error if the text is not a valid position.
+     */
+    static Position fromString(const std::string& text);
+
+    /**
+     * @brief Format the position in the text format read by fromString().
+     *
+     * @return The position text.
+     */
+    std::string toString() const;
+
+    /**
+     * @brief Get a 64-bit hash of the position, including the side to move.
+     *
+     * The hash is a mix of the piece masks, so it costs a few multiplications
+     * and needs no tables. It is never zero.
+     *
+     * @return The hash key.
+     */
+    uint64_t hashKey() const;
+
+    /**
+     * @brief Get the position with the colours swapped and the board turned by 180 degrees.
+     *
+     * White pawns move towards row 0 and black pawns towards row 7, so turning
+     * the board and swapping the colours gives a position with the same moves,
+     * mirrored, and the same value for the side to move. Square s becomes
+     * square 31 - s.
+     *
+     * @return The mirrored position, with the other side to move.
+     */
+    Position mirrored() const;
+
+    /**
+     * @brief Get the representative of the position and its mirror: the one with white to move.
+     *
+     * Every position and its mirror differ in the side to move, so this picks
+     * exactly one of the two at the cost of four bit reversals at most.
+     *
+     * @return The position itself if white is to move, otherwise mirrored().
+     */
+    Position canonical() const { return whiteToMove ? *this : mirrored(); }
+
+    /**
+     * @brief Get the hash key of canonical(), equal for a position and its mirror.
+     */
+    uint64_t canonicalKey() const { return canonical().hashKey(); }
+
+    /**
+     * @brief Map a move onto the mirrored position.
+     *
+     * Applying the transform twice gives the original move back, so the same
+     * function maps a move of the canonical position back to the original.
+     *
+     * @param move A move of this position or of its mirror.
+     * @return The corresponding move of the other one.
+     */
+    static BoardMove mirrorMove(const BoardMove& move);
+
+    /**
+     * @brief Get the square index of a board coordinate.
+     *
+     * @param x The row (0-7).
+     * @param y The column (0-7).
+     * @return The square index (0-31), or -1 if the coordinate is off the board or a light square.
+     */
+    static int squareIndex(int x, int y) {
+        return x >= 0 && x < 8 && y >= 0 && y < 8 ? squareTables.index[x][y] : -1;
+    }
+
+    /**
+     * @brief Get the board row of a square index.
+     *
+     * @param square The square index (0-31).
+     * @return The row (0-7).
+     */
+    static int squareRow(int square) { return squareTables.row[square]; }
+
+    /**
+     * @brief Get the board column of a square index.
+     *
+     * @param square The square index (0-31).
+     * @return The column (0-7).
+     */
+    static int squareColumn(int square) { return squareTables.column[square]; }
+
+    /**
+     * @brief Get the diagonal neighbour of a square.
+     *
+     * Directions are 0 (row - 1, column - 1), 1 (row - 1, column + 1),
+     * 2 (row + 1, column - 1) and 3 (row + 1, column + 1).
+     *
+     * @param square The square index (0-31).
+     * @param direction The direction (0-3).
+     * @return The neighbouring square, or -1 if it is off the board.
+     */
+    static int neighbor(int square, int direction) { return squareTables.neighbor[square][direction]; }
+
+    /**
+     * @brief Get the landing square of a jump over the neighbour in a direction.
+     *
+     * @param square The square index (0-31).
+     * @param direction The direction (0-3).
+     * @return The square two steps away, or -1 if it is off the board.
+     */
+    static int jump(int square, int direction) { return squareTables.jump[square][direction]; }
+
+    /**
+     * @brief Move every square of a mask one step in a direction.
+     *
+     * This is the mask version of neighbor(): squares without a neighbour in
+     * that direction are dropped. It costs a handful of bit operations.
+     *
+     * @param mask The squares to move.
+     * @param direction The direction (0-3), as in neighbor().
+     * @return The neighbouring squares.
+     */
+    static uint32_t shift(uint32_t mask, int direction);
+
+    /**
+     * @brief Get the name of a square in the notation typed by HumanPlayer (e.g. "c6").
+     *
+     * @param square The square index (0-31).
+     * @return The square name.
+     */
+    static std::string squareName(int square);
+
+    /**
+     * @brief Format a move as text, e.g. "c6-d5" or "c6xe4xg2".
+     *
+     * @param move The move to format.
+     * @return The move text.
+     */
+    static std::string moveToString(const BoardMove& move);
+
+    /**
+     * @brief Find the legal move matching a move text.
+     *
+     * Accepts the full text produced by moveToString() or only the start and end
+     * squares ("c6xg2") when that is unambiguous.
+     *
+     * @param text The move text.
+     * @param move Receives the move when it is found.
+     * @return True if exactly one legal move matches the text.
+     */
+    bool findMove(const std::string& text, BoardMove& move) const;
+
+    /**
+     * @brief Get the pieces of the side to move.
+     *
+     * @return Mask of the squares of the side to move.
+     */
+    uint32_t ownPieces() const { return whiteToMove ? white : black; }
+
+    /**
+     * @brief Get the pieces of the side not to move.
+     *
+     * @return Mask of the squares of the opponent.
+     */
+    uint32_t opponentPieces() const { return whiteToMove ? black : white; }
+
+    /**
+     * @brief Get the empty playable squares.
+     *
+     * @return Mask of the empty squares.
+     */
+    uint32_t emptySquares() const { return ~(white | black); }
+
+    /**
+     * @brief Get the pieces of the side to move that have a non-capturing step.
+     *
+     * @return Mask of the pieces that can move to an adjacent empty square.
+     */
+    uint32_t movers() const;
+
+    /**
+     * @brief Get the pieces of the side to move that can capture.
+     *
+     * @return Mask of the pieces with at least one capture available.
+     */
+    uint32_t jumpers() const;
+
+    /**
+     * @brief Check in constant time whether the side to move must capture.
+     *
+     * @return True if a capture is available.
+     */
+    bool hasCapture() const { return jumpers() != 0; }
+
+    /**
+     * @brief Check in constant time whether the side to move has any legal move.
+     *
+     * A side without a legal move, because it has no pieces left or all of
+     * them are blocked, has lost the game.
+     *
+     * @return True if the side to move can move.
+     */
+    bool hasLegalMove() const { return (movers() | jumpers()) != 0; }
+
+    /**
+     * @brief Generate all legal moves for the side to move.
+     *
+     * Captures are compulsory and only the sequences capturing the largest
+     * number of pieces are returned, matching the "max possible capturing"
+     * rule enforced by HumanPlayer::makeMove.
+     *
+     * @param list The list that receives the moves.
+     */
+    void generateMoves(MoveList& list) const;
+
+    /**
+     * @brief Apply a move generated for this position.
+     *
+     * @param move The move to make.
+     */
+    void makeMove(const BoardMove& move);
+
+    /**
+     * @brief Take back a move previously applied with makeMove.
+     *
+     * @param move The move to unmake.
+     */
+    void unmakeMove(const BoardMove& move);
+
+    bool operator==(const Position& other) const {
+        return white == other.white && black == other.black && kings == other.kings && whiteToMove == other.whiteToMove;
+    }
+
+    bool operator!=(const Position& other) const { return !(*this == other); }
+
+private:
+    /**
+     * @brief Recursively extend a jump sequence and record the finished captures.
+     *
+     * @param square The square the capturing piece currently stands on.
+     * @param isKing True if the capturing piece is a queen.
+     * @param empty Squares currently free to land on.
+     * @param targets Opponent pieces that may still be captured.
+     * @param current The partially built move.
+     * @param list The list that receives the moves.
+     * @param best The longest capture sequence recorded so far.
+     */
+    void addCaptures(int square, bool isKing, uint32_t empty, uint32_t targets, BoardMove& current, MoveList& list, int& best) const;
+};
+
+#endif
@@ -0,0 +1,318 @@
+#include "PositionDatabase.h"
+#include "GameAnnotator.h"
+#include "MemoryAccounting.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @file PositionDatabase.cpp
+ * @brief Implementation of the on-disk position index.
+ */
+
+namespace {
+    const char Magic[4] = { 'C', 'K', 'D', 'B' };
+    const size_t MaxListed = 20;    ///< Occurrences listed by report().
+
+    bool recordLess(const PositionDatabase::Record& a, const PositionDatabase::Record& b) {
+        if (a.key != b.key) {
+            return a.key < b.key;
+        }
+        return a.game != b.game ? a.game < b.game : a.ply < b.ply;
+    }
+
+    int indexOf(const MoveList& list, const BoardMove& move) {
+        for (int i = 0; i < list.count; i++) {
+            if (list[i].from == move.from && list[i].to == move.to && list[i].captured == move.captured) {
+                return i;
+            }
+        }
+        return PositionDatabase::NoMove;
+    }
+
+    int8_t mirrorResult(int8_t result) {
+        return result == PositionDatabase::Unknown ? result : static_cast<int8_t>(-result);
+    }
+
+    bool fileExists(const std::string& path) {
+        std::ifstream stream(path);
+        return static_cast<bool>(stream);
+    }
+
+    void replaceFile(const std::string& temporary, const std::string& path) {
+#ifdef _WIN32
+        std::remove(path.c_str()); // rename does not replace an existing file on Windows
+#endif
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Cannot replace " + path);
+        }
+    }
+
+    const char* resultName(int8_t result) {
+        switch (result) {
+        case PositionDatabase::WhiteWin:
+            return "1-0";
+        case PositionDatabase::BlackWin:
+            return "0-1";
+        case PositionDatabase::Draw:
+            return "1/2-1/2";
+        default:
+            return "*";
+        }
+    }
+}
+
+static_assert(sizeof(PositionDatabase::Record) == 16, "the index stores 16-byte records");
+
+PositionDatabase::PositionDatabase(const std::string& name)
+    : name(name), file(new MappedFile(name + ".idx")), records(nullptr), count(0), games(0) {
+    Header header;
+    if (file->size() < sizeof(header)) {
+        throw std::runtime_error(name + ".idx is not a position database.");
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) {
+        throw std::runtime_error(name + ".idx is not a position database.");
+    }
+    if (header.version != FileVersion) {
+        throw std::runtime_error(name + ".idx has format version " + std::to_string(header.version) + ", expected " +
+            std::to_string(FileVersion) + ".");
+    }
+    if (file->size() != sizeof(header) + header.count * sizeof(Record)) {
+        throw std::runtime_error(name + ".idx is truncated.");
+    }
+
+    count = header.count;
+    games = header.games;
+    records = reinterpret_cast<const Record*>(file->data() + sizeof(header));
+
+    MemoryScope scope(MemoryTag::Books);
+    fence.reserve(static_cast<size_t>(count / FenceStride + 1));
+    for (uint64_t i = 0; i < count; i += FenceStride) {
+        fence.push_back(records[i].key);
+    }
+}
+
+std::vector<PositionDatabase::Record> PositionDatabase::find(uint64_t key) const {
+    std::vector<Record> found;
+    if (count == 0) {
+        return found;
+    }
+
+    // Runs of equal keys may start in the block before the first fence key that is not smaller
+    size_t block = std::lower_bound(fence.begin(), fence.end(), key) - fence.begin();
+    uint64_t first = block > 0 ? (block - 1) * FenceStride : 0;
+    uint64_t last = std::min<uint64_t>(count, (block + 1) * FenceStride);
+
+    const Record* start = std::lower_bound(records + first, records + last, key,
+        [](const Record& record, uint64_t value) { return record.key < value; });
+    for (const Record* record = start; record < records + count && record->key == key; record++) {
+        found.push_back(*record);
+    }
+    return found;
+}
+
+void PositionDatabase::add(const std::string& name, const std::vector<std::string>& collections, std::ostream& stream) {
+    MemoryScope scope(MemoryTag::Books);
+    std::string indexPath = name + ".idx";
+    std::unique_ptr<PositionDatabase> existing;
+    if (fileExists(indexPath)) {
+        existing.reset(new PositionDatabase(name));
+    }
+    uint32_t firstGame = existing ? existing->games : 0;
+
+    // Replay the new games only
+    std::vector<Record> added;
+    std::ostringstream gameList;
+    uint32_t game = firstGame;
+    for (const std::string& collection : collections) {
+        std::vector<GameAnnotator::Game> loaded = GameAnnotator::load(collection);
+        for (const GameAnnotator::Game& entry : loaded) {
+            Result result = parseResult(entry.result);
+            Position position = entry.moves.start();
+            for (int ply = 0; ply <= entry.moves.length(); ply++) {
+                // Positions with black to move are stored as their mirror
+                Position canonical = position.canonical();
+                bool mirrored = canonical != position;
+                int8_t stored = mirrored ? mirrorResult(result) : static_cast<int8_t>(result);
+                Record record = { position.canonicalKey(), game, static_cast<uint16_t>(ply), NoMove, stored };
+                if (ply < entry.moves.length()) {
+                    MoveList list;
+                    position.generateMoves(list);
+                    const BoardMove& move = list[entry.moves[ply].find(list)];
+                    if (mirrored) {
+                        MoveList canonicalList;
+                        canonical.generateMoves(canonicalList);
+                        record.move = static_cast<uint8_t>(indexOf(canonicalList, Position::mirrorMove(move)));
+                    }
+                    else {
+                        record.move = static_cast<uint8_t>(indexOf(list, move));
+                    }
+                    position.makeMove(move);
+                }
+                added.push_back(record);
+            }
+            gameList << game << " " << resultName(result) << " " << collection << ":" << entry.line << "\n";
+            game++;
+        }
+    }
+    std::sort(added.begin(), added.end(), recordLess);
+
+    // Merge with the existing index into a new file, then replace it
+    std::string temporary = indexPath + ".tmp";
+    uint64_t total = 0;
+    {
+        const Record* old = existing ? existing->records : nullptr;
+        uint64_t oldCount = existing ? existing->count : 0;
+
+        std::ofstream output(temporary, std::ios::binary);
+        if (!output) {
+            throw std::runtime_error("Cannot write " + temporary);
+        }
+        Header header;
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = FileVersion;
+        header.count = oldCount + added.size();
+        header.games = game;
+        header.reserved = 0;
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<Record> buffer;
+        buffer.reserve(4096);
+        uint64_t i = 0;
+        size_t j = 0;
+        while (i < oldCount || j < added.size()) {
+            if (j == added.size() || (i < oldCount && !recordLess(added[j], old[i]))) {
+                buffer.push_back(old[i++]);
+            }
+            else {
+                buffer.push_back(added[j++]);
+            }
+            if (buffer.size() == buffer.capacity()) {
+                output.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Record));
+                buffer.clear();
+            }
+        }
+        output.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Record));
+        total = header.count;
+        if (!output) {
+            throw std::runtime_error("Cannot write " + temporary);
+        }
+    }
+    existing.reset(); // unmap before replacing the file
+
+    // The game list is rewritten aside as well, and replaced only after the index: games the
+    // index does not cover would be indexed a second time by the next run
+    std::string listPath = name + ".games";
+    std::string listTemporary = listPath + ".tmp";
+    {
+        std::ofstream list(listTemporary);
+        std::ifstream previous(listPath);
+        if (previous.peek() != std::ifstream::traits_type::eof()) {
+            list << previous.rdbuf();
+        }
+        list << gameList.str();
+        if (!list) {
+            throw std::runtime_error("Cannot write " + listTemporary);
+        }
+    }
+    replaceFile(temporary, indexPath);
+    replaceFile(listTemporary, listPath);
+
+    stream << "Added " << game - firstGame << " games and " << added.size() << " positions; " << name << " now holds "
+        << game << " games and " << total << " positions." << std::endl;
+}
+
+void PositionDatabase::report(const Position& position, std::ostream& stream) const {
+    auto start = std::chrono::steady_clock::now();
+    Position canonical = position.canonical();
+    bool mirrored = canonical != position;
+    std::vector<Record> found = find(position.canonicalKey());
+    double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    std::set<uint32_t> distinct;
+    for (const Record& record : found) {
+        distinct.insert(record.game);
+    }
+    stream << position.toString() << " occurs " << found.size() << " times in " << distinct.size() << " of " << games
+        << " games (lookup " << std::fixed << std::setprecision(1) << microseconds << " us)" << std::defaultfloat
+        << std::setprecision(6) << std::endl;
+    if (found.empty()) {
+        return;
+    }
+
+    // Results after each continuation: white wins, draws, black wins, unknown
+    // Moves and results are stored for the canonical position and mapped back to the one asked for
+    MoveList list;
+    canonical.generateMoves(list);
+    auto moveName = [&list, mirrored](uint8_t index) {
+        if (index >= list.count) {
+            return std::string("(game end)");
+        }
+        return Position::moveToString(mirrored ? Position::mirrorMove(list[index]) : list[index]);
+    };
+
+    std::map<int, std::array<int, 4>> continuations;
+    for (const Record& record : found) {
+        int8_t result = mirrored ? mirrorResult(record.result) : record.result;
+        int column = result == WhiteWin ? 0 : result == Draw ? 1 : result == BlackWin ? 2 : 3;
+        continuations[record.move][column]++;
+    }
+
+    stream << std::left << std::setw(16) << "next move" << std::right << std::setw(8) << "1-0" << std::setw(8) << "draw"
+        << std::setw(8) << "0-1" << std::setw(8) << "*" << std::endl;
+    for (const auto& continuation : continuations) {
+        stream << std::left << std::setw(16) << moveName(static_cast<uint8_t>(continuation.first)) << std::right;
+        for (int column = 0; column < 4; column++) {
+            stream << std::setw(8) << continuation.second[column];
+        }
+        stream << std::endl;
+    }
+
+    // Sources of the listed occurrences from the game list
+    std::map<uint32_t, std::string> sources;
+    for (size_t i = 0; i < found.size() && i < MaxListed; i++) {
+        sources[found[i].game] = "";
+    }
+    std::ifstream gameList(name + ".games");
+    std::string line;
+    while (std::getline(gameList, line)) {
+        uint32_t game = static_cast<uint32_t>(std::strtoul(line.c_str(), nullptr, 10));
+        auto source = sources.find(game);
+        if (source != sources.end()) {
+            source->second = line.substr(line.rfind(' ') + 1);
+        }
+    }
+
+    for (size_t i = 0; i < found.size() && i < MaxListed; i++) {
+        const Record& record = found[i];
+        stream << "game " << record.game << " ply " << record.ply << " next " << moveName(record.move) << " result "
+            << resultName(mirrored ? mirrorResult(record.result) : record.result)
+            << " " << sources[record.game] << std::endl;
+    }
+    if (found.size() > MaxListed) {
+        stream << "... and " << found.size() - MaxListed << " more" << std::endl;
+    }
+}
+
+PositionDatabase::Result PositionDatabase::parseResult(const std::string& text) {
+    if (text == "1-0" || text == "2-0") {
+        return WhiteWin;
+    }
+    if (text == "0-1" || text == "0-2") {
+        return BlackWin;
+    }
+    if (text == "1/2-1/2" || text == "1-1") {
+        return Draw;
+    }
+    return Unknown;
+}
@@ -0,0 +1,134 @@
+#ifndef POSITIONDATABASE_H
+#define POSITIONDATABASE_H
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Position.h"
+
+/**
+ * @brief The PositionDatabase class finds the games in which a position occurred.
+ *
+ * A database is two files. "<name>.idx" holds one 16-byte Record per position
+ * of every game, sorted by the position's hash key, after a small header.
+ * "<name>.games" lists the games, one per line: number, result and the
+ * collection line it came from.
+ *
+ * The index is read through a memory mapping. Opening it only reads every
+ * FenceStride-th key into a fence array; a lookup searches the fence array in
+ * memory, then a single block of the mapping, so it touches one or two pages
+ * of the file and takes microseconds even for millions of games.
+ *
+ * A position and its mirror (colours swapped, board turned by 180 degrees)
+ * share their records: every record describes Position::canonical(), the one
+ * with white to move, with the next move and the result mapped onto it. A
+ * query maps its position the same way and the answers back.
+ *
+ * add() only replays the new games: their records are sorted in memory and
+ * merged with the existing index in one sequential pass, and the new games
+ * are added to the game list. Both files are written aside and replaced, the
+ * index first, so a failed run never leaves games listed that the index does
+ * not count. The files use the byte order of the machine.
+ */
+class PositionDatabase {
+public:
+    static const uint32_t FileVersion = 2;      ///< Format version, checked on open.
+    static const size_t FenceStride = 64;       ///< Records per block of the fence array.
+    static const uint8_t NoMove = 255;          ///< Move of the last position of a game.
+
+    /**
+     * @brief The Result enum is the outcome of a game from white's point of view.
+     */
+    enum Result : int8_t {
+        BlackWin = -1,
+        Draw = 0,
+        WhiteWin = 1,
+        Unknown = 2
+    };
+
+    /**
+     * @brief The Record struct is one position of one game.
+     */
+    struct Record {
+        uint64_t key;       ///< Position::canonicalKey() of the position.
+        uint32_t game;      ///< Game number, from 0.
+        uint16_t ply;       ///< Plies played before the position.
+        uint8_t move;       ///< Index of the next move in the canonical position's generated move list, or NoMove.
+        int8_t result;      ///< Result of the game, colours swapped if the position was mirrored.
+    };
+
+    /**
+     * @brief Open a database for queries.
+     *
+     * @param name The database name without extension.
+     * @throw std::runtime_error if the index is missing, of another version or damaged.
+     */
+    explicit PositionDatabase(const std::string& name);
+
+    /**
+     * @brief Get the number of indexed positions.
+     */
+    uint64_t size() const { return count; }
+
+    /**
+     * @brief Get the number of games.
+     */
+    uint32_t gameCount() const { return games; }
+
+    /**
+     * @brief Find every occurrence of a position.
+     *
+     * @param key The position's Position::canonicalKey().
+     * @return The records, sorted by game and ply.
+     */
+    std::vector<Record> find(uint64_t key) const;
+
+    /**
+     * @brief Add the games of collections to a database, creating it if needed.
+     *
+     * Collections use the format read by GameAnnotator::load().
+     *
+     * @param name The database name without extension.
+     * @param collections The collection files.
+     * @param stream Receives a progress report.
+     * @throw std::runtime_error if a file cannot be read or written.
+     */
+    static void add(const std::string& name, const std::vector<std::string>& collections, std::ostream& stream);
+
+    /**
+     * @brief Print where a position occurred and the moves played from it.
+     *
+     * @param position The position.
+     * @param stream Receives the report.
+     */
+    void report(const Position& position, std::ostream& stream) const;
+
+    /**
+     * @brief Convert a result as written in a collection.
+     */
+    static Result parseResult(const std::string& text);
+
+private:
+    /**
+     * @brief The Header struct starts the index file.
+     */
+    struct Header {
+        char magic[4];          ///< "CKDB".
+        uint32_t version;       ///< FileVersion.
+        uint64_t count;         ///< Number of records.
+        uint32_t games;         ///< Number of games.
+        uint32_t reserved;      ///< Zero.
+    };
+
+    std::string name;                       ///< Database name without extension.
+    std::unique_ptr<MappedFile> file;       ///< The mapped index.
+    const Record* records;                  ///< Records in the mapping.
+    uint64_t count;                         ///< Number of records.
+    uint32_t games;                         ///< Number of games.
+    std::vector<uint64_t> fence;            ///< Key of the first record of every block.
+};
+
+#endif
@@ -50,24 +50,6 @@ public:
      * @return The number of capturing moves the queen can make.
      */
     int countCapturingMoves(Board& board, Square& start, bool isWhite) const override;
-
-    /**
-     * @brief Simulate and validate capturing moves for the queen.
-     *
-     * This function simulates capturing moves for the queen and validates whether
-     * they are legal. It keeps track of captured pawn positions and the maximum
-     * number of capturing moves allowed.
-     *
-     * @param board The chess board on which moves are simulated and validated.
-     * @param start The starting square of the queen.
-     * @param isWhite Indicates whether the queen is white.
-     * @param capturedPawnPositions A vector to store captured pawn positions.
-     * @param maxCapturingMoves The maximum number of capturing moves allowed.
-     * @param endSquare The ending square to validate.
-     * @param piece The queen chess piece.
-     * @return True if the capturing moves are valid, otherwise false.
-     */
-    bool simulateAndValidateCapturingMoves(Board& board, Square& start, bool isWhite, std::vector<Square*>& capturedPawnPositions, int maxCapturingMoves, Square& endSquare, Piece* piece);
 };
 
 #endif
@@ -0,0 +1,82 @@
+#ifndef RULES_H
+#define RULES_H
+
+/**
+ * @file Rules.h
+ * @brief Compile-time rule policies for the draughts variants supported by VariantPosition.
+ *
+ * A policy is a struct of constants. VariantPosition is instantiated once per
+ * policy, so every rule decision is made by the compiler (`if constexpr`) and
+ * the generated move generator contains no runtime rule checks.
+ *
+ * Every policy defines:
+ * - `Size`: board side (8 or 10); pieces start on the first Size / 2 - 1 rows.
+ * - `FlyingKings`: kings move and capture along whole diagonals instead of one step.
+ * - `MenCaptureBackward`: men may also capture towards their own side.
+ * - `MaximumCapture`: only the sequences capturing the most pieces are legal.
+ * - `ImmediateRemoval`: captured pieces leave the board at once instead of at the end of the move.
+ * - `CrownDuringCapture`: a man reaching the last row mid-capture continues capturing as a king.
+ * - `CrowningEndsMove`: a man reaching the last row mid-capture stops there and is crowned.
+ * - `Name`: name used on the command line.
+ */
+
+/**
+ * @brief The rules of the interactive game, as implemented by Position.
+ *
+ * Men capture in all directions, kings move one step, the longest capture is
+ * compulsory and captured pieces are removed immediately.
+ */
+struct HouseRules {
+    static constexpr int Size = 8;
+    static constexpr bool FlyingKings = false;
+    static constexpr bool MenCaptureBackward = true;
+    static constexpr bool MaximumCapture = true;
+    static constexpr bool ImmediateRemoval = true;
+    static constexpr bool CrownDuringCapture = false;
+    static constexpr bool CrowningEndsMove = false;
+    static constexpr const char* Name = "house";
+};
+
+/**
+ * @brief English draughts (checkers): men capture forward only, short kings, free choice of capture.
+ */
+struct EnglishRules {
+    static constexpr int Size = 8;
+    static constexpr bool FlyingKings = false;
+    static constexpr bool MenCaptureBackward = false;
+    static constexpr bool MaximumCapture = false;
+    static constexpr bool ImmediateRemoval = false;
+    static constexpr bool CrownDuringCapture = false;
+    static constexpr bool CrowningEndsMove = true;
+    static constexpr const char* Name = "english";
+};
+
+/**
+ * @brief Russian draughts: flying kings, backward captures, free choice of capture, crowning mid-capture.
+ */
+struct RussianRules {
+    static constexpr int Size = 8;
+    static constexpr bool FlyingKings = true;
+    static constexpr bool MenCaptureBackward = true;
+    static constexpr bool MaximumCapture = false;
+    static constexpr bool ImmediateRemoval = false;
+    static constexpr bool CrownDuringCapture = true;
+    static constexpr bool CrowningEndsMove = false;
+    static constexpr const char* Name = "russian";
+};
+
+/**
+ * @brief International draughts on 10x10: flying kings, backward captures, maximum capture.
+ */
+struct InternationalRules {
+    static constexpr int Size = 10;
+    static constexpr bool FlyingKings = true;
+    static constexpr bool MenCaptureBackward = true;
+    static constexpr bool MaximumCapture = true;
+    static constexpr bool ImmediateRemoval = false;
+    static constexpr bool CrownDuringCapture = false;
+    static constexpr bool CrowningEndsMove = false;
+    static constexpr const char* Name = "international";
+};
+
+#endif
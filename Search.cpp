@@ -0,0 +1,424 @@
+#include "Search.h"
+#include "Evaluation.h"
+#include "MemoryAccounting.h"
+#include "Telemetry.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @file Search.cpp
+ * @brief Implementation of the alpha-beta search.
+ */
+
+namespace {
+    const int Infinity = 32000;
+
+    /**
+     * @brief Make a mate score relative to the node before storing it.
+     */
+    int scoreToTable(int score, int ply) {
+        if (score > Search::MateBound) {
+            return score + ply;
+        }
+        if (score < -Search::MateBound) {
+            return score - ply;
+        }
+        return score;
+    }
+
+    /**
+     * @brief Make a stored mate score relative to the root again.
+     */
+    int scoreFromTable(int score, int ply) {
+        if (score > Search::MateBound) {
+            return score - ply;
+        }
+        if (score < -Search::MateBound) {
+            return score + ply;
+        }
+        return score;
+    }
+}
+
+Search::Search(size_t hashMegabytes)
+    : table(hashMegabytes), stopFlag(false), nodes(0), tableProbes(0), tableHits(0), quiescenceNodes(0),
+      excluding(false), networkKey(0) {
+    MemoryScope scope(MemoryTag::Search);
+    statistics.reset(new SearchStatistics());
+    std::memset(history, 0, sizeof(history));
+    std::memset(pvLength, 0, sizeof(pvLength));
+}
+
+void Search::stop() {
+    stopFlag.store(true);
+}
+
+void Search::clear() {
+    table.clear();
+    std::memset(history, 0, sizeof(history));
+}
+
+uint64_t Search::fingerprint() {
+    static const uint64_t value = [] {
+        uint64_t hash = 14695981039346656037ULL;
+        auto mix = [&hash](uint64_t data) {
+            hash = (hash ^ data) * 1099511628211ULL;
+        };
+        mix(MateScore);
+        mix(TranspositionTable::FileVersion);
+
+        std::function<void(Position&, int)> walk = [&](Position& position, int depth) {
+            MoveList list;
+            position.generateMoves(list);
+            mix(position.hashKey());
+            mix(static_cast<uint64_t>(list.count));
+            mix(static_cast<uint64_t>(static_cast<int64_t>(Evaluation::evaluate(position))));
+            for (int i = 0; i < list.count && depth > 0; i++) {
+                position.makeMove(list[i]);
+                walk(position, depth - 1);
+                position.unmakeMove(list[i]);
+            }
+        };
+        Position start = Position::initial();
+        walk(start, 3);
+        return hash;
+    }();
+    return value;
+}
+
+void Search::setHashSize(size_t megabytes) {
+    table.resize(megabytes);
+}
+
+void Search::setNetwork(const NnueNetwork* network) {
+    if (network == nullptr) {
+        nnue.reset();
+        networkKey = 0;
+    }
+    else {
+        MemoryScope scope(MemoryTag::Search);
+        nnue.reset(new NnueEvaluator(*network));
+        networkKey = network->checksum();
+    }
+    clear();
+}
+
+void Search::setStatistics(bool enabled) {
+    if (!enabled) {
+        statistics.reset();
+    }
+    else if (!statistics) {
+        MemoryScope scope(MemoryTag::Search);
+        statistics.reset(new SearchStatistics());
+    }
+}
+
+const SearchStatistics& Search::getStatistics() const {
+    static const SearchStatistics none;
+    return statistics ? *statistics : none;
+}
+
+double Search::elapsedSeconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+SearchResult Search::think(const Position& root, const SearchLimits& searchLimits, const std::function<void(const SearchInfo&)>& onInfo,
+    const GameHistory* gameHistory) {
+    TRACE_SCOPE("search");
+    limits = searchLimits;
+    if (gameHistory != nullptr && gameHistory->lastKey() == root.hashKey()) {
+        positions = *gameHistory;
+    }
+    else {
+        positions.reset(root.hashKey());
+    }
+    start = std::chrono::steady_clock::now();
+    nodes = 0;
+    tableProbes = 0;
+    tableHits = 0;
+    quiescenceNodes = 0;
+    stopFlag.store(false);
+    table.newSearch();
+
+    // Age the history so that old games do not dominate the ordering
+    for (auto& colour : history) {
+        for (auto& from : colour) {
+            for (int& score : from) {
+                score /= 2;
+            }
+        }
+    }
+
+    SearchResult result = {};
+    MoveList list;
+    root.generateMoves(list);
+    result.hasMove = list.count > 0;
+    if (!result.hasMove) {
+        result.score = -MateScore;
+        return result;
+    }
+    result.bestMove = list[0];
+
+    Position position = root;
+    if (nnue) {
+        nnue->reset(root);
+    }
+    int lineCount = limits.lines < list.count ? limits.lines : list.count;
+    if (lineCount < 1) {
+        lineCount = 1;
+    }
+    int maxDepth = limits.depth < MaxPly - 1 ? limits.depth : MaxPly - 1;
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        TRACE_SCOPE("iteration");
+
+        // Each further line searches the root without the moves of the lines above it
+        std::vector<SearchLine> lines;
+        std::fill(rootExcluded, rootExcluded + list.count, false);
+        excluding = false;
+        for (int line = 0; line < lineCount && !stopFlag.load(); line++) {
+            int score = negamax(position, depth, -Infinity, Infinity, 0);
+            if (stopFlag.load() || pvLength[0] == 0) {
+                break;
+            }
+
+            SearchLine searched = { score, depth, principalVariation(root) };
+            lines.push_back(searched);
+            rootExcluded[pvTable[0][0]] = true;
+            excluding = true;
+
+            if (onInfo) {
+                SearchInfo info = { depth, line + 1, score, nodes, elapsedSeconds(), searched.pv };
+                onInfo(info);
+            }
+        }
+        excluding = false;
+        if (static_cast<int>(lines.size()) < lineCount) {
+            break; // The interrupted iteration is not trusted
+        }
+
+        result.lines = lines;
+        result.score = lines[0].score;
+        result.depth = depth;
+        result.pv = lines[0].pv;
+        if (!result.pv.empty()) {
+            result.bestMove = result.pv[0];
+        }
+
+        // A forced result will not change, and another iteration would not finish in time
+        bool forced = true;
+        for (const SearchLine& line : lines) {
+            forced = forced && (line.score > MateBound || line.score < -MateBound);
+        }
+        if (forced) {
+            break;
+        }
+        if (limits.milliseconds > 0 && elapsedSeconds() * 1000.0 > limits.milliseconds / 2.0) {
+            break;
+        }
+    }
+
+    result.nodes = nodes;
+    result.seconds = elapsedSeconds();
+    result.tableProbes = tableProbes;
+    result.tableHits = tableHits;
+    result.quiescenceNodes = quiescenceNodes;
+    if (statistics) {
+        statistics->record(result);
+        Telemetry::process().total().record(result);
+    }
+    return result;
+}
+
+void Search::checkLimits() {
+    if (limits.nodes > 0 && nodes >= limits.nodes) {
+        stopFlag.store(true);
+    }
+    if (limits.milliseconds > 0 && elapsedSeconds() * 1000.0 >= limits.milliseconds) {
+        stopFlag.store(true);
+    }
+}
+
+int Search::negamax(Position& position, int depth, int alpha, int beta, int ply) {
+    pvLength[ply] = 0;
+
+    if ((++nodes & 1023) == 0) {
+        checkLimits();
+    }
+    if (depth <= 0) {
+        quiescenceNodes++;
+    }
+    if (stopFlag.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    // A repetition would be repeated again by best play, so it is scored as the draw it leads to
+    if (ply > 0 && (positions.repetitions() > 0 || positions.isMoveLimitReached())) {
+        return 0;
+    }
+
+    // Quiescence: below the horizon only compulsory captures are searched further.
+    // The constant-time summaries decide this without generating the moves.
+    if ((depth <= 0 && !position.hasCapture()) || ply >= MaxPly - 1) {
+        if (!position.hasLegalMove()) {
+            return -MateScore + ply; // No pieces or no legal move: the side to move has lost
+        }
+        TRACE_SCOPE("evaluate");
+        return evaluate(position);
+    }
+
+    MoveList list;
+    {
+        TRACE_SCOPE("generate moves");
+        position.generateMoves(list);
+    }
+    if (list.count == 0) {
+        return -MateScore + ply;
+    }
+    if (depth < 0) {
+        depth = 0;
+    }
+
+    uint64_t key = position.hashKey();
+    int ttMove = -1;
+    const TTEntry* entry;
+    {
+        TRACE_SCOPE("tt probe");
+        entry = table.probe(key);
+    }
+    tableProbes++;
+    if (entry != nullptr) {
+        tableHits++;
+        if (entry->moveIndex < list.count) {
+            ttMove = entry->moveIndex;
+        }
+        // Cut only in null-window nodes so that the principal variation stays complete
+        if (ply > 0 && beta - alpha == 1 && entry->depth >= depth) {
+            int score = scoreFromTable(entry->score, ply);
+            if (entry->bound == TranspositionTable::Exact ||
+                (entry->bound == TranspositionTable::Lower && score >= beta) ||
+                (entry->bound == TranspositionTable::Upper && score <= alpha)) {
+                return score;
+            }
+        }
+    }
+
+    uint8_t order[MoveList::Capacity];
+    orderMoves(position, list, ttMove, order);
+
+    int bestScore = -Infinity;
+    int bestIndex = order[0];
+    uint8_t bound = TranspositionTable::Upper;
+
+    int searched = 0;
+    for (int n = 0; n < list.count; n++) {
+        int i = order[n];
+        if (ply == 0 && excluding && rootExcluded[i]) {
+            continue;
+        }
+        bool irreversible = GameHistory::isIrreversible(position, list[i]);
+        if (nnue) {
+            nnue->push(position, list[i]);
+        }
+        position.makeMove(list[i]);
+        positions.push(position.hashKey(), irreversible);
+
+        int score;
+        if (searched++ == 0) {
+            score = -negamax(position, depth - 1, -beta, -alpha, ply + 1);
+        }
+        else {
+            // Null window first, full window only if the move might be better
+            score = -negamax(position, depth - 1, -alpha - 1, -alpha, ply + 1);
+            if (score > alpha && score < beta) {
+                score = -negamax(position, depth - 1, -beta, -alpha, ply + 1);
+            }
+        }
+
+        positions.pop();
+        position.unmakeMove(list[i]);
+        if (nnue) {
+            nnue->pop();
+        }
+
+        if (stopFlag.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestIndex = i;
+
+            if (score > alpha) {
+                alpha = score;
+                bound = TranspositionTable::Exact;
+
+                pvTable[ply][0] = static_cast<uint8_t>(i);
+                std::memcpy(&pvTable[ply][1], &pvTable[ply + 1][0], pvLength[ply + 1]);
+                pvLength[ply] = pvLength[ply + 1] + 1;
+
+                if (score >= beta) {
+                    bound = TranspositionTable::Lower;
+                    if (!list[i].isCapture()) {
+                        history[position.whiteToMove ? 0 : 1][list[i].from][list[i].to] += depth * depth;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // A root search without some moves has not found the score of the position
+    if (ply > 0 || !excluding) {
+        table.store(key, scoreToTable(bestScore, ply), depth, bound, static_cast<uint8_t>(bestIndex));
+    }
+    return bestScore;
+}
+
+void Search::orderMoves(const Position& position, MoveList& list, int ttMove, uint8_t* indices) const {
+    int scores[MoveList::Capacity];
+    int colour = position.whiteToMove ? 0 : 1;
+
+    for (int i = 0; i < list.count; i++) {
+        const BoardMove& move = list[i];
+        int score = history[colour][move.from][move.to];
+        if (move.promotes) {
+            score += 1 << 20;
+        }
+        if (i == ttMove) {
+            score += 1 << 30;
+        }
+        scores[i] = score;
+        indices[i] = static_cast<uint8_t>(i);
+    }
+
+    // Insertion sort: move lists are short
+    for (int i = 1; i < list.count; i++) {
+        uint8_t index = indices[i];
+        int score = scores[index];
+        int j = i - 1;
+        while (j >= 0 && scores[indices[j]] < score) {
+            indices[j + 1] = indices[j];
+            j--;
+        }
+        indices[j + 1] = index;
+    }
+}
+
+std::vector<BoardMove> Search::principalVariation(const Position& root) const {
+    std::vector<BoardMove> pv;
+    Position position = root;
+
+    for (int k = 0; k < pvLength[0]; k++) {
+        MoveList list;
+        position.generateMoves(list);
+        int index = pvTable[0][k];
+        if (index >= list.count) {
+            break;
+        }
+        pv.push_back(list[index]);
+        position.makeMove(list[index]);
+    }
+
+    return pv;
+}
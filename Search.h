@@ -0,0 +1,258 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Evaluation.h"
+#include "GameHistory.h"
+#include "Nnue.h"
+#include "Position.h"
+#include "SearchStatistics.h"
+#include "TranspositionTable.h"
+
+/**
+ * @brief The SearchLimits struct tells a search when to stop.
+ *
+ * A value of 0 means "no limit" for nodes and milliseconds.
+ */
+struct SearchLimits {
+    int depth = 64;            ///< Maximum iterative deepening depth.
+    long long nodes = 0;       ///< Node budget.
+    int milliseconds = 0;      ///< Time budget.
+    int lines = 1;             ///< Number of best root moves to search exactly (Multi-PV).
+};
+
+/**
+ * @brief The SearchInfo struct reports one finished iteration of the search.
+ */
+struct SearchInfo {
+    int depth;                      ///< Depth of the iteration.
+    int line;                       ///< Rank of the line among the best root moves, 1 for the best.
+    int score;                      ///< Score for the side to move in hundredths of a pawn.
+    long long nodes;                ///< Nodes searched so far.
+    double seconds;                 ///< Time spent so far.
+    std::vector<BoardMove> pv;      ///< Principal variation.
+};
+
+/**
+ * @brief The SearchLine struct is one of the best root moves found by a Multi-PV search.
+ */
+struct SearchLine {
+    int score;                      ///< Score of the line.
+    int depth;                      ///< Depth it was searched to.
+    std::vector<BoardMove> pv;      ///< The root move and its principal variation.
+};
+
+/**
+ * @brief The SearchResult struct is the outcome of a search.
+ */
+struct SearchResult {
+    bool hasMove;                   ///< False if the root position has no legal move.
+    BoardMove bestMove;             ///< The move to play.
+    int score;                      ///< Score of the best move.
+    int depth;                      ///< Depth of the last finished iteration.
+    long long nodes;                ///< Nodes searched.
+    double seconds;                 ///< Time spent.
+    std::vector<BoardMove> pv;      ///< Principal variation.
+    long long tableProbes;          ///< Transposition table lookups.
+    long long tableHits;            ///< Lookups that found an entry.
+    long long quiescenceNodes;      ///< Nodes searched below the nominal depth.
+    std::vector<SearchLine> lines;  ///< The best root moves, best first; limits.lines of them at most.
+};
+
+/**
+ * @brief The Search class is the alpha-beta engine behind ComputerPlayer and the engine protocol.
+ *
+ * It runs an iterative deepening principal variation search with a
+ * transposition table and history move ordering. At depth 0 positions with a
+ * compulsory capture are searched further (the checkers quiescence search), so
+ * the static evaluation is only used in quiet positions. A position that
+ * repeats one already on the path or in the game, or that reaches the move
+ * limit, is scored as a draw. The search can be stopped from another thread
+ * at any time with stop().
+ *
+ * With SearchLimits::lines above one every iteration searches the root again
+ * for each line, excluding the root moves already ranked above it, so each
+ * line gets an exact score. The repeated root searches share the root move
+ * list, the transposition table and the move ordering, and mostly cost the
+ * part of the tree under the newly ranked move.
+ *
+ * Positions are scored by the classic Evaluation, or by an NNUE network
+ * chosen with setNetwork(), whose accumulator follows the moves of the search.
+ */
+class Search {
+public:
+    static const int MaxPly = 128;           ///< Deepest ply the search can reach.
+    static const int MateScore = 30000;      ///< Score of a position where the side to move has lost.
+    static const int MateBound = 29000;      ///< Scores above this are mate scores.
+
+    /**
+     * @brief Constructor for the Search class.
+     *
+     * @param hashMegabytes Size of the transposition table.
+     */
+    explicit Search(size_t hashMegabytes);
+
+    /**
+     * @brief Search a position.
+     *
+     * @param root The position to search.
+     * @param limits When to stop.
+     * @param onInfo Called after each finished iteration, may be empty.
+     * @param gameHistory Positions of the game ending with root, used to score repetitions and the move limit as draws; may be null.
+     * @return The best move found.
+     */
+    SearchResult think(const Position& root, const SearchLimits& limits, const std::function<void(const SearchInfo&)>& onInfo,
+        const GameHistory* gameHistory = nullptr);
+
+    /**
+     * @brief Ask a running search to stop as soon as possible. Thread-safe.
+     */
+    void stop();
+
+    /**
+     * @brief Forget everything learned in earlier searches.
+     */
+    void clear();
+
+    /**
+     * @brief Change the size of the transposition table.
+     *
+     * @param megabytes New size of the table.
+     */
+    void setHashSize(size_t megabytes);
+
+    /**
+     * @brief Change the size of the transposition table to a number of kilobytes.
+     *
+     * @param kilobytes New size of the table.
+     */
+    void setHashKilobytes(size_t kilobytes) { table.resizeBytes(kilobytes * 1024); }
+
+    /**
+     * @brief Get the memory used by the search, its table included.
+     */
+    size_t memoryBytes() const { return sizeof(*this) + table.memoryBytes(); }
+
+    /**
+     * @brief Choose the evaluation and forget the scores of the previous one.
+     *
+     * @param network The network to evaluate with, or null for the classic Evaluation. It must outlive the search.
+     */
+    void setNetwork(const NnueNetwork* network);
+
+    /**
+     * @brief Check whether positions are scored by an NNUE network.
+     */
+    bool usesNetwork() const { return nnue != nullptr; }
+
+    /**
+     * @brief Choose whether searches are recorded in statistics.
+     *
+     * On by default. Engines embedded through the C API turn it off: the
+     * histograms of a game take most of the memory of a Search, and the
+     * process totals of Telemetry would be shared by every instance.
+     */
+    void setStatistics(bool enabled);
+
+    /**
+     * @brief Get the statistics of the searches since the last resetStatistics().
+     *
+     * Every search is also added to the process totals of Telemetry. Empty
+     * while statistics are turned off with setStatistics().
+     */
+    const SearchStatistics& getStatistics() const;
+
+    /**
+     * @brief Start collecting statistics for a new game.
+     */
+    void resetStatistics() {
+        if (statistics) {
+            statistics->reset();
+        }
+    }
+
+    /**
+     * @brief Save the transposition table, so that a later session can start from it.
+     *
+     * @param path The file.
+     * @throw std::runtime_error if the file cannot be written.
+     */
+    void saveTable(const std::string& path) const { table.save(path, fingerprint() ^ networkKey); }
+
+    /**
+     * @brief Load a transposition table saved by saveTable().
+     *
+     * @param path The file.
+     * @return The number of entries loaded.
+     * @throw std::runtime_error if the file cannot be read or was saved by a build or network whose scores differ.
+     */
+    size_t loadTable(const std::string& path) { return table.load(path, fingerprint() ^ networkKey); }
+
+    /**
+     * @brief Identify the rules, hashing and evaluation of this build.
+     *
+     * Computed from the hash keys, move counts and evaluations of every
+     * position up to three plies from the start, so a change to any of them
+     * makes saved tables incompatible without a manual version number.
+     */
+    static uint64_t fingerprint();
+
+private:
+    TranspositionTable table;                            ///< Transposition table.
+    std::atomic<bool> stopFlag;                          ///< Set to abort the search.
+    SearchLimits limits;                                 ///< Limits of the current search.
+    std::chrono::steady_clock::time_point start;         ///< Start time of the current search.
+    long long nodes;                                     ///< Nodes searched.
+    long long tableProbes;                               ///< Transposition table lookups of the current search.
+    long long tableHits;                                 ///< Lookups that found an entry.
+    long long quiescenceNodes;                           ///< Nodes searched below the nominal depth.
+    std::unique_ptr<SearchStatistics> statistics;        ///< Statistics of the searches of the current game, null when off.
+    int history[2][32][32];                              ///< History heuristic scores by colour, from and to square.
+    uint8_t pvTable[MaxPly][MaxPly];                     ///< Triangular table of principal variation move indices.
+    int pvLength[MaxPly];                                ///< Length of the principal variation per ply.
+    GameHistory positions;                               ///< Positions of the game and the current search path.
+    bool rootExcluded[MoveList::Capacity];               ///< Root moves skipped because a better line has them.
+    bool excluding;                                      ///< True if any root move is excluded.
+    std::unique_ptr<NnueEvaluator> nnue;                 ///< NNUE evaluation along the search path, null for the classic one.
+    uint64_t networkKey;                                 ///< Checksum of the network, 0 for the classic evaluation.
+
+    /**
+     * @brief Score a quiet position for the side to move with the chosen evaluation.
+     */
+    int evaluate(const Position& position) const {
+        return nnue ? nnue->evaluate(position) : Evaluation::evaluate(position);
+    }
+
+    /**
+     * @brief Principal variation search of one node.
+     */
+    int negamax(Position& position, int depth, int alpha, int beta, int ply);
+
+    /**
+     * @brief Order a move list, best candidates first.
+     */
+    void orderMoves(const Position& position, MoveList& list, int ttMove, uint8_t* indices) const;
+
+    /**
+     * @brief Check the time and node budgets and raise the stop flag when exhausted.
+     */
+    void checkLimits();
+
+    /**
+     * @brief Convert the principal variation move indices of the root into moves.
+     */
+    std::vector<BoardMove> principalVariation(const Position& root) const;
+
+    /**
+     * @brief Get the time spent since the search started.
+     */
+    double elapsedSeconds() const;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "SearchStatistics.h"
+#include "Search.h"
+#include <cmath>
+#include <string>
+
+/**
+ * @file SearchStatistics.cpp
+ * @brief Implementation of the search telemetry of a game or process.
+ */
+
+SearchStatistics::SearchStatistics() : searches(0), totalNodes(0), tableProbes(0), tableHits(0), quiescenceNodes(0) {}
+
+void SearchStatistics::record(const SearchResult& result) {
+    if (!result.hasMove) {
+        return;
+    }
+
+    double seconds = result.seconds > 0.0 ? result.seconds : 1e-6;
+    moveMicroseconds.record(static_cast<uint64_t>(result.seconds * 1e6));
+    nodes.record(static_cast<uint64_t>(result.nodes));
+    nodesPerSecond.record(static_cast<uint64_t>(result.nodes / seconds));
+    depth.record(static_cast<uint64_t>(result.depth));
+    if (result.depth > 0 && result.nodes > 1) {
+        branchingFactor.record(static_cast<uint64_t>(std::pow(static_cast<double>(result.nodes), 1.0 / result.depth) * 100.0));
+    }
+
+    searches.fetch_add(1, std::memory_order_relaxed);
+    totalNodes.fetch_add(result.nodes, std::memory_order_relaxed);
+    tableProbes.fetch_add(result.tableProbes, std::memory_order_relaxed);
+    tableHits.fetch_add(result.tableHits, std::memory_order_relaxed);
+    quiescenceNodes.fetch_add(result.quiescenceNodes, std::memory_order_relaxed);
+}
+
+void SearchStatistics::reset() {
+    moveMicroseconds.reset();
+    nodes.reset();
+    nodesPerSecond.reset();
+    depth.reset();
+    branchingFactor.reset();
+    searches.store(0);
+    totalNodes.store(0);
+    tableProbes.store(0);
+    tableHits.store(0);
+    quiescenceNodes.store(0);
+}
+
+void SearchStatistics::writeJson(std::ostream& stream, const std::string& indent) const {
+    long long probes = tableProbes.load();
+    long long allNodes = totalNodes.load();
+
+    stream << "{\n";
+    stream << indent << "\"searches\": " << searches.load() << ",\n";
+    stream << indent << "\"nodes\": " << allNodes << ",\n";
+    stream << indent << "\"tt_probes\": " << probes << ",\n";
+    stream << indent << "\"tt_hits\": " << tableHits.load() << ",\n";
+    stream << indent << "\"tt_hit_rate\": " << (probes > 0 ? static_cast<double>(tableHits.load()) / probes : 0.0) << ",\n";
+    stream << indent << "\"quiescence_nodes\": " << quiescenceNodes.load() << ",\n";
+    stream << indent << "\"quiescence_share\": " << (allNodes > 0 ? static_cast<double>(quiescenceNodes.load()) / allNodes : 0.0) << ",\n";
+    stream << indent << "\"move_time_us\": ";
+    moveMicroseconds.writeJson(stream);
+    stream << ",\n" << indent << "\"nodes_per_move\": ";
+    nodes.writeJson(stream);
+    stream << ",\n" << indent << "\"nps\": ";
+    nodesPerSecond.writeJson(stream);
+    stream << ",\n" << indent << "\"depth\": ";
+    depth.writeJson(stream);
+    stream << ",\n" << indent << "\"branching_factor\": ";
+    branchingFactor.writeJson(stream, 100.0);
+    stream << "\n" << indent.substr(0, indent.size() >= 2 ? indent.size() - 2 : 0) << "}";
+}
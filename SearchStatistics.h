@@ -0,0 +1,63 @@
+#ifndef SEARCHSTATISTICS_H
+#define SEARCHSTATISTICS_H
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include "Histogram.h"
+
+struct SearchResult;
+
+/**
+ * @brief The SearchStatistics class summarises the searches of a game or of the whole process.
+ *
+ * Every finished search adds one sample per histogram (move time, nodes,
+ * nodes per second, depth reached and effective branching factor) and its
+ * transposition table and quiescence counts to the totals. Recording is
+ * lock-free, so the statistics of all concurrent games can feed one
+ * process-wide instance.
+ */
+class SearchStatistics {
+public:
+    Histogram moveMicroseconds;         ///< Time per search.
+    Histogram nodes;                    ///< Nodes per search.
+    Histogram nodesPerSecond;           ///< Speed of each search.
+    Histogram depth;                    ///< Depth of the last finished iteration.
+    Histogram branchingFactor;          ///< Effective branching factor in hundredths, nodes^(1/depth).
+
+    std::atomic<long long> searches;            ///< Number of searches.
+    std::atomic<long long> totalNodes;          ///< Nodes of all searches.
+    std::atomic<long long> tableProbes;         ///< Transposition table lookups.
+    std::atomic<long long> tableHits;           ///< Lookups that found an entry.
+    std::atomic<long long> quiescenceNodes;     ///< Nodes searched below the nominal depth.
+
+    /**
+     * @brief Constructor for the SearchStatistics class, creates empty statistics.
+     */
+    SearchStatistics();
+
+    SearchStatistics(const SearchStatistics&) = delete;
+    SearchStatistics& operator=(const SearchStatistics&) = delete;
+
+    /**
+     * @brief Add a finished search. Thread-safe and lock-free.
+     *
+     * @param result The result of Search::think.
+     */
+    void record(const SearchResult& result);
+
+    /**
+     * @brief Forget all searches. Not safe while other threads record.
+     */
+    void reset();
+
+    /**
+     * @brief Write the statistics as a JSON object.
+     *
+     * @param stream The output stream.
+     * @param indent Indentation of the members.
+     */
+    void writeJson(std::ostream& stream, const std::string& indent) const;
+};
+
+#endif
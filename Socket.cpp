@@ -0,0 +1,212 @@
+#include "Socket.h"
+#include "MemoryAccounting.h"
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file Socket.cpp
+ * @brief Implementation of the portable non-blocking socket helpers.
+ */
+
+namespace {
+    int lastError() {
+#ifdef _WIN32
+        return WSAGetLastError();
+#else
+        return errno;
+#endif
+    }
+
+    bool wouldBlock(int error) {
+#ifdef _WIN32
+        return error == WSAEWOULDBLOCK;
+#else
+        return error == EAGAIN || error == EWOULDBLOCK || error == EINTR;
+#endif
+    }
+}
+
+void Socket::startup() {
+#ifdef _WIN32
+    static bool started = false;
+    if (!started) {
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+            throw std::runtime_error("Cannot start Winsock.");
+        }
+        started = true;
+    }
+#endif
+}
+
+void Socket::fail(const std::string& what) {
+    throw std::runtime_error(what + " failed (error " + std::to_string(lastError()) + ").");
+}
+
+void Socket::configure(Handle socket) {
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(socket, FIONBIO, &nonBlocking);
+#else
+    fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    // Messages are tiny and latency matters more than throughput
+    int noDelay = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+}
+
+Socket::Handle Socket::listen(int port) {
+    startup();
+
+    Handle listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener == Invalid) {
+        fail("socket");
+    }
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<unsigned short>(port));
+
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(listener);
+        fail("bind to port " + std::to_string(port));
+    }
+    if (::listen(listener, SOMAXCONN) != 0) {
+        close(listener);
+        fail("listen");
+    }
+
+    configure(listener);
+    return listener;
+}
+
+int Socket::localPort(Handle socket) {
+    sockaddr_in address;
+    socklen_t length = sizeof(address);
+    if (getsockname(socket, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        fail("getsockname");
+    }
+    return ntohs(address.sin_port);
+}
+
+Socket::Handle Socket::accept(Handle listener) {
+    Handle connection = ::accept(listener, nullptr, nullptr);
+    if (connection == Invalid) {
+        if (wouldBlock(lastError())) {
+            return Invalid;
+        }
+        fail("accept");
+    }
+
+    configure(connection);
+    return connection;
+}
+
+Socket::Handle Socket::connect(const std::string& host, int port) {
+    startup();
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || result == nullptr) {
+        throw std::runtime_error("Cannot resolve host " + host + ".");
+    }
+
+    Handle connection = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (connection == Invalid) {
+        freeaddrinfo(result);
+        fail("socket");
+    }
+
+    configure(connection);
+    int status = ::connect(connection, result->ai_addr, static_cast<int>(result->ai_addrlen));
+    freeaddrinfo(result);
+
+#ifdef _WIN32
+    bool inProgress = lastError() == WSAEWOULDBLOCK;
+#else
+    bool inProgress = lastError() == EINPROGRESS;
+#endif
+    if (status != 0 && !inProgress) {
+        close(connection);
+        fail("connect to " + host + ":" + std::to_string(port));
+    }
+
+    return connection;
+}
+
+bool Socket::receive(Handle socket, std::string& buffer) {
+    MemoryScope scope(MemoryTag::Io);
+    char chunk[4096];
+    while (true) {
+        int count = static_cast<int>(::recv(socket, chunk, sizeof(chunk), 0));
+        if (count > 0) {
+            buffer.append(chunk, count);
+            continue;
+        }
+        if (count == 0) {
+            return false; // Orderly shutdown by the peer
+        }
+        return wouldBlock(lastError());
+    }
+}
+
+bool Socket::send(Handle socket, std::string& buffer) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+
+    while (!buffer.empty()) {
+        int count = static_cast<int>(::send(socket, buffer.data(), static_cast<int>(buffer.size()), flags));
+        if (count < 0) {
+            return wouldBlock(lastError());
+        }
+        buffer.erase(0, count);
+    }
+    return true;
+}
+
+void Socket::poll(std::vector<PollEntry>& entries, int milliseconds) {
+    if (entries.empty()) {
+        return;
+    }
+#ifdef _WIN32
+    int status = WSAPoll(entries.data(), static_cast<ULONG>(entries.size()), milliseconds);
+#else
+    int status = ::poll(entries.data(), static_cast<nfds_t>(entries.size()), milliseconds);
+#endif
+    if (status < 0 && !wouldBlock(lastError())) {
+        fail("poll");
+    }
+}
+
+void Socket::close(Handle socket) {
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    ::close(socket);
+#endif
+}
@@ -0,0 +1,109 @@
+#ifndef SOCKET_H
+#define SOCKET_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <poll.h>
+#endif
+
+/**
+ * @brief The Socket class wraps the few non-blocking TCP calls the network modes need.
+ *
+ * Winsock and BSD sockets differ only in names and error codes, so everything
+ * platform specific is kept here and the rest of the code works with Socket::Handle.
+ * All functions throw std::runtime_error when the operating system reports an error.
+ */
+class Socket {
+public:
+#ifdef _WIN32
+    typedef SOCKET Handle;
+    typedef WSAPOLLFD PollEntry;
+    static const Handle Invalid = INVALID_SOCKET;
+#else
+    typedef int Handle;
+    typedef pollfd PollEntry;
+    static const Handle Invalid = -1;
+#endif
+
+    /**
+     * @brief Create a non-blocking socket listening on all interfaces.
+     *
+     * @param port The TCP port, 0 to let the system choose one.
+     * @return The listening socket.
+     */
+    static Handle listen(int port);
+
+    /**
+     * @brief Get the port a socket is bound to.
+     */
+    static int localPort(Handle socket);
+
+    /**
+     * @brief Accept a pending connection.
+     *
+     * @return The non-blocking connection, or Invalid if none is waiting.
+     */
+    static Handle accept(Handle listener);
+
+    /**
+     * @brief Start a non-blocking connection; it is usable once it becomes writable.
+     *
+     * @param host Host name or address.
+     * @param port TCP port.
+     * @return The connecting socket.
+     */
+    static Handle connect(const std::string& host, int port);
+
+    /**
+     * @brief Read whatever is available.
+     *
+     * @param buffer Bytes are appended here.
+     * @return False if the peer closed the connection or it failed.
+     */
+    static bool receive(Handle socket, std::string& buffer);
+
+    /**
+     * @brief Write as much of a buffer as the socket accepts.
+     *
+     * @param buffer Written bytes are removed from the front.
+     * @return False if the connection failed.
+     */
+    static bool send(Handle socket, std::string& buffer);
+
+    /**
+     * @brief Wait until one of the sockets is ready.
+     *
+     * @param entries Sockets and the events to wait for; revents is filled in.
+     * @param milliseconds Longest time to wait.
+     */
+    static void poll(std::vector<PollEntry>& entries, int milliseconds);
+
+    /**
+     * @brief Close a socket.
+     */
+    static void close(Handle socket);
+
+private:
+    /**
+     * @brief Start the socket library once per process (Winsock only).
+     */
+    static void startup();
+
+    /**
+     * @brief Switch a socket to non-blocking mode and disable Nagle's algorithm.
+     */
+    static void configure(Handle socket);
+
+    /**
+     * @brief Throw the last socket error.
+     */
+    static void fail(const std::string& what);
+};
+
+#endif
@@ -1,20 +1,22 @@
 #include "Square.h" 
 #include "Piece.h"
+#include "Board.h"
 
 /**
  * @brief Constructor for the Square class.
  * @param xCoord The X-coordinate of the square.
  * @param yCoord The Y-coordinate of the square.
  * @param p A pointer to the Piece object placed on the square.
+ * @param owner The board to notify when the piece changes, may be null.
  */
-Square::Square(int xCoord, int yCoord, Piece* p) : x(xCoord), y(yCoord), piece(p) {
+Square::Square(int xCoord, int yCoord, Piece* p, Board* owner) : x(xCoord), y(yCoord), piece(p), board(owner) {
     // Constructor implementation
 }
 
 /**
  * @brief Default constructor for the Square class.
  */
-Square::Square() {};
+Square::Square() : x(0), y(0), piece(nullptr), board(nullptr) {};
 
 /**
  * @brief Get the X-coordinate of the square.
@@ -46,4 +48,7 @@ Piece* Square::getPiece() const {
  */
 void Square::SetPiece(Piece* p) {
     piece = p;
+    if (board != nullptr) {
+        board->squareChanged(x, y, p);
+    }
 }
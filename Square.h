@@ -1,7 +1,10 @@
 #ifndef SQUARE_HPP
 #define SQUARE_HPP
 
+#include "MemoryAccounting.h"
+
 class Piece; // Forward declaration of the Piece class
+class Board;
 
 /**
  * @brief The Square class represents a square on a chessboard.
@@ -17,6 +20,7 @@ public:
     int x; ///< The x-coordinate of the square.
     int y; ///< The y-coordinate of the square.
     Piece* piece; ///< Pointer to the chess piece placed on the square.
+    Board* board; ///< Board notified when the piece changes, may be null.
 
     /**
      * @brief Constructor for the Square class.
@@ -24,8 +28,19 @@ public:
      * @param xCoord The x-coordinate of the square.
      * @param yCoord The y-coordinate of the square.
      * @param p Pointer to the chess piece placed on the square.
+     * @param owner Board that keeps its piece counts up to date through this square, may be null.
+     */
+    Square(int xCoord, int yCoord, Piece* p, Board* owner = nullptr);
+
+    /**
+     * @brief Allocate squares in the MemoryTag::Board account.
      */
-    Square(int xCoord, int yCoord, Piece* p);
+    static void* operator new(size_t size) { return MemoryAccounting::allocateOrThrow(size, MemoryTag::Board); }
+
+    /**
+     * @brief Free squares allocated by operator new.
+     */
+    static void operator delete(void* memory) noexcept { MemoryAccounting::release(memory); }
 
     /**
      * @brief Default constructor for the Square class.
@@ -56,6 +71,8 @@ public:
     /**
      * @brief Set the chess piece placed on the square.
      *
+     * The owning board, if any, is told about the change.
+     *
      * @param p Pointer to the chess piece to place on the square.
      */
     void SetPiece(Piece* p);
@@ -0,0 +1,61 @@
+#ifndef SQUARETABLES_H
+#define SQUARETABLES_H
+
+#include <cstdint>
+
+/**
+ * @brief The SquareTables struct maps the 32 playable squares to their geometry.
+ *
+ * Squares are numbered as in Position: square `4 * x + y / 2` is at row x,
+ * column y. Directions are 0 (row - 1, column - 1), 1 (row - 1, column + 1),
+ * 2 (row + 1, column - 1) and 3 (row + 1, column + 1). A square off the board
+ * is encoded as -1, so rule code only needs to test for a negative entry
+ * instead of checking coordinates.
+ *
+ * The tables are built by the constexpr constructor, so they are constants in
+ * the executable and cost nothing at startup.
+ */
+struct SquareTables {
+    int8_t row[32] = {};            ///< Row (0-7) of each square.
+    int8_t column[32] = {};         ///< Column (0-7) of each square.
+    int8_t index[8][8] = {};        ///< Square at a row and column, -1 for light squares.
+    int8_t neighbor[32][4] = {};    ///< Adjacent square per direction, also the square jumped over.
+    int8_t jump[32][4] = {};        ///< Landing square of a jump per direction.
+
+    constexpr SquareTables() {
+        const int directionX[4] = { -1, -1, 1, 1 };
+        const int directionY[4] = { -1, 1, -1, 1 };
+
+        for (int x = 0; x < 8; x++) {
+            for (int y = 0; y < 8; y++) {
+                index[x][y] = static_cast<int8_t>((x + y) % 2 == 1 ? 4 * x + y / 2 : -1);
+            }
+        }
+
+        for (int square = 0; square < 32; square++) {
+            int x = square / 4;
+            int y = 2 * (square % 4) + (x % 2 == 0 ? 1 : 0);
+            row[square] = static_cast<int8_t>(x);
+            column[square] = static_cast<int8_t>(y);
+
+            for (int direction = 0; direction < 4; direction++) {
+                int nx = x + directionX[direction];
+                int ny = y + directionY[direction];
+                int jx = nx + directionX[direction];
+                int jy = ny + directionY[direction];
+                neighbor[square][direction] = static_cast<int8_t>(nx >= 0 && nx < 8 && ny >= 0 && ny < 8 ? 4 * nx + ny / 2 : -1);
+                jump[square][direction] = static_cast<int8_t>(jx >= 0 && jx < 8 && jy >= 0 && jy < 8 ? 4 * jx + jy / 2 : -1);
+            }
+        }
+    }
+};
+
+/**
+ * @brief The square tables, evaluated at compile time.
+ */
+constexpr SquareTables squareTables;
+
+static_assert(squareTables.neighbor[0][0] == -1 && squareTables.neighbor[0][2] == 4 && squareTables.jump[0][3] == 9,
+    "Square tables do not match the Position numbering");
+
+#endif
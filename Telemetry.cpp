@@ -0,0 +1,121 @@
+#include "Telemetry.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @file Telemetry.cpp
+ * @brief Implementation of the process-wide search telemetry and its JSON export.
+ */
+
+Telemetry::Telemetry() : startTime(std::chrono::steady_clock::now()), interval(0), stopping(false) {}
+
+Telemetry& Telemetry::process() {
+    static Telemetry telemetry;
+    return telemetry;
+}
+
+void Telemetry::addGame(const std::string& label, const std::string& result, const SearchStatistics& statistics) {
+    if (statistics.searches.load() == 0) {
+        return;
+    }
+
+    std::ostringstream game;
+    game << "    {\n      \"label\": " << quote(label) << ",\n";
+    if (!result.empty()) {
+        game << "      \"result\": " << quote(result) << ",\n";
+    }
+    game << "      \"statistics\": ";
+    statistics.writeJson(game, "        ");
+    game << "\n    }";
+
+    std::lock_guard<std::mutex> lock(mutex);
+    games.push_back(game.str());
+}
+
+void Telemetry::start(const std::string& file, int intervalSeconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    path = file;
+    interval = intervalSeconds;
+    if (interval <= 0 || dumper.joinable()) {
+        return;
+    }
+
+    dumper = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!wakeUp.wait_for(lock, std::chrono::seconds(interval), [this]() { return stopping; })) {
+            lock.unlock();
+            dump();
+            lock.lock();
+        }
+    });
+}
+
+void Telemetry::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    if (dumper.joinable()) {
+        dumper.join();
+    }
+    dump();
+}
+
+void Telemetry::writeJson(std::ostream& stream) {
+    double uptime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    stream << "{\n  \"uptime_seconds\": " << uptime << ",\n  \"process\": ";
+    totals.writeJson(stream, "    ");
+    stream << ",\n  \"games\": [";
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < games.size(); i++) {
+        stream << (i == 0 ? "\n" : ",\n") << games[i];
+    }
+    stream << (games.empty() ? "]" : "\n  ]") << "\n}\n";
+}
+
+void Telemetry::dump() {
+    std::string file;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        file = path;
+    }
+    if (file.empty()) {
+        return;
+    }
+
+    std::string temporary = file + ".tmp";
+    {
+        std::ofstream stream(temporary);
+        if (!stream) {
+            return;
+        }
+        writeJson(stream);
+    }
+#ifdef _WIN32
+    std::remove(file.c_str()); // rename does not replace an existing file on Windows
+#endif
+    std::rename(temporary.c_str(), file.c_str());
+}
+
+std::string Telemetry::quote(const std::string& text) {
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+            result += escape;
+        }
+        else {
+            result += c;
+        }
+    }
+    return result + "\"";
+}
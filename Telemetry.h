@@ -0,0 +1,91 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SearchStatistics.h"
+
+/**
+ * @brief The Telemetry class collects the search statistics of the process and writes them as JSON.
+ *
+ * Every Search records its results both in its own statistics (one game) and
+ * in the process-wide totals kept here. Finished games are added with
+ * addGame(). When an output file is set, the JSON summary is written when the
+ * program ends with finish(), and optionally every few seconds from a
+ * background thread, so long-running servers can be watched from a dashboard.
+ * The file is replaced atomically, so a reader never sees half a dump.
+ */
+class Telemetry {
+public:
+    /**
+     * @brief Get the telemetry of the process.
+     */
+    static Telemetry& process();
+
+    /**
+     * @brief Get the statistics of all searches of the process.
+     */
+    SearchStatistics& total() { return totals; }
+
+    /**
+     * @brief Add the summary of a finished game.
+     *
+     * @param label Description of the game, e.g. "game 1, white (Computer)".
+     * @param result Outcome of the game, may be empty.
+     * @param statistics The searches of one engine during the game.
+     */
+    void addGame(const std::string& label, const std::string& result, const SearchStatistics& statistics);
+
+    /**
+     * @brief Set the file the JSON summary is written to and start the periodic dump.
+     *
+     * @param path The output file.
+     * @param intervalSeconds Seconds between dumps, 0 to write only at the end.
+     */
+    void start(const std::string& path, int intervalSeconds);
+
+    /**
+     * @brief Stop the periodic dump and write the final summary. Does nothing if no file was set.
+     */
+    void finish();
+
+    /**
+     * @brief Write the JSON summary of the process and its games.
+     *
+     * @param stream The output stream.
+     */
+    void writeJson(std::ostream& stream);
+
+private:
+    SearchStatistics totals;                                ///< All searches of the process.
+    std::chrono::steady_clock::time_point startTime;        ///< When the process started collecting.
+    std::mutex mutex;                                       ///< Guards games, path and the dump thread state.
+    std::vector<std::string> games;                         ///< JSON objects of the finished games.
+    std::string path;                                       ///< Output file, empty if disabled.
+    int interval;                                           ///< Seconds between dumps.
+    bool stopping;                                          ///< Set to end the dump thread.
+    std::condition_variable wakeUp;                         ///< Wakes the dump thread to stop.
+    std::thread dumper;                                     ///< The periodic dump thread.
+
+    /**
+     * @brief Constructor for the Telemetry class, only used by process().
+     */
+    Telemetry();
+
+    /**
+     * @brief Write the summary to the output file through a temporary file.
+     */
+    void dump();
+
+    /**
+     * @brief Quote a string for JSON.
+     */
+    static std::string quote(const std::string& text);
+};
+
+#endif
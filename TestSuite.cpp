@@ -0,0 +1,258 @@
+#include "TestSuite.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @file TestSuite.cpp
+ * @brief Implementation of the position test-suite runner.
+ */
+
+namespace {
+    /**
+     * @brief The Baseline struct is one position of a saved results file.
+     */
+    struct Baseline {
+        bool solved;
+        double seconds;
+        long long nodes;
+        int depth;
+    };
+
+    bool sameMove(const BoardMove& a, const BoardMove& b) {
+        return a.from == b.from && a.to == b.to && a.captured == b.captured;
+    }
+
+    /**
+     * @brief Get the text of a JSON value on a line written by TestSuite::save.
+     */
+    std::string field(const std::string& line, const std::string& name) {
+        size_t start = line.find("\"" + name + "\": ");
+        if (start == std::string::npos) {
+            return "";
+        }
+        start += name.size() + 4;
+        if (line[start] == '"') {
+            return line.substr(start + 1, line.find('"', start + 1) - start - 1);
+        }
+        return line.substr(start, line.find_first_of(",}", start) - start);
+    }
+}
+
+void TestSuite::load(const std::string& path) {
+    std::ifstream stream(path);
+    if (!stream) {
+        throw std::runtime_error("Cannot read the suite " + path);
+    }
+
+    entries.clear();
+    std::string line;
+    int number = 0;
+    while (std::getline(stream, line)) {
+        number++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        Entry entry;
+        entry.id = std::to_string(number);
+
+        std::string operations = line;
+        size_t semicolon = line.find(';');
+        if (semicolon != std::string::npos) {
+            operations = line.substr(0, semicolon);
+            size_t id = line.find("id \"", semicolon);
+            if (id != std::string::npos) {
+                entry.id = line.substr(id + 4, line.find('"', id + 4) - id - 4);
+            }
+        }
+
+        std::istringstream words(operations);
+        std::string position;
+        std::string word;
+        words >> position >> word;
+        if (word != "bm") {
+            throw std::runtime_error("Line " + std::to_string(number) + " of " + path + " has no \"bm\".");
+        }
+        entry.position = Position::fromString(position);
+
+        while (words >> word) {
+            BoardMove move;
+            if (!entry.position.findMove(word, move)) {
+                throw std::runtime_error("Line " + std::to_string(number) + " of " + path + ": " + word + " is not a legal move.");
+            }
+            entry.bestMoves.push_back(move);
+        }
+        if (entry.bestMoves.empty()) {
+            throw std::runtime_error("Line " + std::to_string(number) + " of " + path + " has no best move.");
+        }
+
+        entries.push_back(entry);
+    }
+}
+
+void TestSuite::run(const SearchLimits& limits) {
+    Search search(HashMegabytes);
+
+    for (Entry& entry : entries) {
+        search.clear();
+
+        // The solution is the start of the final run of iterations that chose an expected move
+        bool streak = false;
+        SearchResult result = search.think(entry.position, limits, [&entry, &streak](const SearchInfo& info) {
+            bool expected = false;
+            for (const BoardMove& move : entry.bestMoves) {
+                expected = expected || (!info.pv.empty() && sameMove(info.pv[0], move));
+            }
+            if (expected && !streak) {
+                entry.seconds = info.seconds;
+                entry.nodes = info.nodes;
+                entry.depth = info.depth;
+            }
+            streak = expected;
+        });
+
+        entry.solved = false;
+        for (const BoardMove& move : entry.bestMoves) {
+            entry.solved = entry.solved || (result.hasMove && sameMove(result.bestMove, move));
+        }
+        entry.played = result.hasMove ? Position::moveToString(result.bestMove) : "none";
+        if (!entry.solved) {
+            entry.seconds = result.seconds;
+            entry.nodes = result.nodes;
+            entry.depth = result.depth;
+        }
+    }
+}
+
+void TestSuite::print(std::ostream& stream) const {
+    int solved = 0;
+    double seconds = 0.0;
+    long long nodes = 0;
+
+    stream << std::left << std::setw(16) << "id" << std::setw(8) << "result" << std::setw(14) << "move"
+        << std::right << std::setw(12) << "time ms" << std::setw(12) << "nodes" << std::setw(7) << "depth" << std::endl;
+    for (const Entry& entry : entries) {
+        stream << std::left << std::setw(16) << entry.id << std::setw(8) << (entry.solved ? "solved" : "FAILED")
+            << std::setw(14) << entry.played << std::right << std::setw(12) << std::fixed << std::setprecision(1)
+            << entry.seconds * 1000.0 << std::setw(12) << entry.nodes << std::setw(7) << entry.depth << std::endl;
+        if (entry.solved) {
+            solved++;
+            seconds += entry.seconds;
+            nodes += entry.nodes;
+        }
+    }
+    stream << std::defaultfloat << std::setprecision(6);
+
+    stream << "Solved " << solved << " of " << entries.size();
+    if (solved > 0) {
+        stream << ", mean time to solution " << seconds * 1000.0 / solved << " ms, mean nodes to solution " << nodes / solved;
+    }
+    stream << std::endl;
+}
+
+void TestSuite::save(const std::string& path) const {
+    std::ofstream stream(path);
+    if (!stream) {
+        throw std::runtime_error("Cannot write the results to " + path);
+    }
+
+    stream << "{\n  \"positions\": [\n";
+    for (size_t i = 0; i < entries.size(); i++) {
+        const Entry& entry = entries[i];
+        stream << "    {\"id\": \"" << entry.id << "\", \"solved\": " << (entry.solved ? "true" : "false")
+            << ", \"move\": \"" << entry.played << "\", \"seconds\": " << entry.seconds << ", \"nodes\": " << entry.nodes
+            << ", \"depth\": " << entry.depth << "}" << (i + 1 < entries.size() ? ",\n" : "\n");
+    }
+    stream << "  ]\n}\n";
+}
+
+bool TestSuite::compare(const std::string& path, std::ostream& stream) const {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot read the baseline " + path);
+    }
+
+    std::map<std::string, Baseline> baseline;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string id = field(line, "id");
+        if (id.empty()) {
+            continue;
+        }
+        Baseline entry = { field(line, "solved") == "true", std::stod(field(line, "seconds")),
+            std::stoll(field(line, "nodes")), std::stoi(field(line, "depth")) };
+        baseline[id] = entry;
+    }
+
+    int gained = 0;
+    int lost = 0;
+    double oldNodes = 0.0;
+    double newNodes = 0.0;
+    for (const Entry& entry : entries) {
+        auto previous = baseline.find(entry.id);
+        if (previous == baseline.end()) {
+            stream << entry.id << ": not in the baseline" << std::endl;
+            continue;
+        }
+        if (entry.solved && !previous->second.solved) {
+            stream << entry.id << ": newly solved" << std::endl;
+            gained++;
+        }
+        else if (!entry.solved && previous->second.solved) {
+            stream << entry.id << ": no longer solved (plays " << entry.played << ")" << std::endl;
+            lost++;
+        }
+        else if (entry.solved) {
+            oldNodes += previous->second.nodes;
+            newNodes += entry.nodes;
+            if (entry.depth != previous->second.depth) {
+                stream << entry.id << ": solved at depth " << entry.depth << " instead of " << previous->second.depth << std::endl;
+            }
+        }
+    }
+
+    stream << "Against " << path << ": " << gained << " gained, " << lost << " lost";
+    if (oldNodes > 0.0) {
+        stream << ", nodes to solution of positions solved by both " << std::showpos << std::fixed << std::setprecision(1)
+            << (newNodes / oldNodes - 1.0) * 100.0 << "%" << std::noshowpos << std::defaultfloat << std::setprecision(6);
+    }
+    stream << std::endl;
+    stream << (lost == 0 ? "ACCEPT" : "REJECT") << std::endl;
+    return lost == 0;
+}
+
+int TestSuite::runFile(const std::string& path, const std::string& budget, const std::string& outputPath, const std::string& baselinePath) {
+    try {
+        SearchLimits limits;
+        if (budget.size() > 2 && budget.compare(budget.size() - 2, 2, "ms") == 0) {
+            limits.milliseconds = std::stoi(budget.substr(0, budget.size() - 2));
+        }
+        else {
+            limits.nodes = std::stoll(budget);
+        }
+
+        TestSuite suite;
+        suite.load(path);
+        suite.run(limits);
+        suite.print(std::cout);
+
+        if (!outputPath.empty()) {
+            suite.save(outputPath);
+            std::cout << "Results saved to " << outputPath << std::endl;
+        }
+        if (!baselinePath.empty() && !suite.compare(baselinePath, std::cout)) {
+            return 1;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
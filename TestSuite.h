@@ -0,0 +1,99 @@
+#ifndef TESTSUITE_H
+#define TESTSUITE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Position.h"
+#include "Search.h"
+
+/**
+ * @brief The TestSuite class runs the engine over positions with known best moves.
+ *
+ * A suite file has one position per line:
+ *
+ *     W:W18,K27:B9,10 bm c3xe5 e3-d4; id "Endgame 12"
+ *
+ * the position as read by Position::fromString, then after "bm" every move
+ * that solves it (in any notation accepted by Position::findMove) and an
+ * optional identifier. Empty lines and lines starting with '#' are skipped.
+ *
+ * Each position is searched with a fresh transposition table under the same
+ * budget. A position counts as solved when the search ends on an expected
+ * move; the time, nodes and depth to solution are those of the first
+ * iteration from which every later iteration kept an expected move. Results
+ * can be saved as JSON and compared with a baseline to accept or reject a
+ * change of the search.
+ */
+class TestSuite {
+public:
+    static const size_t HashMegabytes = 16;     ///< Transposition table used for each position.
+
+    /**
+     * @brief The Entry struct is one position of the suite and its result.
+     */
+    struct Entry {
+        std::string id;                     ///< Identifier, the line number if none is given.
+        Position position;                  ///< The position to solve.
+        std::vector<BoardMove> bestMoves;   ///< Moves that solve it.
+        bool solved = false;                ///< True if the search ended on a best move.
+        std::string played;                 ///< The move the search chose.
+        double seconds = 0.0;               ///< Time to solution, or the whole search if unsolved.
+        long long nodes = 0;                ///< Nodes to solution, or the whole search if unsolved.
+        int depth = 0;                      ///< Depth of the solving iteration, or the last iteration if unsolved.
+    };
+
+    /**
+     * @brief Load a suite file.
+     *
+     * @param path The suite file.
+     * @throw std::runtime_error if the file cannot be read or a line is invalid.
+     */
+    void load(const std::string& path);
+
+    /**
+     * @brief Search every position.
+     *
+     * @param limits The budget of each search, nodes or milliseconds.
+     */
+    void run(const SearchLimits& limits);
+
+    /**
+     * @brief Print one line per position and the totals.
+     */
+    void print(std::ostream& stream) const;
+
+    /**
+     * @brief Save the results as JSON, one position per line.
+     *
+     * @param path The output file.
+     * @throw std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Compare the results with a file written by save() and print the differences.
+     *
+     * @param path The baseline file.
+     * @param stream Receives the report.
+     * @return True if no position solved in the baseline is unsolved now.
+     * @throw std::runtime_error if the baseline cannot be read.
+     */
+    bool compare(const std::string& path, std::ostream& stream) const;
+
+    /**
+     * @brief Run a suite from the command line.
+     *
+     * @param path The suite file.
+     * @param budget Nodes per position, or milliseconds when it ends in "ms".
+     * @param outputPath File to save the results to, may be empty.
+     * @param baselinePath Results to compare with, may be empty.
+     * @return 0 if the suite ran without losing a baseline solution, otherwise 1.
+     */
+    static int runFile(const std::string& path, const std::string& budget, const std::string& outputPath, const std::string& baselinePath);
+
+private:
+    std::vector<Entry> entries;     ///< The positions in file order.
+};
+
+#endif
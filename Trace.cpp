@@ -0,0 +1,137 @@
+#include "Trace.h"
+#include "MemoryAccounting.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @file Trace.cpp
+ * @brief Implementation of the per-thread trace buffers and the Chrome trace export.
+ */
+
+std::atomic<bool> Trace::enabled(false);
+
+namespace {
+    /**
+     * @brief The Buffer struct is the ring of events of one thread.
+     */
+    struct Buffer {
+        std::vector<Trace::Event> events;   ///< The ring, allocated when the buffer is created.
+        uint64_t written = 0;               ///< Events recorded so far, including overwritten ones.
+    };
+
+    std::chrono::steady_clock::time_point origin;       ///< Time zero of the trace.
+    size_t capacity = Trace::DefaultEvents;             ///< Size of new buffers.
+    std::mutex registryMutex;                           ///< Guards the two lists below.
+    std::vector<std::unique_ptr<Buffer>> buffers;       ///< Every buffer ever created.
+    std::vector<Buffer*> freeBuffers;                   ///< Buffers of threads that have ended.
+    std::atomic<uint32_t> threadCount(0);               ///< Numbers the recording threads.
+
+    /**
+     * @brief The ThreadBuffer struct lends a buffer to a thread for its lifetime.
+     */
+    struct ThreadBuffer {
+        Buffer* buffer = nullptr;
+        uint32_t thread = threadCount++;
+
+        Buffer* get() {
+            if (buffer == nullptr) {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                if (!freeBuffers.empty()) {
+                    buffer = freeBuffers.back();
+                    freeBuffers.pop_back();
+                }
+                else {
+                    MemoryScope scope(MemoryTag::Io);
+                    buffers.emplace_back(new Buffer);
+                    buffer = buffers.back().get();
+                    buffer->events.resize(capacity);
+                }
+            }
+            return buffer;
+        }
+
+        ~ThreadBuffer() {
+            if (buffer != nullptr) {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                freeBuffers.push_back(buffer);
+            }
+        }
+    };
+
+    thread_local ThreadBuffer threadBuffer;
+}
+
+void Trace::enable(size_t eventsPerThread) {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        origin = std::chrono::steady_clock::now();
+        capacity = std::max<size_t>(eventsPerThread, 1);
+    }
+    threadBuffer.get(); // the enabling thread is numbered 0 and named "main"
+    enabled.store(true);
+}
+
+int64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void Trace::record(const char* name, int64_t start, int64_t end) {
+    Buffer* buffer = threadBuffer.get();
+    Event& event = buffer->events[buffer->written % buffer->events.size()];
+    event.name = name;
+    event.start = start;
+    event.duration = end - start;
+    event.thread = threadBuffer.thread;
+    buffer->written++;
+}
+
+void Trace::writeJson(std::ostream& stream) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::vector<Event> events;
+    for (const std::unique_ptr<Buffer>& buffer : buffers) {
+        size_t size = buffer->events.size();
+        uint64_t first = buffer->written > size ? buffer->written - size : 0;
+        for (uint64_t i = first; i < buffer->written; i++) {
+            events.push_back(buffer->events[i % size]);
+        }
+    }
+    std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.start < b.start; });
+
+    // Microseconds with three decimals keep the nanosecond resolution
+    char number[32];
+    stream << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    std::map<uint32_t, bool> threads;
+    for (const Event& event : events) {
+        threads[event.thread] = true;
+    }
+    for (const auto& thread : threads) {
+        stream << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread.first
+            << ", \"args\": {\"name\": \"" << (thread.first == 0 ? "main" : "thread " + std::to_string(thread.first)) << "\"}},\n";
+    }
+    for (const Event& event : events) {
+        stream << "  {\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread;
+        std::snprintf(number, sizeof(number), "%.3f", event.start / 1000.0);
+        stream << ", \"ts\": " << number;
+        std::snprintf(number, sizeof(number), "%.3f", event.duration / 1000.0);
+        stream << ", \"dur\": " << number << "},\n";
+    }
+    stream << "  {\"name\": \"trace_end\", \"ph\": \"i\", \"s\": \"g\", \"pid\": 1, \"tid\": 0, \"ts\": ";
+    std::snprintf(number, sizeof(number), "%.3f", now() / 1000.0);
+    stream << number << "}\n]}\n";
+}
+
+bool Trace::save(const std::string& path) {
+    std::ofstream stream(path);
+    if (!stream) {
+        return false;
+    }
+    writeJson(stream);
+    return static_cast<bool>(stream);
+}
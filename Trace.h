@@ -0,0 +1,116 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief The Trace class records timed scopes of the program for a trace viewer.
+ *
+ * Code is instrumented with TRACE_SCOPE("name"), which records the time spent
+ * until the end of the enclosing block. Every thread writes into its own ring
+ * buffer without locking; when a buffer is full the oldest events are
+ * overwritten, so a long game keeps its most recent moves. Buffers of finished
+ * threads are reused by new ones, so the engine threads started for every DXP
+ * move do not grow the memory. save() writes all events in the Chrome trace
+ * event format, which chrome://tracing and Perfetto open directly.
+ *
+ * TRACE_SCOPE expands to nothing unless CHECKERS_TRACE is defined (the Debug
+ * configurations define it), so release builds carry no cost. When compiled
+ * in, nothing is recorded until enable() is called.
+ */
+class Trace {
+public:
+    static const size_t DefaultEvents = 1 << 20;  ///< Events per thread buffer (32 bytes each).
+    static const size_t MaxEvents = 1 << 24;      ///< Largest buffer accepted on the command line, 512 MB per thread.
+
+    /**
+     * @brief One finished scope.
+     */
+    struct Event {
+        const char* name;       ///< Scope name, a string literal.
+        int64_t start;          ///< Start in nanoseconds since the trace was enabled.
+        int64_t duration;       ///< Duration in nanoseconds.
+        uint32_t thread;        ///< Number of the recording thread.
+    };
+
+    /**
+     * @brief Start recording.
+     *
+     * @param eventsPerThread Capacity of each thread's ring buffer.
+     */
+    static void enable(size_t eventsPerThread = DefaultEvents);
+
+    /**
+     * @brief Check whether events are being recorded.
+     */
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the current time in nanoseconds since the trace was enabled.
+     */
+    static int64_t now();
+
+    /**
+     * @brief Record a finished scope in the calling thread's buffer.
+     *
+     * @param name The scope name, a string literal.
+     * @param start When the scope started, from now().
+     * @param end When the scope ended, from now().
+     */
+    static void record(const char* name, int64_t start, int64_t end);
+
+    /**
+     * @brief Write every recorded event as Chrome trace JSON.
+     *
+     * Must not run while other threads record.
+     *
+     * @param stream The output stream.
+     */
+    static void writeJson(std::ostream& stream);
+
+    /**
+     * @brief Write the trace to a file.
+     *
+     * @param path The output file.
+     * @return True if the file was written.
+     */
+    static bool save(const std::string& path);
+
+private:
+    static std::atomic<bool> enabled;   ///< True while recording.
+};
+
+/**
+ * @brief The TraceScope class records the lifetime of a block; use it through TRACE_SCOPE.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name(name), start(Trace::isEnabled() ? Trace::now() : -1) {}
+
+    ~TraceScope() {
+        if (start >= 0) {
+            Trace::record(name, start, Trace::now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;   ///< Scope name.
+    int64_t start;      ///< Start time, -1 if tracing was off.
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef CHECKERS_TRACE
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif
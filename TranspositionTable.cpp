@@ -0,0 +1,139 @@
+#include "TranspositionTable.h"
+#include "MappedFile.h"
+#include "MemoryAccounting.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+/**
+ * @file TranspositionTable.cpp
+ * @brief Implementation of the search transposition table.
+ */
+
+namespace {
+    const char FileMagic[4] = { 'C', 'K', 'T', 'T' };
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes) : mask(0), generation(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    resizeBytes(megabytes * 1024 * 1024);
+}
+
+void TranspositionTable::resizeBytes(size_t bytes) {
+    size_t count = 1;
+    while (count * 2 * sizeof(TTEntry) <= bytes) {
+        count *= 2;
+    }
+
+    MemoryScope scope(MemoryTag::Search);
+    entries.assign(count, TTEntry());
+    mask = count - 1;
+}
+
+void TranspositionTable::clear() {
+    entries.assign(entries.size(), TTEntry());
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation++;
+}
+
+const TTEntry* TranspositionTable::probe(uint64_t key) const {
+    const TTEntry& entry = entries[key & mask];
+    return entry.key == key ? &entry : nullptr;
+}
+
+void TranspositionTable::store(uint64_t key, int score, int depth, uint8_t bound, uint8_t moveIndex) {
+    TTEntry& entry = entries[key & mask];
+
+    // Keep a deeper result of the current search for the same or another position
+    if (entry.key != 0 && entry.generation == generation && depth < entry.depth && bound != Exact) {
+        return;
+    }
+
+    // Do not lose the best move when a shallower bound without one arrives
+    if (entry.key == key && moveIndex == NoMove) {
+        moveIndex = entry.moveIndex;
+    }
+
+    entry.key = key;
+    entry.score = static_cast<int16_t>(score);
+    entry.depth = static_cast<int8_t>(depth);
+    entry.bound = bound;
+    entry.moveIndex = moveIndex;
+    entry.generation = generation;
+}
+
+void TranspositionTable::save(const std::string& path, uint64_t fingerprint) const {
+    FileHeader header;
+    std::memcpy(header.magic, FileMagic, sizeof(FileMagic));
+    header.version = FileVersion;
+    header.fingerprint = fingerprint;
+    header.count = entries.size();
+    header.entrySize = sizeof(TTEntry);
+    header.generation = generation;
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream stream(temporary, std::ios::binary);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(TTEntry));
+        if (!stream) {
+            throw std::runtime_error("Cannot write the hash table to " + temporary);
+        }
+    }
+#ifdef _WIN32
+    std::remove(path.c_str()); // rename does not replace an existing file on Windows
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Cannot replace " + path);
+    }
+}
+
+size_t TranspositionTable::load(const std::string& path, uint64_t fingerprint) {
+    MappedFile file(path);
+
+    FileHeader header;
+    if (file.size() < sizeof(header)) {
+        throw std::runtime_error(path + " is not a saved hash table.");
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0) {
+        throw std::runtime_error(path + " is not a saved hash table.");
+    }
+    if (header.version != FileVersion || header.entrySize != sizeof(TTEntry)) {
+        throw std::runtime_error(path + " was saved in another format (version " + std::to_string(header.version) + ").");
+    }
+    if (header.fingerprint != fingerprint) {
+        throw std::runtime_error(path + " was saved by a build with other rules or evaluation.");
+    }
+    if (file.size() != sizeof(header) + header.count * sizeof(TTEntry)) {
+        throw std::runtime_error(path + " is truncated.");
+    }
+
+    const TTEntry* saved = reinterpret_cast<const TTEntry*>(file.data() + sizeof(header));
+    generation = static_cast<uint8_t>(header.generation);
+    if (header.count == entries.size()) {
+        std::memcpy(entries.data(), saved, entries.size() * sizeof(TTEntry));
+    }
+    else {
+        entries.assign(entries.size(), TTEntry());
+        for (uint64_t i = 0; i < header.count; i++) {
+            TTEntry& entry = entries[saved[i].key & mask];
+            if (saved[i].key != 0 && (entry.key == 0 || saved[i].depth > entry.depth)) {
+                entry = saved[i];
+            }
+        }
+    }
+
+    size_t loaded = 0;
+    for (const TTEntry& entry : entries) {
+        loaded += entry.key != 0 ? 1 : 0;
+    }
+    return loaded;
+}
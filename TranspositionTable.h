@@ -0,0 +1,144 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The TTEntry struct is one slot of the transposition table.
+ *
+ * The best move is stored as its index in the list produced by
+ * Position::generateMoves, which is deterministic for a given position.
+ */
+struct TTEntry {
+    uint64_t key;         ///< Position hash, 0 for an empty slot.
+    int16_t score;        ///< Search score, mate scores relative to this node.
+    int8_t depth;         ///< Remaining depth of the search that produced the entry.
+    uint8_t bound;        ///< One of TranspositionTable::Exact, Lower or Upper.
+    uint8_t moveIndex;    ///< Index of the best move, NoMove if unknown.
+    uint8_t generation;   ///< Search that wrote the entry, used for replacement.
+};
+
+/**
+ * @brief The TranspositionTable class caches search results by position hash.
+ */
+class TranspositionTable {
+public:
+    static const uint8_t Exact = 0;     ///< The score is exact.
+    static const uint8_t Lower = 1;     ///< The score is a lower bound (fail high).
+    static const uint8_t Upper = 2;     ///< The score is an upper bound (fail low).
+    static const uint8_t NoMove = 255;  ///< No best move stored.
+    static const uint32_t FileVersion = 1;  ///< Format version of saved tables.
+
+    /**
+     * @brief Constructor for the TranspositionTable class.
+     *
+     * @param megabytes Size of the table, rounded down to a power of two entries.
+     */
+    explicit TranspositionTable(size_t megabytes);
+
+    /**
+     * @brief Change the size of the table, clearing it.
+     *
+     * @param megabytes New size of the table.
+     */
+    void resize(size_t megabytes);
+
+    /**
+     * @brief Change the size of the table to a number of bytes, clearing it.
+     *
+     * Used for small tables, such as those of many engines sharing a process.
+     *
+     * @param bytes New size of the table, rounded down to a power of two entries, at least one.
+     */
+    void resizeBytes(size_t bytes);
+
+    /**
+     * @brief Remove every entry.
+     */
+    void clear();
+
+    /**
+     * @brief Start a new search, making the entries of earlier searches replaceable.
+     */
+    void newSearch();
+
+    /**
+     * @brief Look up a position.
+     *
+     * @param key The position hash.
+     * @return Pointer to the entry, or nullptr if the position is not stored.
+     */
+    const TTEntry* probe(uint64_t key) const;
+
+    /**
+     * @brief Store a search result.
+     *
+     * @param key The position hash.
+     * @param score The score, mate scores relative to the node.
+     * @param depth The remaining depth.
+     * @param bound The bound type.
+     * @param moveIndex The index of the best move.
+     */
+    void store(uint64_t key, int score, int depth, uint8_t bound, uint8_t moveIndex);
+
+    /**
+     * @brief Get the number of entries.
+     *
+     * @return The table size in entries.
+     */
+    size_t size() const { return entries.size(); }
+
+    /**
+     * @brief Get the memory used by the entries.
+     */
+    size_t memoryBytes() const { return entries.size() * sizeof(TTEntry); }
+
+    /**
+     * @brief Save the entries to a file.
+     *
+     * The file starts with a versioned header holding the fingerprint, then
+     * the entries exactly as they are in memory. It is written under a
+     * temporary name and renamed, so an interrupted save keeps the old file.
+     *
+     * @param path The file.
+     * @param fingerprint Identifies the rules and evaluation the scores were computed with.
+     * @throw std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string& path, uint64_t fingerprint) const;
+
+    /**
+     * @brief Replace the entries with those of a saved file.
+     *
+     * The file is memory-mapped and checked before anything is changed. A file
+     * of the same size is copied as it is; otherwise every entry is stored
+     * again, keeping the deeper one when two land on the same slot.
+     *
+     * @param path The file.
+     * @param fingerprint Must equal the fingerprint the file was saved with.
+     * @return The number of entries loaded.
+     * @throw std::runtime_error if the file cannot be read, is of another version, or has another fingerprint.
+     */
+    size_t load(const std::string& path, uint64_t fingerprint);
+
+private:
+    /**
+     * @brief The FileHeader struct starts a saved table.
+     */
+    struct FileHeader {
+        char magic[4];          ///< "CKTT".
+        uint32_t version;       ///< FileVersion.
+        uint64_t fingerprint;   ///< Rules and evaluation of the scores.
+        uint64_t count;         ///< Number of entries.
+        uint32_t entrySize;     ///< sizeof(TTEntry).
+        uint32_t generation;    ///< Generation of the last search.
+    };
+
+    std::vector<TTEntry> entries;  ///< Table storage, a power of two in size.
+    uint64_t mask;                 ///< entries.size() - 1.
+    uint8_t generation;            ///< Current search generation.
+};
+
+#endif
@@ -0,0 +1,531 @@
+#ifndef VARIANTPOSITION_H
+#define VARIANTPOSITION_H
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "Position.h"
+#include "Rules.h"
+
+/**
+ * @brief The VariantGeometry struct maps the playable squares of a Size x Size board to their rays.
+ *
+ * Squares are numbered row by row as in Position: square `Size / 2 * x + y / 2`
+ * is at row x, column y, so on 10x10 they match the usual 1-50 numbering minus
+ * one. Directions are those of SquareTables. `ray[square][direction][k]` is the
+ * square k + 1 steps away, -1 past the edge; the last entry of every ray is
+ * always -1, so a walk along a diagonal needs no coordinate checks.
+ *
+ * @tparam Size The board side.
+ */
+template <int Size>
+struct VariantGeometry {
+    static constexpr int Squares = Size * Size / 2;    ///< Number of playable squares.
+    static constexpr int RowSquares = Size / 2;        ///< Playable squares per row.
+
+    /// Smallest mask type holding one bit per playable square.
+    using Mask = std::conditional_t<(Squares > 32), uint64_t, uint32_t>;
+
+    int8_t row[Squares] = {};               ///< Row of each square.
+    int8_t column[Squares] = {};            ///< Column of each square.
+    int8_t ray[Squares][4][Size] = {};      ///< Squares along each diagonal, -1 terminated.
+    Mask promotion[2] = {};                 ///< Promotion row of black (index 0) and white (index 1) men.
+
+    constexpr VariantGeometry() {
+        const int directionX[4] = { -1, -1, 1, 1 };
+        const int directionY[4] = { -1, 1, -1, 1 };
+
+        for (int square = 0; square < Squares; square++) {
+            int x = square / RowSquares;
+            int y = 2 * (square % RowSquares) + (x % 2 == 0 ? 1 : 0);
+            row[square] = static_cast<int8_t>(x);
+            column[square] = static_cast<int8_t>(y);
+
+            for (int direction = 0; direction < 4; direction++) {
+                int nx = x;
+                int ny = y;
+                for (int k = 0; k < Size; k++) {
+                    nx += directionX[direction];
+                    ny += directionY[direction];
+                    bool inside = k < Size - 1 && nx >= 0 && nx < Size && ny >= 0 && ny < Size;
+                    ray[square][direction][k] = static_cast<int8_t>(inside ? RowSquares * nx + ny / 2 : -1);
+                }
+            }
+
+            if (x == Size - 1) {
+                promotion[0] |= Mask(1) << square;
+            }
+            if (x == 0) {
+                promotion[1] |= Mask(1) << square;
+            }
+        }
+    }
+};
+
+/**
+ * @brief The VariantPosition class is a compact position and move generator for one rule policy.
+ *
+ * This is the rule-parameterised counterpart of Position: the board size, king
+ * range, capture directions of men, capture obligation and crowning rules all
+ * come from the policy (see Rules.h) and are resolved at compile time, so each
+ * instantiation is a specialised generator without rule checks in its loops.
+ * VariantPosition<HouseRules> generates exactly the moves of Position.
+ *
+ * White moves first in every variant, with its men moving towards row 0.
+ *
+ * @tparam Rules The rule policy.
+ */
+template <typename Rules>
+class VariantPosition {
+public:
+    using Geometry = VariantGeometry<Rules::Size>;
+    using Mask = typename Geometry::Mask;
+
+    static constexpr int Squares = Geometry::Squares;                          ///< Number of playable squares.
+    static constexpr int MaxHops = (Rules::Size / 2 - 1) * (Rules::Size / 2);  ///< Most pieces one move can capture.
+
+    /**
+     * @brief The Move struct is one complete move, laid out like BoardMove.
+     */
+    struct Move {
+        uint8_t from;             ///< Square the moving piece starts on.
+        uint8_t to;               ///< Square the moving piece ends on.
+        uint8_t hops;             ///< Number of captures (0 for a quiet move).
+        bool promotes;            ///< True if a man is crowned by this move.
+        Mask captured;            ///< Squares of the captured pieces.
+        Mask capturedKings;       ///< Subset of captured that held kings.
+        uint8_t path[MaxHops];    ///< Landing square of every capture, path[hops - 1] == to.
+
+        bool isCapture() const { return hops > 0; }
+    };
+
+    /**
+     * @brief The MoveList struct is a fixed-capacity list of generated moves, as MoveList.
+     */
+    struct MoveList {
+        static const int Capacity = 256; ///< Upper bound on the number of legal moves.
+
+        Move moves[Capacity];   ///< Generated moves.
+        int count = 0;          ///< Number of valid entries in moves.
+
+        void add(const Move& move) {
+            if (count < Capacity) {
+                moves[count++] = move;
+            }
+        }
+
+        const Move& operator[](int index) const { return moves[index]; }
+        Move& operator[](int index) { return moves[index]; }
+    };
+
+    static constexpr Mask AllSquares = static_cast<Mask>((uint64_t(1) << Squares) - 1); ///< Every playable square.
+    static constexpr Geometry geometry{}; ///< Square tables, evaluated at compile time.
+
+    Mask white = 0;             ///< Squares holding white pieces.
+    Mask black = 0;             ///< Squares holding black pieces.
+    Mask kings = 0;             ///< Squares holding kings of either colour.
+    bool whiteToMove = true;    ///< True if white is the side to move.
+
+    /**
+     * @brief Create the starting position: Size / 2 - 1 rows of men per side.
+     */
+    static VariantPosition initial() {
+        const int rows = Rules::Size / 2 - 1;
+        VariantPosition position;
+        for (int square = 0; square < Squares; square++) {
+            if (geometry.row[square] < rows) {
+                position.black |= Mask(1) << square;
+            }
+            else if (geometry.row[square] >= Rules::Size - rows) {
+                position.white |= Mask(1) << square;
+            }
+        }
+        return position;
+    }
+
+    /**
+     * @brief Parse a position in the text format of Position::fromString, with squares 1 to Squares.
+     *
+     * @param text The position text.
+     * @return The parsed position.
+     * @throw std::runtime_error if the text is not a valid position.
+     */
+    static VariantPosition fromString(const std::string& text) {
+        VariantPosition position;
+
+        if (text.size() < 1 || (text[0] != 'W' && text[0] != 'B')) {
+            throw std::runtime_error("Invalid position: missing side to move.");
+        }
+        position.whiteToMove = text[0] == 'W';
+
+        std::stringstream stream(text.substr(1));
+        std::string section;
+        while (std::getline(stream, section, ':')) {
+            if (section.empty()) {
+                continue;
+            }
+            if (section[0] != 'W' && section[0] != 'B') {
+                throw std::runtime_error("Invalid position: unknown colour in \"" + section + "\".");
+            }
+
+            Mask& pieces = section[0] == 'W' ? position.white : position.black;
+            std::stringstream squares(section.substr(1));
+            std::string item;
+            while (std::getline(squares, item, ',')) {
+                bool isKing = !item.empty() && item[0] == 'K';
+                std::string number = isKing ? item.substr(1) : item;
+                if (number.empty() || number.size() > 3 || number.find_first_not_of("0123456789") != std::string::npos) {
+                    throw std::runtime_error("Invalid position: bad square \"" + item + "\".");
+                }
+
+                int square = std::stoi(number) - 1;
+                if (square < 0 || square >= Squares) {
+                    throw std::runtime_error("Invalid position: square out of range \"" + item + "\".");
+                }
+
+                Mask bit = Mask(1) << square;
+                if (((position.white | position.black) & bit) != 0) {
+                    throw std::runtime_error("Invalid position: square used twice \"" + item + "\".");
+                }
+                pieces |= bit;
+                if (isKing) {
+                    position.kings |= bit;
+                }
+            }
+        }
+
+        return position;
+    }
+
+    /**
+     * @brief Format the position in the text format read by fromString().
+     */
+    std::string toString() const {
+        std::string text(1, whiteToMove ? 'W' : 'B');
+        appendPieces(text, 'W', white);
+        appendPieces(text, 'B', black);
+        return text;
+    }
+
+    /**
+     * @brief Generate all legal moves for the side to move.
+     *
+     * Captures are compulsory and must be played to the end; with
+     * Rules::MaximumCapture only the longest sequences are returned. Different
+     * routes capturing the same pieces count as one move.
+     *
+     * @param list The list that receives the moves.
+     */
+    void generateMoves(MoveList& list) const {
+        list.count = 0;
+
+        Mask own = whiteToMove ? white : black;
+        Mask opponent = whiteToMove ? black : white;
+        Mask empty = emptySquares();
+
+        int best = 0;
+        for (Mask pieces = own; pieces != 0; pieces &= pieces - 1) {
+            int square = lowestBit(pieces);
+            Move current = {};
+            current.from = static_cast<uint8_t>(square);
+            if ((kings >> square) & 1u) {
+                addKingCaptures(square, empty | (Mask(1) << square), opponent, current, list, best);
+            }
+            else {
+                addManCaptures(square, empty | (Mask(1) << square), opponent, current, list, best);
+            }
+        }
+
+        if (list.count > 0) {
+            return;
+        }
+
+        Mask promotionRow = geometry.promotion[whiteToMove ? 1 : 0];
+        int forward = whiteToMove ? 0 : 2;
+        for (Mask pieces = own; pieces != 0; pieces &= pieces - 1) {
+            int square = lowestBit(pieces);
+
+            if ((kings >> square) & 1u) {
+                for (int direction = 0; direction < 4; direction++) {
+                    const int8_t* ray = geometry.ray[square][direction];
+                    for (int k = 0; ray[k] >= 0 && ((empty >> ray[k]) & 1u); k++) {
+                        addQuiet(square, ray[k], false, list);
+                        if constexpr (!Rules::FlyingKings) {
+                            break;
+                        }
+                    }
+                }
+                continue;
+            }
+
+            for (int direction = forward; direction < forward + 2; direction++) {
+                int target = geometry.ray[square][direction][0];
+                if (target >= 0 && ((empty >> target) & 1u)) {
+                    addQuiet(square, target, (promotionRow >> target) & 1u, list);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Apply a move generated for this position.
+     */
+    void makeMove(const Move& move) {
+        Mask fromBit = Mask(1) << move.from;
+        Mask toBit = Mask(1) << move.to;
+        Mask& own = whiteToMove ? white : black;
+        Mask& opponent = whiteToMove ? black : white;
+
+        bool isKing = (kings & fromBit) != 0;
+        own = (own & ~fromBit) | toBit;
+        kings &= ~fromBit;
+        if (isKing || move.promotes) {
+            kings |= toBit;
+        }
+
+        opponent &= ~move.captured;
+        kings &= ~move.captured;
+        whiteToMove = !whiteToMove;
+    }
+
+    /**
+     * @brief Take back a move previously applied with makeMove.
+     */
+    void unmakeMove(const Move& move) {
+        whiteToMove = !whiteToMove;
+
+        Mask fromBit = Mask(1) << move.from;
+        Mask toBit = Mask(1) << move.to;
+        Mask& own = whiteToMove ? white : black;
+        Mask& opponent = whiteToMove ? black : white;
+
+        bool isKing = (kings & toBit) != 0 && !move.promotes;
+        own = (own & ~toBit) | fromBit;
+        kings &= ~toBit;
+        if (isKing) {
+            kings |= fromBit;
+        }
+
+        opponent |= move.captured;
+        kings |= move.capturedKings;
+    }
+
+    /**
+     * @brief Count the leaf positions of the move tree, the standard generator check.
+     *
+     * @param depth Number of plies to expand.
+     * @return The number of positions reached after exactly depth plies.
+     */
+    uint64_t perft(int depth) {
+        if (depth == 0) {
+            return 1;
+        }
+
+        MoveList list;
+        generateMoves(list);
+        if (depth == 1) {
+            return static_cast<uint64_t>(list.count);
+        }
+
+        uint64_t nodes = 0;
+        for (int i = 0; i < list.count; i++) {
+            makeMove(list[i]);
+            nodes += perft(depth - 1);
+            unmakeMove(list[i]);
+        }
+        return nodes;
+    }
+
+    /**
+     * @brief Get the empty playable squares.
+     */
+    Mask emptySquares() const {
+        return AllSquares & ~(white | black);
+    }
+
+private:
+    /**
+     * @brief Append a quiet move.
+     */
+    static void addQuiet(int from, int to, bool promotes, MoveList& list) {
+        Move move = {};
+        move.from = static_cast<uint8_t>(from);
+        move.to = static_cast<uint8_t>(to);
+        move.promotes = promotes;
+        list.add(move);
+    }
+
+    /**
+     * @brief Get the squares free to land on after a capture hop.
+     *
+     * The capturing piece leaves its square; the captured piece only frees its
+     * square at once with Rules::ImmediateRemoval, otherwise it keeps blocking
+     * until the end of the move.
+     */
+    static Mask afterHop(Mask empty, int square, int over, int landing) {
+        Mask freed = Mask(1) << square;
+        if constexpr (Rules::ImmediateRemoval) {
+            freed |= Mask(1) << over;
+        }
+        return (empty | freed) & ~(Mask(1) << landing);
+    }
+
+    /**
+     * @brief Record one hop in a copy of the move being built.
+     */
+    Move hop(const Move& current, int over, int landing) const {
+        Mask overBit = Mask(1) << over;
+        Move next = current;
+        next.captured |= overBit;
+        next.capturedKings |= kings & overBit;
+        next.path[next.hops++] = static_cast<uint8_t>(landing);
+        return next;
+    }
+
+    /**
+     * @brief Extend the capture sequence of a man.
+     *
+     * @param square The square the man stands on.
+     * @param empty Squares free to land on.
+     * @param targets Opponent pieces that may still be captured.
+     * @param current The partially built move.
+     * @param list The list that receives the moves.
+     * @param best The longest capture recorded so far.
+     */
+    void addManCaptures(int square, Mask empty, Mask targets, Move& current, MoveList& list, int& best) const {
+        bool extended = false;
+        int first = Rules::MenCaptureBackward || whiteToMove ? 0 : 2;
+        int last = Rules::MenCaptureBackward || !whiteToMove ? 4 : 2;
+        Mask promotionRow = geometry.promotion[whiteToMove ? 1 : 0];
+
+        for (int direction = first; direction < last; direction++) {
+            int over = geometry.ray[square][direction][0];
+            if (over < 0 || ((targets >> over) & 1u) == 0) {
+                continue;
+            }
+            int landing = geometry.ray[square][direction][1];
+            if (landing < 0 || ((empty >> landing) & 1u) == 0) {
+                continue;
+            }
+
+            extended = true;
+            Move next = hop(current, over, landing);
+            Mask nextEmpty = afterHop(empty, square, over, landing);
+            Mask nextTargets = targets & ~(Mask(1) << over);
+
+            bool crowned = (promotionRow >> landing) & 1u;
+            if constexpr (Rules::CrownDuringCapture) {
+                if (crowned) {
+                    next.promotes = true;
+                    addKingCaptures(landing, nextEmpty, nextTargets, next, list, best);
+                    continue;
+                }
+            }
+            if constexpr (Rules::CrowningEndsMove) {
+                if (crowned) {
+                    record(next, list, best);
+                    continue;
+                }
+            }
+            addManCaptures(landing, nextEmpty, nextTargets, next, list, best);
+        }
+
+        if (!extended) {
+            record(current, list, best);
+        }
+    }
+
+    /**
+     * @brief Extend the capture sequence of a king, one step or flying depending on the rules.
+     *
+     * Parameters as for addManCaptures().
+     */
+    void addKingCaptures(int square, Mask empty, Mask targets, Move& current, MoveList& list, int& best) const {
+        bool extended = false;
+
+        for (int direction = 0; direction < 4; direction++) {
+            const int8_t* ray = geometry.ray[square][direction];
+            int k = 0;
+            if constexpr (Rules::FlyingKings) {
+                while (ray[k] >= 0 && ((empty >> ray[k]) & 1u)) {
+                    k++;
+                }
+            }
+
+            int over = ray[k];
+            if (over < 0 || ((targets >> over) & 1u) == 0) {
+                continue;
+            }
+
+            // A flying king may stop on any free square behind the captured piece
+            for (int j = k + 1; ray[j] >= 0 && ((empty >> ray[j]) & 1u); j++) {
+                int landing = ray[j];
+                extended = true;
+                Move next = hop(current, over, landing);
+                addKingCaptures(landing, afterHop(empty, square, over, landing), targets & ~(Mask(1) << over), next, list, best);
+                if constexpr (!Rules::FlyingKings) {
+                    break;
+                }
+            }
+        }
+
+        if (!extended) {
+            record(current, list, best);
+        }
+    }
+
+    /**
+     * @brief Add a finished capture sequence to the list.
+     */
+    void record(Move& current, MoveList& list, int& best) const {
+        if (current.hops == 0) {
+            return;
+        }
+
+        if constexpr (Rules::MaximumCapture) {
+            if (current.hops < best) {
+                return;
+            }
+            if (current.hops > best) {
+                best = current.hops;
+                list.count = 0;
+            }
+        }
+
+        current.to = current.path[current.hops - 1];
+        if (!((kings >> current.from) & 1u)) {
+            current.promotes = current.promotes || ((geometry.promotion[whiteToMove ? 1 : 0] >> current.to) & 1u);
+        }
+
+        for (int i = 0; i < list.count; i++) {
+            if (list[i].from == current.from && list[i].to == current.to && list[i].captured == current.captured) {
+                return;
+            }
+        }
+        list.add(current);
+    }
+
+    /**
+     * @brief Append the pieces of one colour to a position string.
+     */
+    void appendPieces(std::string& text, char colour, Mask pieces) const {
+        text += ':';
+        text += colour;
+        bool first = true;
+        for (Mask rest = pieces; rest != 0; rest &= rest - 1) {
+            int square = lowestBit(rest);
+            if (!first) {
+                text += ',';
+            }
+            if ((kings >> square) & 1u) {
+                text += 'K';
+            }
+            text += std::to_string(square + 1);
+            first = false;
+        }
+    }
+};
+
+#endif
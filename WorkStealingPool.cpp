@@ -0,0 +1,83 @@
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <exception>
+#include <thread>
+
+/**
+ * @file WorkStealingPool.cpp
+ * @brief Implementation of the work-stealing thread pool.
+ */
+
+WorkStealingPool::WorkStealingPool(int threads) : queues(threads > 0 ? threads : 1) {}
+
+void WorkStealingPool::run(size_t count, const std::function<void(size_t task, int worker)>& task) {
+    // Worker w gets a contiguous block in reverse, so it works through it in order from the back
+    size_t workers = queues.size();
+    for (size_t w = 0; w < workers; w++) {
+        size_t first = count * w / workers;
+        size_t last = count * (w + 1) / workers;
+        for (size_t i = last; i > first; i--) {
+            queues[w].tasks.push_back(i - 1);
+        }
+    }
+
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto work = [&](int worker) {
+        size_t current;
+        while (!failed.load() && next(worker, current)) {
+            try {
+                task(current, worker);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed.store(true);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < workers; w++) {
+        threads.emplace_back(work, static_cast<int>(w));
+    }
+    work(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (Queue& queue : queues) {
+        queue.tasks.clear();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool WorkStealingPool::next(int worker, size_t& task) {
+    {
+        Queue& own = queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Tasks are never added during a run, so finding every queue empty once means the batch is done
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+        Queue& victim = queues[(worker + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,62 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief The WorkStealingPool class runs a batch of independent tasks on a fixed number of threads.
+ *
+ * The tasks are numbered 0 to count-1 and dealt to the workers in contiguous
+ * blocks. A worker takes its own tasks from the back of its queue; when the
+ * queue is empty it steals from the front of another worker's queue, where
+ * the tasks furthest from that worker's current one are. Tasks of very
+ * different length, such as games of different length, therefore keep every
+ * thread busy until the batch is done.
+ */
+class WorkStealingPool {
+public:
+    /**
+     * @brief Constructor for the WorkStealingPool class.
+     *
+     * @param threads Number of workers, at least one.
+     */
+    explicit WorkStealingPool(int threads);
+
+    /**
+     * @brief Get the number of workers.
+     */
+    int size() const { return static_cast<int>(queues.size()); }
+
+    /**
+     * @brief Run tasks 0 to count-1 and return when all have finished.
+     *
+     * @param count Number of tasks.
+     * @param task Called once per task with the task number and the number of the worker running it.
+     * An exception thrown by a task is rethrown here after the other workers have stopped.
+     */
+    void run(size_t count, const std::function<void(size_t task, int worker)>& task);
+
+private:
+    /**
+     * @brief The Queue struct holds the tasks dealt to one worker.
+     */
+    struct Queue {
+        std::mutex mutex;           ///< Guards tasks.
+        std::deque<size_t> tasks;   ///< Task numbers; the owner pops the back, thieves the front.
+    };
+
+    std::vector<Queue> queues;      ///< One queue per worker.
+
+    /**
+     * @brief Get the next task of a worker, stolen if its own queue is empty.
+     *
+     * @return False when every queue is empty.
+     */
+    bool next(int worker, size_t& task);
+};
+
+#endif
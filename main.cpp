@@ -7,25 +7,449 @@
 #include <string>
 #include "HumanPlayer.h"
 #include "ComputerPlayer.h"
+#include "EvalBenchmark.h"
+#include "MicroBenchmark.h"
+#include "TestSuite.h"
+#include "GameAnnotator.h"
+#include "BatchEvaluator.h"
+#include "GameHost.h"
+#include "PositionDatabase.h"
+#include "DfpnSolver.h"
+#include "EngineProtocol.h"
+#include "DxpEventLoop.h"
+#include "VariantPosition.h"
+#include "GameClock.h"
+#include "Telemetry.h"
+#include "Trace.h"
+#include "MemoryAccounting.h"
+#include "Nnue.h"
 #include <chrono>
+#include <fstream>
+#include <memory>
+#include <vector>
 
-template <typename Duration>
-Duration addDurations(const Duration& duration1, const Duration& duration2) {
-    return duration1 + duration2;
+/**
+ * @brief Read a whole number argument of a command line mode.
+ *
+ * @param text The argument.
+ * @param name What the number is, for the error message.
+ * @throw std::runtime_error if the argument is not a whole number.
+ */
+int parseNumber(const char* text, const std::string& name) {
+    size_t used = 0;
+    int value = 0;
+    try {
+        value = std::stoi(text, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || text[used] != '\0') {
+        throw std::runtime_error("The " + name + " must be a whole number, not \"" + text + "\".");
+    }
+    return value;
+}
+
+/**
+ * @brief Solve a position given on the command line with the proof-number solver.
+ *
+ * Arguments: position [table megabytes, default 64] [node budget, default 10000000].
+ */
+int solvePosition(int argc, char* argv[]) {
+    try {
+        if (argc < 3) {
+            throw std::runtime_error("Usage: checkers --solve <position> [megabytes] [nodes]");
+        }
+
+        Position position = Position::fromString(argv[2]);
+        int megabytes = argc > 3 ? parseNumber(argv[3], "memory budget") : 64;
+        int nodes = argc > 4 ? parseNumber(argv[4], "node budget") : 10000000;
+        if (megabytes < 1 || megabytes > 65536) {
+            throw std::runtime_error("The memory budget must be between 1 and 65536 megabytes.");
+        }
+        if (nodes < 1) {
+            throw std::runtime_error("The node budget must be positive.");
+        }
+
+        DfpnSolver solver(static_cast<size_t>(megabytes) * 1024 * 1024);
+        DfpnSolver::Result result = solver.solve(position, nodes);
+
+        std::cout << "Result: " << DfpnSolver::outcomeName(result.outcome) << std::endl;
+        if (!result.line.empty()) {
+            std::cout << "Line:";
+            for (const BoardMove& move : result.line) {
+                std::cout << " " << Position::moveToString(move);
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "Nodes: " << result.nodes << ", garbage collections: " << result.collections
+            << ", time: " << result.seconds << " s" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Print the best lines of a position given on the command line, deepening until the budget is spent.
+ *
+ * Arguments: position or "startpos" [lines, default 3] [depth, default 14, or milliseconds written as "500ms"].
+ * With a hash file the search starts from the table saved there and saves its table back.
+ * With a network the positions are scored by the NNUE instead of the classic evaluation.
+ */
+int analysePosition(int argc, char* argv[], const std::string& hashFile, const NnueNetwork* network) {
+    try {
+        if (argc < 3) {
+            throw std::runtime_error("Usage: checkers --analyse <position> [lines] [depth|<n>ms]");
+        }
+
+        Position position = std::string(argv[2]) == "startpos" ? Position::initial() : Position::fromString(argv[2]);
+        SearchLimits limits;
+        limits.lines = argc > 3 ? parseNumber(argv[3], "number of lines") : 3;
+        limits.depth = 14;
+        std::string budget = argc > 4 ? argv[4] : "";
+        bool timed = budget.size() > 2 && budget.compare(budget.size() - 2, 2, "ms") == 0;
+        if (timed) {
+            limits.depth = Search::MaxPly;
+            limits.milliseconds = parseNumber(budget.substr(0, budget.size() - 2).c_str(), "time budget in milliseconds");
+        }
+        else if (!budget.empty()) {
+            limits.depth = parseNumber(budget.c_str(), "depth");
+        }
+        if (limits.lines < 1 || limits.depth < 1 || (timed && limits.milliseconds < 1)) {
+            throw std::runtime_error("The number of lines, the depth and the time budget must be positive.");
+        }
+
+        Search search(64);
+        search.setNetwork(network);
+        if (!hashFile.empty()) {
+            try {
+                size_t entries = search.loadTable(hashFile);
+                std::cout << "Loaded " << entries << " hash entries from " << hashFile << std::endl;
+            }
+            catch (const std::exception& e) {
+                std::cout << e.what() << " Starting with an empty hash table." << std::endl;
+            }
+        }
+        SearchResult result = search.think(position, limits, [](const SearchInfo& info) {
+            std::cout << "depth " << info.depth << " line " << info.line << " score " << info.score << " nodes " << info.nodes
+                << " time " << static_cast<long long>(info.seconds * 1000.0) << " pv";
+            for (const BoardMove& move : info.pv) {
+                std::cout << " " << Position::moveToString(move);
+            }
+            std::cout << std::endl;
+        });
+
+        if (!result.hasMove) {
+            std::cout << "The side to move has no legal move." << std::endl;
+            return 0;
+        }
+        std::cout << "Best lines at depth " << result.depth << " (" << result.nodes << " nodes, " << result.seconds << " s):" << std::endl;
+        for (size_t i = 0; i < result.lines.size(); i++) {
+            std::cout << i + 1 << ". " << Position::moveToString(result.lines[i].pv[0]) << " score " << result.lines[i].score << std::endl;
+        }
+        if (!hashFile.empty()) {
+            search.saveTable(hashFile);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Add game collections to a position database, creating it if needed.
+ *
+ * Arguments: database name, then one or more collection files.
+ */
+int addToDatabase(int argc, char* argv[]) {
+    try {
+        if (argc < 4) {
+            throw std::runtime_error("Usage: checkers --db-add <database> <games>...");
+        }
+        PositionDatabase::add(argv[2], std::vector<std::string>(argv + 3, argv + argc), std::cout);
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Print the games of a position database in which a position occurred.
+ *
+ * Arguments: database name, position or "startpos".
+ */
+int findInDatabase(int argc, char* argv[]) {
+    try {
+        if (argc < 4) {
+            throw std::runtime_error("Usage: checkers --db-find <database> <position>");
+        }
+        PositionDatabase database(argv[2]);
+        database.report(std::string(argv[3]) == "startpos" ? Position::initial() : Position::fromString(argv[3]), std::cout);
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Play DXP games over TCP as a server or as a client.
+ *
+ * Server arguments: [port, default 27531] [milliseconds per move, default 1000] [games, default 0 = forever].
+ * Client arguments: host [port, default 27531] [games, default 1] [milliseconds per move, default 1000].
+ * A client with 0 milliseconds plays random legal moves, a stand-in peer for testing a server.
+ */
+int playDxp(int argc, char* argv[]) {
+    try {
+        bool server = std::string(argv[1]) == "--dxp-server";
+        if (!server && argc < 3) {
+            throw std::runtime_error("Usage: checkers --dxp-client <host> [port] [games] [milliseconds]");
+        }
+
+        DxpSettings settings;
+        int port = 27531;
+        int games = 0;
+        if (server) {
+            port = argc > 2 ? parseNumber(argv[2], "port") : port;
+            settings.milliseconds = argc > 3 ? parseNumber(argv[3], "time per move") : settings.milliseconds;
+            games = argc > 4 ? parseNumber(argv[4], "number of games") : 0;
+        }
+        else {
+            port = argc > 3 ? parseNumber(argv[3], "port") : port;
+            games = argc > 4 ? parseNumber(argv[4], "number of games") : 1;
+            settings.milliseconds = argc > 5 ? parseNumber(argv[5], "time per move") : settings.milliseconds;
+        }
+        if (port < 1 || port > 65535) {
+            throw std::runtime_error("The port must be between 1 and 65535.");
+        }
+        if (settings.milliseconds < 0 || games < 0) {
+            throw std::runtime_error("The time per move and the number of games must not be negative.");
+        }
+        if (settings.milliseconds == 0) {
+            settings.name = "Random";
+        }
+
+        DxpEventLoop loop(settings);
+        if (server) {
+            std::cout << "Listening for DXP games on port " << loop.listen(port) << std::endl;
+        }
+        else {
+            loop.connect(argv[2], port, games);
+        }
+
+        loop.run(games);
+        loop.printStatistics(std::cout);
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Print the perft counts of one variant for every depth up to a limit.
+ */
+template <typename Rules>
+void runPerft(const std::string& text, int depth) {
+    VariantPosition<Rules> position = text.empty() ? VariantPosition<Rules>::initial() : VariantPosition<Rules>::fromString(text);
+    std::cout << Rules::Name << " " << position.toString() << std::endl;
+
+    for (int i = 1; i <= depth; i++) {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = position.perft(i);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "perft " << i << ": " << nodes << " (" << seconds << " s)" << std::endl;
+    }
+}
+
+/**
+ * @brief Count the positions of the move tree of a rule variant.
+ *
+ * Arguments: variant (house, english, russian or international) depth [position, default the start].
+ */
+int perftVariant(int argc, char* argv[]) {
+    try {
+        if (argc < 4) {
+            throw std::runtime_error("Usage: checkers --perft <house|english|russian|international> <depth> [position]");
+        }
+
+        std::string variant = argv[2];
+        int depth = parseNumber(argv[3], "depth");
+        if (depth < 1) {
+            throw std::runtime_error("The depth must be at least 1.");
+        }
+        std::string text = argc > 4 ? argv[4] : "";
+
+        if (variant == HouseRules::Name) {
+            runPerft<HouseRules>(text, depth);
+        }
+        else if (variant == EnglishRules::Name) {
+            runPerft<EnglishRules>(text, depth);
+        }
+        else if (variant == RussianRules::Name) {
+            runPerft<RussianRules>(text, depth);
+        }
+        else if (variant == InternationalRules::Name) {
+            runPerft<InternationalRules>(text, depth);
+        }
+        else {
+            throw std::runtime_error("Unknown variant: " + variant);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read the time control of the interactive game.
+ *
+ * Arguments after --clock: base seconds [increment seconds, default 0] [delay seconds, default 0].
+ */
+TimeControl parseTimeControl(int argc, char* argv[]) {
+    if (argc < 3) {
+        throw std::runtime_error("Usage: checkers --clock <seconds> [increment] [delay]");
+    }
+
+    TimeControl control;
+    control.base = static_cast<long long>(std::stod(argv[2]) * 1000.0);
+    control.increment = argc > 3 ? static_cast<long long>(std::stod(argv[3]) * 1000.0) : 0;
+    control.delay = argc > 4 ? static_cast<long long>(std::stod(argv[4]) * 1000.0) : 0;
+    if (control.base <= 0 || control.increment < 0 || control.delay < 0) {
+        throw std::runtime_error("The base time must be positive and the increment and delay not negative.");
+    }
+    return control;
 }
 
-int main() {
-   
+/**
+ * @brief Run the mode selected on the command line, or the interactive game.
+ *
+ * @param hashFile Hash table file of the computer players and the analysis, empty for none.
+ * @param network NNUE network of the computer players, the analysis and the engine protocol, null for the classic evaluation.
+ */
+int run(int argc, char* argv[], const std::string& hashFile, const NnueNetwork* network) {
+    // Command line modes that run without the interactive game
+    if (argc > 1 && std::string(argv[1]) == "--bench-eval") {
+        return EvalBenchmark::run(argc > 2 ? argv[2] : "");
+    }
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        return MicroBenchmark::run(argc > 2 ? argv[2] : "", argc > 3 ? argv[3] : "");
+    }
+    if (argc > 1 && std::string(argv[1]) == "--suite") {
+        if (argc < 3) {
+            std::cout << "Usage: checkers --suite <file> [nodes|<n>ms] [results.json] [baseline.json]" << std::endl;
+            return 1;
+        }
+        return TestSuite::runFile(argv[2], argc > 3 ? argv[3] : "1000000", argc > 4 ? argv[4] : "", argc > 5 ? argv[5] : "");
+    }
+    if (argc > 1 && std::string(argv[1]) == "--annotate") {
+        int threads = 0;
+        try {
+            if (argc < 3) {
+                throw std::runtime_error("Usage: checkers --annotate <games> [output|-] [threads] [nodes|<n>ms]");
+            }
+            threads = argc > 4 ? parseNumber(argv[4], "thread count") : 0;
+        }
+        catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        return GameAnnotator::runFile(argv[2], argc > 3 ? argv[3] : "-", threads, argc > 5 ? argv[5] : "100000");
+    }
+    if (argc > 1 && std::string(argv[1]) == "--batch-eval") {
+        int threads, depth;
+        try {
+            if (argc < 3) {
+                throw std::runtime_error("Usage: checkers --batch-eval <positions> [output|-] [threads] [depth]");
+            }
+            threads = argc > 4 ? parseNumber(argv[4], "thread count") : 0;
+            depth = argc > 5 ? parseNumber(argv[5], "depth") : 4;
+        }
+        catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        return BatchEvaluator::runFile(argv[2], argc > 3 ? argv[3] : "-", threads, depth);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--host") {
+        int games, threads, engineThreads, milliseconds;
+        try {
+            if (argc < 3) {
+                throw std::runtime_error("Usage: checkers --host <games> [threads] [engine threads] [ms per move] [human]");
+            }
+            games = parseNumber(argv[2], "number of games");
+            threads = argc > 3 ? parseNumber(argv[3], "thread count") : 1;
+            engineThreads = argc > 4 ? parseNumber(argv[4], "engine thread count") : 0;
+            milliseconds = argc > 5 ? parseNumber(argv[5], "time per move") : 100;
+        }
+        catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+        return GameHost::run(games, threads, engineThreads, milliseconds, argc > 6 && std::string(argv[6]) == "human");
+    }
+    if (argc > 1 && std::string(argv[1]) == "--db-add") {
+        return addToDatabase(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--db-find") {
+        return findInDatabase(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--solve") {
+        return solvePosition(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--analyse") {
+        return analysePosition(argc, argv, hashFile, network);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--protocol") {
+        EngineProtocol protocol(std::cin, std::cout);
+        protocol.setNetwork(network);
+        return protocol.run();
+    }
+    if (argc > 1 && (std::string(argv[1]) == "--dxp-server" || std::string(argv[1]) == "--dxp-client")) {
+        return playDxp(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--perft") {
+        return perftVariant(argc, argv);
+    }
+
+    TimeControl control;
+    if (argc > 1 && std::string(argv[1]) == "--clock") {
+        try {
+            control = parseTimeControl(argc, argv);
+        }
+        catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     GameState* currentState = new StartState();
     currentState->displayState();
     bool isWhitePlayerTurn = true;
 
-    std::chrono::seconds firstPlayer(0);
-    std::chrono::seconds secondPlayer(0);
+    GameClock clock(control);
+    std::string outcome = "unfinished";
 
     // Choose player types
     Player* player1 = Player::chooseAndSetNameAndDisplay(1, true);
     Player* player2 = Player::chooseAndSetNameAndDisplay(2, false);
+    // Only one player keeps the file; two saving it at exit would overwrite each other
+    if (!hashFile.empty() && !player1->setHashFile(hashFile)) {
+        player2->setHashFile(hashFile);
+    }
+    player1->setNetwork(network);
+    player2->setNetwork(network);
 
     Board board;
 
@@ -35,7 +459,8 @@ int main() {
     Player* currentPlayer = player1; // Start with player 1
 
     try {
-        while (!board.CheckGameOver()) {
+        while (!board.CheckGameOver(isWhitePlayerTurn)) {
+            TRACE_SCOPE("turn");
             if (currentPlayer->IsHumanPlayer()) {
                 std::cout << currentPlayer->getName() << "'s turn" << std::endl;
             }
@@ -43,40 +468,65 @@ int main() {
                 std::cout << "Computer's turn" << std::endl;
             }
 
-            try {
-                auto startTime = std::chrono::high_resolution_clock::now();
-                    currentPlayer->makeMove(board, isWhitePlayerTurn);
-                auto endTime = std::chrono::high_resolution_clock::now();
-                auto moveTime = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+            // The clock keeps running while a human retries an invalid move
+            clock.start(isWhitePlayerTurn);
+            if (clock.isTimed()) {
+                std::cout << clock.toString() << std::endl;
+            }
+            currentPlayer->setMoveBudget(clock.moveBudget());
 
-                if (currentPlayer == player1) {
-                    firstPlayer = addDurations(firstPlayer, moveTime);
-                }
-                else {
-                    secondPlayer = addDurations(secondPlayer, moveTime);
-                }
+            try {
+                currentPlayer->makeMove(board, isWhitePlayerTurn);
             }
             catch (const std::exception& e) {
                 board.clearConsole(player1->getName(), player2->getName());
                 std::cout << board << std::endl; // Display the board after the move
                 std::cout << "Invalid move: " << e.what() << std::endl;
-                continue; // Continue to the next iteration of the loop
+                if (!clock.hasFlagged(isWhitePlayerTurn)) {
+                    continue; // Continue to the next iteration of the loop
+                }
+            }
+
+            long long moveTime = clock.stop();
+            if (clock.hasFlagged(isWhitePlayerTurn)) {
+                std::cout << (isWhitePlayerTurn ? "White" : "Black") << " ran out of time, "
+                    << (isWhitePlayerTurn ? "black" : "white") << " wins." << std::endl;
+                outcome = isWhitePlayerTurn ? "black wins on time" : "white wins on time";
+                board.setState(new GameOverState());
+                board.displayState();
+                break;
             }
 
-            board.clearConsole(player1->getName(), player2->getName());
-            std::cout << board << std::endl; // Display the board after the move    
-            std::cout << "Duration of player 1's moves: " << firstPlayer.count() << " s" << std::endl;
-            std::cout << "Duration of player 2's moves: " << secondPlayer.count() << " s" << std::endl;
+            {
+                TRACE_SCOPE("render");
+                board.clearConsole(player1->getName(), player2->getName());
+                std::cout << board << std::endl; // Display the board after the move
+            }
+            std::cout << "Move time: " << GameClock::formatTime(moveTime) << std::endl;
+            std::cout << clock.toString() << std::endl;
 
             // Switch the turn to the next player
             isWhitePlayerTurn = !isWhitePlayerTurn;
             currentPlayer = (currentPlayer == player1) ? player2 : player1; // Switch players
         }
+
+        if (outcome == "unfinished") {
+            // The side to move lost unless the game was drawn
+            outcome = !board.isGameOver(isWhitePlayerTurn) ? "draw" : (isWhitePlayerTurn ? "black wins" : "white wins");
+        }
+        std::cout << "Moves: " << board.getRecord().toString() << std::endl;
     }
     catch (const std::exception& e) {
         std::cout << "An unexpected error occurred: " << e.what() << std::endl;
     }
 
+    for (Player* player : { player1, player2 }) {
+        if (player->getStatistics() != nullptr) {
+            std::string label = std::string("game, ") + (player->IsWhiteSide() ? "white" : "black") + " (" + player->getName() + ")";
+            Telemetry::process().addGame(label, outcome, *player->getStatistics());
+        }
+    }
+
     // Free memory
     delete player1;
     delete player2;
@@ -86,10 +536,90 @@ int main() {
     return 0;
 }
 
+int main(int argc, char* argv[]) {
+    // "--stats <file> [seconds]", "--trace <file> [events]", "--hash-file <file>", "--memory <file>" and
+    // "--nnue <weights>" may precede any mode
+    std::vector<char*> arguments(argv, argv + argc);
+    std::string tracePath;
+    std::string hashFile;
+    std::string memoryPath;
+    std::string networkPath;
+    try {
+        while (arguments.size() > 2 && (std::string(arguments[1]) == "--stats" || std::string(arguments[1]) == "--trace" ||
+            std::string(arguments[1]) == "--hash-file" || std::string(arguments[1]) == "--memory" ||
+            std::string(arguments[1]) == "--nnue")) {
+            std::string option = arguments[1];
+            bool number = (option == "--stats" || option == "--trace") && arguments.size() > 3 && arguments[3][0] >= '0' &&
+                arguments[3][0] <= '9';
+            if (option == "--hash-file") {
+                hashFile = arguments[2];
+            }
+            else if (option == "--memory") {
+                memoryPath = arguments[2];
+            }
+            else if (option == "--nnue") {
+                networkPath = arguments[2];
+            }
+            else if (option == "--stats") {
+                int seconds = number ? parseNumber(arguments[3], "telemetry interval") : 0;
+                if (number && seconds <= 0) {
+                    throw std::runtime_error("The telemetry interval must be a positive number of seconds.");
+                }
+                Telemetry::process().start(arguments[2], seconds);
+            }
+            else {
+                tracePath = arguments[2];
+                int events = number ? parseNumber(arguments[3], "number of trace events") : static_cast<int>(Trace::DefaultEvents);
+                if (events <= 0 || static_cast<size_t>(events) > Trace::MaxEvents) {
+                    throw std::runtime_error("The number of trace events must be between 1 and " + std::to_string(Trace::MaxEvents) + ".");
+                }
+#ifdef CHECKERS_TRACE
+                Trace::enable(events);
+#endif
+            }
+            arguments.erase(arguments.begin() + 1, arguments.begin() + (number ? 4 : 3));
+        }
+    }
+    catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    arguments.push_back(nullptr);
 
+#ifndef CHECKERS_TRACE
+    if (!tracePath.empty()) {
+        std::cout << "Tracing is not compiled in; build with CHECKERS_TRACE defined (the Debug configuration does)." << std::endl;
+    }
+#endif
 
+    std::unique_ptr<NnueNetwork> network;
+    if (!networkPath.empty()) {
+        try {
+            network.reset(new NnueNetwork());
+            network->load(networkPath);
+        }
+        catch (const std::exception& e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+    }
 
-
-
-
-
+    int code = run(static_cast<int>(arguments.size()) - 1, arguments.data(), hashFile, network.get());
+    Telemetry::process().finish();
+#ifdef CHECKERS_TRACE
+    if (!tracePath.empty() && !Trace::save(tracePath)) {
+        std::cout << "Cannot write the trace to " << tracePath << std::endl;
+    }
+#endif
+    if (memoryPath == "-") {
+        MemoryAccounting::report(std::cout);
+    }
+    else if (!memoryPath.empty()) {
+        std::ofstream memory(memoryPath);
+        MemoryAccounting::report(memory);
+        if (!memory) {
+            std::cout << "Cannot write the memory report to " << memoryPath << std::endl;
+        }
+    }
+    return code;
+}